@@ -55,15 +55,50 @@ typedef double f64;
 typedef void* (*JSON_ALLOC)(size_t numBytes);
 typedef void(*JSON_DEALLOC)(void* bytes);
 
+// NOTE: @Jon
+// Allocation functions sharing a context, which are told the size of every block they resize or free
+// reallocate keeps the contents of the block and leaves it as it was if it gives back NULL
+typedef struct JSONLIB_Allocator
+{
+	void *context;
+	void *(*allocate)(void *context, size_t numBytes, size_t alignment);
+	void *(*reallocate)(void *context, void *bytes, size_t oldNumBytes, size_t newNumBytes);
+	void (*deallocate)(void *context, void *bytes, size_t numBytes);
+} JSONLIB_Allocator;
+
+// NOTE: @Jon
+// Function pointer typedef for where a writer sends its output, gives back false to stop writing
+typedef bool (*JSON_WRITE)(void *context, const char *data, u32 length);
+
 // NOTE: @Jon
 // Constants used for tagging nodes to indicate what type they are representing
-extern const u8 JSON_STRING_TAG;
-extern const u8 JSON_INTEGER_TAG;
-extern const u8 JSON_DECIMAL_TAG;
-extern const u8 JSON_ARRAY_TAG;
-extern const u8 JSON_OBJECT_TAG;
-extern const u8 JSON_BOOLEAN_TAG;
-extern const u8 JSON_NULL_TAG;
+extern const u16 JSON_STRING_TAG;
+extern const u16 JSON_INTEGER_TAG;
+extern const u16 JSON_DECIMAL_TAG;
+extern const u16 JSON_ARRAY_TAG;
+extern const u16 JSON_OBJECT_TAG;
+extern const u16 JSON_BOOLEAN_TAG;
+extern const u16 JSON_NULL_TAG;
+
+// NOTE: @Jon
+// A number can have more than one of these, each one means the matching member holds the exact value
+// (an integer that fits in 32 bits has JSON_INTEGER_TAG, JSON_INTEGER64_TAG and JSON_UNSIGNED64_TAG if it isn't negative)
+extern const u16 JSON_INTEGER64_TAG;
+extern const u16 JSON_UNSIGNED64_TAG;
+extern const u16 JSON_DECIMAL64_TAG;
+
+// NOTE: @Jon
+// Flags for changing how JSONLIB_ParseJSONEx parses a string
+// JSON_PARSE_BORROW_STRINGS points names and string values into the input instead of copying them,
+// so the input has to outlive the tree and the spans are only valid with their lengths (no NUL terminator)
+extern const u32 JSON_PARSE_BORROW_STRINGS;
+// JSON_PARSE_STRUCTURAL_INDEX indexes every token with SIMD before parsing
+extern const u32 JSON_PARSE_STRUCTURAL_INDEX;
+
+// NOTE: @Jon
+// Flags for JSONLIB_MeasureJSON and JSONLIB_MakeJSONInto
+// JSON_MAKE_HUMAN_READABLE puts each value on its own line like JSONLIB_MakeJSON's humanReadable
+extern const u32 JSON_MAKE_HUMAN_READABLE;
 
 
 // NOTE: @Jon
@@ -75,78 +110,558 @@ typedef struct JSON
 
 	u32 valueCount; //= 0;
 
+	// How many values the values array has room for before it needs to grow
+	u32 valueCapacity; //= 0;
+
 	//The name for the node
 	const char* name; //= "";
 
 	// Tags for what the data actually contains
-	u8 tags; //= 0;
+	u16 tags; //= 0;
+
+	// Flags for how the memory backing this node is owned
+	u8 flags; //= 0;
+
+	// Length of the name, which may not be NUL terminated if it was borrowed from the input
+	u32 nameLength; //= 0;
 
 	// A representation of what type of number/string this node contains as a value (if it isn't an object or an array)
 	union
 	{
-		i32 integer;
-		f32 decimal;
-		const char *string;
+		// Numbers keep a 32 bit value for existing code next to the full width one
+		struct
+		{
+			i32 integer;
+			union
+			{
+				i64 integer64;
+				u64 unsigned64;
+			};
+		};
+		struct
+		{
+			f32 decimal;
+			f64 decimal64;
+		};
 		bool boolean;
 
+		// Strings keep their length alongside them, borrowed strings may not be NUL terminated
+		struct
+		{
+			const char *string;
+			u32 stringLength;
+		};
+
 		// Values stores a flat array of values, with valueCount keeping track of how many there are
-		struct JSON** values; //= NULL;
+		// Objects can also have an index of their member names for JSONLIB_GetValueJSON to search
+		struct
+		{
+			struct JSON** values; //= NULL;
+			struct JSON_MEMBER_INDEX* index; //= NULL;
+		};
 	};
 } JSON;
 
+// NOTE: @Jon
+// A member name made ready for repeated lookups with JSONLIB_GetValueByKeyJSON, its hash worked out once
+// The name isn't copied so it has to outlive the key
+typedef struct JSONLIB_Key
+{
+	const char *name;
+	u32 nameLength;
+	u32 hash;
+} JSONLIB_Key;
+
+// NOTE: @Jon
+// A document that has only had its structure checked and indexed, its values are parsed as they're read
+typedef struct JSONLIB_LazyDocument JSONLIB_LazyDocument;
+
+// NOTE: @Jon
+// A position in a lazy document, which can be copied freely and is only valid as long as its document
+typedef struct JSONLIB_LazyValue
+{
+	JSONLIB_LazyDocument *document;
+	u32 token;
+	u32 key;
+} JSONLIB_LazyValue;
+
+// NOTE: @Jon
+// A JSON Pointer compiled for evaluating again and again, every key hashed and every array index parsed up front
+typedef struct JSONLIB_Path JSONLIB_Path;
+
+// NOTE: @Jon
+// Region that every node, value array, name and string from a parse can be placed into
+typedef struct JSONLIB_Arena JSONLIB_Arena;
+
+// NOTE: @Jon
+// Slabs of nodes that freed nodes go back to, for trees that are built and freed one at a time
+typedef struct JSONLIB_NodePool JSONLIB_NodePool;
+
+// NOTE: @Jon
+// A read only document stored as one flat array of words, walked with a JSONLIB_Cursor
+typedef struct JSONLIB_Tape JSONLIB_Tape;
+
+// NOTE: @Jon
+// Position of a value on a tape, along with its key when it's an object member
+// Cursors are plain values that can be copied freely, they're only valid as long as their tape
+typedef struct JSONLIB_Cursor
+{
+	const JSONLIB_Tape *tape;
+	u32 position;
+	u32 key;
+} JSONLIB_Cursor;
+
+// NOTE: @Jon
+// Keeps one copy of every distinct member name it sees, for trees parsed with it to share
+typedef struct JSONLIB_NameTable JSONLIB_NameTable;
+
+// NOTE: @Jon
+// Streams JSON out through a fixed size buffer without building a tree
+typedef struct JSONLIB_Writer JSONLIB_Writer;
+
+// NOTE: @Jon
+// Callbacks for JSONLIB_ParseSAX, any of which can be NULL to skip that event
+// Each gives back false to stop the parse, the counts passed at the end of a container are its direct children
+// Strings and names are only valid during the call, they point into the input unless they had escapes to decode
+// Integers that fit in an i64 go to integer and bigger ones to unsignedInteger
+typedef struct JSONLIB_Handler
+{
+	bool (*startObject)(void *user);
+	bool (*endObject)(void *user, u32 memberCount);
+	bool (*startArray)(void *user);
+	bool (*endArray)(void *user, u32 elementCount);
+	bool (*key)(void *user, const char *name, u32 nameLength);
+	bool (*string)(void *user, const char *string, u32 stringLength);
+	bool (*integer)(void *user, i64 integer);
+	bool (*unsignedInteger)(void *user, u64 integer);
+	bool (*decimal)(void *user, f64 decimal);
+	bool (*boolean)(void *user, bool boolean);
+	bool (*null)(void *user);
+} JSONLIB_Handler;
+
+// NOTE: @Jon
+// Parses a document handed over a chunk at a time, producing SAX events or a tree
+typedef struct JSONLIB_PushParser JSONLIB_PushParser;
+
+// NOTE: @Jon
+// The records of a line delimited document, each parsed into a tree
+typedef struct JSONLIB_Batch JSONLIB_Batch;
+
+// NOTE: @Jon
+// Function pointer typedef for receiving the records of a line delimited document in order,
+// json is NULL when the record isn't valid JSON and is freed once this returns, gives back false to stop
+typedef bool (*JSON_RECORD)(void *context, JSON *json, const char *record, size_t recordLength);
 
 // NOTE: @Jon
 // Sets the internal allocation functions that the library will use to allocate/free memory
 void JSONLIB_SetAllocator(JSON_ALLOC alloc, JSON_DEALLOC dealloc);
 
+// NOTE: @Jon
+// Sets the allocator the library uses whenever it isn't given one to use, NULL goes back to malloc and free
+// Names and strings handed to the JSONLIB_Allocate*JSON functions are freed as strlen + 1 bytes
+// Only change it while nothing made with the old one (outside of objects that keep a copy) is still around
+void JSONLIB_SetAllocatorEx(const JSONLIB_Allocator *allocator);
+
+// NOTE: @Jon
+// Sets the allocator for the calling thread (NULL for the library's), which isn't copied so has to outlive everything made with it
+// Nodes, MakeJSON strings and working memory come from it, and arenas, node pools, writers, tapes, paths, lazy documents,
+// name tables, push parsers and batches made on the thread keep a copy of it. Everything is freed with the allocator it came from
+void JSONLIB_UseAllocator(const JSONLIB_Allocator *allocator);
+
 // NOTE: @Jon
 // Parses a JSON string
-JSON *JSONLIB_ParseJSON(const char *jsonString, u32 stringLength);
+// Numbers are rounded to the nearest double whatever the locale, and one too big for a double fails the parse
+JSON *JSONLIB_ParseJSON(const char *jsonString, size_t stringLength);
+
+// NOTE: @Jon
+// Parses a JSON string without building a tree, handing each token to the handler in document order
+// Gives back false if the string isn't valid JSON or a handler stopped the parse
+bool JSONLIB_ParseSAX(const char *jsonString, size_t stringLength, const JSONLIB_Handler *handler, void *user);
+
+// NOTE: @Jon
+// Creates a push parser that hands every token to the handler as its chunk is fed in
+JSONLIB_PushParser *JSONLIB_CreatePushParser(const JSONLIB_Handler *handler, void *user);
+
+// NOTE: @Jon
+// Creates a push parser that builds a tree, into the arena if one is given
+JSONLIB_PushParser *JSONLIB_CreatePushParserJSON(JSONLIB_Arena *arena);
+
+// NOTE: @Jon
+// Parses the next chunk of the document, chunks can split it anywhere (even mid-string, mid-number or mid-escape)
+// Only a token split across chunks is copied, so the chunk can be reused as soon as this returns
+// Gives back false once the document is malformed or a handler has stopped it
+bool JSONLIB_FeedPushParser(JSONLIB_PushParser *parser, const char *chunk, size_t chunkLength);
+
+// NOTE: @Jon
+// Ends the document, gives back false if it was malformed, incomplete or stopped by a handler
+bool JSONLIB_FinishPushParser(JSONLIB_PushParser *parser);
+
+// NOTE: @Jon
+// Ends the document and hands over the tree built by a JSONLIB_CreatePushParserJSON parser (NULL if it failed)
+JSON *JSONLIB_FinishPushParserJSON(JSONLIB_PushParser *parser);
+
+// NOTE: @Jon
+// Frees a push parser, along with any tree it built that wasn't taken
+void JSONLIB_DestroyPushParser(JSONLIB_PushParser *parser);
+
+// NOTE: @Jon
+// Parses newline delimited JSON (NDJSON / JSON Lines) on threadCount worker threads (0 uses one per processor)
+// Each non-blank line is a record, flags are the same as JSONLIB_ParseJSONEx apart from parsing in situ
+// Gives back NULL if it runs out of memory
+JSONLIB_Batch *JSONLIB_ParseNDJSON(const char *buffer, size_t bufferLength, u32 threadCount, u32 flags);
+
+// NOTE: @Jon
+// Gets how many records a batch has and the tree for each one in input order (NULL if it wasn't valid JSON)
+u32 JSONLIB_GetBatchCount(const JSONLIB_Batch *batch);
+JSON *JSONLIB_GetBatchJSON(const JSONLIB_Batch *batch, u32 index);
+
+// NOTE: @Jon
+// Frees a batch along with every tree in it
+void JSONLIB_DestroyBatch(JSONLIB_Batch *batch);
+
+// NOTE: @Jon
+// Parses newline delimited JSON on threadCount worker threads, handing each record to the callback in input order
+// Only a few chunks of records are held at once, gives back false if the callback stopped it or it ran out of memory
+bool JSONLIB_StreamNDJSON(const char *buffer, size_t bufferLength, u32 threadCount, u32 flags, JSON_RECORD record, void *context);
+
+// NOTE: @Jon
+// Streams the records of a newline delimited file the same way, reading it a block at a time
+bool JSONLIB_StreamNDJSONFile(const char *path, u32 threadCount, u32 flags, JSON_RECORD record, void *context);
+
+// NOTE: @Jon
+// Creates an arena for parsing documents into (a blockSize of 0 uses the default)
+// Blocks are allocated with the calling thread's allocator as it was when the arena was created
+JSONLIB_Arena *JSONLIB_CreateArena(size_t blockSize);
+
+// NOTE: @Jon
+// Creates an arena whose blocks come from the given allocator, which is copied into it
+// Anything parsed into the arena also takes its working memory (scratch and token buffers) from the allocator,
+// so each thread can parse with its own allocator
+JSONLIB_Arena *JSONLIB_CreateArenaWith(size_t blockSize, const JSONLIB_Allocator *allocator);
+
+// NOTE: @Jon
+// Releases every document parsed into the arena at once, keeping its blocks for reuse
+void JSONLIB_ResetArena(JSONLIB_Arena *arena);
+
+// NOTE: @Jon
+// Frees the arena, its blocks and every document parsed into it
+void JSONLIB_DestroyArena(JSONLIB_Arena *arena);
+
+// NOTE: @Jon
+// Creates and frees a pool of nodes, nodesPerSlab of them are allocated at a time (0 uses the default)
+// The pool's slabs are only given back when it's destroyed, which has to be after every tree using it is freed
+JSONLIB_NodePool *JSONLIB_CreateNodePool(u32 nodesPerSlab);
+void JSONLIB_DestroyNodePool(JSONLIB_NodePool *pool);
+
+// NOTE: @Jon
+// Creates a node pool whose slabs, and the names, strings and values of its nodes, come from the given allocator
+// The allocator is copied into the pool
+JSONLIB_NodePool *JSONLIB_CreateNodePoolWith(u32 nodesPerSlab, const JSONLIB_Allocator *allocator);
+
+// NOTE: @Jon
+// Sets the node pool for the calling thread (NULL for none), every node it parses or builds outside an arena comes from it
+// A pool is only used by one thread at a time, freeing its nodes counts as using it whatever pool the freeing thread has
+void JSONLIB_UseNodePool(JSONLIB_NodePool *pool);
+
+// NOTE: @Jon
+// Parses a JSON string into the given arena
+// The tree is owned by the arena so it should not be passed to JSONLIB_FreeJSON or JSONLIB_AddValueJSON
+JSON *JSONLIB_ParseJSONArena(JSONLIB_Arena *arena, const char *jsonString, size_t stringLength);
+
+// NOTE: @Jon
+// Parses a JSON string with the given JSON_PARSE_* flags, into the arena if one is given
+JSON *JSONLIB_ParseJSONEx(const char *jsonString, size_t stringLength, u32 flags, JSONLIB_Arena *arena);
+
+// NOTE: @Jon
+// Parses a writable JSON buffer in place, decoding escape sequences into the buffer itself
+// Names and strings become NUL terminated slices of the buffer, so it has to outlive the tree
+JSON *JSONLIB_ParseJSONInSitu(char *buffer, size_t bufferLength);
+
+// NOTE: @Jon
+// Parses a JSON file by mapping it into memory, so the file is never copied and can be bigger than 4GB
+// Takes the same flags as JSONLIB_ParseJSONEx, apart from JSON_PARSE_BORROW_STRINGS since the mapping doesn't outlive the parse
+JSON *JSONLIB_ParseFile(const char *path, u32 flags);
+
+// NOTE: @Jon
+// Parses a JSON string on threadCount threads (0 uses one per processor) by splitting a big root array or
+// object between them, otherwise the same as JSONLIB_ParseJSONEx apart from parsing in situ
+// The allocator has to be safe to call from several threads at once, gives back NULL if it runs out of memory
+JSON *JSONLIB_ParseJSONParallel(const char *jsonString, size_t stringLength, u32 threadCount, u32 flags, JSONLIB_Arena *arena);
+
+// NOTE: @Jon
+// Parses a JSON string into a tape, the only flag it takes is JSON_PARSE_STRUCTURAL_INDEX
+JSONLIB_Tape *JSONLIB_ParseTape(const char *jsonString, size_t stringLength, u32 flags);
+
+// NOTE: @Jon
+// Frees a tape
+void JSONLIB_DestroyTape(JSONLIB_Tape *tape);
+
+// NOTE: @Jon
+// Gets a cursor on the root value of a tape
+JSONLIB_Cursor JSONLIB_GetTapeRoot(const JSONLIB_Tape *tape);
+
+// NOTE: @Jon
+// Moves a cursor to the first value in an array or object, to the next value in the same container,
+// or to the value of an object's first member with the name. Each gives back false (leaving the cursor) if there isn't one
+bool JSONLIB_CursorChild(JSONLIB_Cursor *cursor);
+bool JSONLIB_CursorNextSibling(JSONLIB_Cursor *cursor);
+bool JSONLIB_CursorFindKey(JSONLIB_Cursor *cursor, const char *name, u32 nameLength);
+
+// NOTE: @Jon
+// Gets the JSON_*_TAG tags that a tree node would have for the value under a cursor
+u16 JSONLIB_CursorGetTags(const JSONLIB_Cursor *cursor);
+
+// NOTE: @Jon
+// Gets the name of an object member under a cursor, NULL for anything else
+const char *JSONLIB_CursorGetName(const JSONLIB_Cursor *cursor, u32 *nameLength);
+
+// NOTE: @Jon
+// Gets how many values an array or object under a cursor holds
+u32 JSONLIB_CursorGetCount(const JSONLIB_Cursor *cursor);
+
+// NOTE: @Jon
+// Gets the value under a cursor, giving back false if it isn't that type (any number can be read as a double)
+bool JSONLIB_CursorGetInteger64(const JSONLIB_Cursor *cursor, i64 *integer);
+bool JSONLIB_CursorGetUnsigned64(const JSONLIB_Cursor *cursor, u64 *integer);
+bool JSONLIB_CursorGetDecimal64(const JSONLIB_Cursor *cursor, f64 *decimal);
+bool JSONLIB_CursorGetBoolean(const JSONLIB_Cursor *cursor, bool *boolean);
+
+// NOTE: @Jon
+// Gets the string under a cursor (NUL terminated), NULL if it isn't a string
+const char *JSONLIB_CursorGetString(const JSONLIB_Cursor *cursor, u32 *stringLength);
+
+// NOTE: @Jon
+// Checks and indexes the structure of a JSON string without parsing its values, NULL if the structure isn't valid
+// The string has to outlive the document. A bad number or string is only found when it's read
+JSONLIB_LazyDocument *JSONLIB_ParseLazy(const char *jsonString, size_t stringLength);
+
+// NOTE: @Jon
+// Frees a lazy document, including any strings decoded out of it
+void JSONLIB_DestroyLazy(JSONLIB_LazyDocument *document);
+
+// NOTE: @Jon
+// Gets the root value of a lazy document
+JSONLIB_LazyValue JSONLIB_GetLazyRoot(JSONLIB_LazyDocument *document);
+
+// NOTE: @Jon
+// Moves a lazy value like a tape cursor, giving back false (leaving the value) if there's nowhere to go
+// JSONLIB_LazyEvalPath follows a whole compiled path, skipping every container it doesn't go into
+bool JSONLIB_LazyChild(JSONLIB_LazyValue *value);
+bool JSONLIB_LazyNextSibling(JSONLIB_LazyValue *value);
+bool JSONLIB_LazyFindKey(JSONLIB_LazyValue *value, const char *name, u32 nameLength);
+bool JSONLIB_LazyEvalPath(JSONLIB_LazyValue *value, const JSONLIB_Path *path);
+
+// NOTE: @Jon
+// Gets the JSON_*_TAG tags a tree node would have for a lazy value, 0 if the value isn't valid JSON
+u16 JSONLIB_LazyGetTags(const JSONLIB_LazyValue *value);
+
+// NOTE: @Jon
+// Gets how many values an array or object holds, which walks over all of them
+u32 JSONLIB_LazyGetCount(const JSONLIB_LazyValue *value);
+
+// NOTE: @Jon
+// Parses a lazy value, giving back false if it isn't that type or isn't valid (any number can be read as a double)
+bool JSONLIB_LazyGetInteger64(const JSONLIB_LazyValue *value, i64 *integer);
+bool JSONLIB_LazyGetUnsigned64(const JSONLIB_LazyValue *value, u64 *integer);
+bool JSONLIB_LazyGetDecimal64(const JSONLIB_LazyValue *value, f64 *decimal);
+bool JSONLIB_LazyGetBoolean(const JSONLIB_LazyValue *value, bool *boolean);
+
+// NOTE: @Jon
+// Gets the string value or member name of a lazy value, NULL if it doesn't have one
+// Strings without escapes point into the input and may not be NUL terminated, decoded ones are kept by the
+// document until it's destroyed, so reading these from several threads at once isn't safe
+const char *JSONLIB_LazyGetString(const JSONLIB_LazyValue *value, u32 *stringLength);
+const char *JSONLIB_LazyGetName(const JSONLIB_LazyValue *value, u32 *nameLength);
+
+// NOTE: @Jon
+// Parses all of a lazy value into a tree, into the arena if one is given
+JSON *JSONLIB_LazyToJSON(const JSONLIB_LazyValue *value, JSONLIB_Arena *arena);
+
+// NOTE: @Jon
+// Parses just the values that the compiled paths lead to, along with the objects and arrays on the way to them
+// Everything else is skipped without being parsed (or checked past its structure). Paths that lead nowhere are
+// left out, and arrays only hold the elements that were wanted (in order, but not at their old positions)
+// The tree is an ordinary one to be freed with JSONLIB_FreeJSON
+JSON *JSONLIB_ParseJSONProjected(const char *jsonString, size_t stringLength, const JSONLIB_Path *const *paths, u32 pathCount);
+
+// NOTE: @Jon
+// Writes a tree to a file as a binary snapshot, a tape that can be mapped straight back in with JSONLIB_MapBinary
+// Snapshots are only meant to be read on machines with the same byte order
+bool JSONLIB_SaveBinary(const JSON *json, const char *path);
+
+// NOTE: @Jon
+// Maps a binary snapshot read only as a tape, without copying or parsing it. JSONLIB_DestroyTape unmaps it
+JSONLIB_Tape *JSONLIB_MapBinary(const char *path);
+
+// NOTE: @Jon
+// Builds a tree with the same values as a tape, into the arena if one is given
+JSON *JSONLIB_TapeToJSON(const JSONLIB_Tape *tape, JSONLIB_Arena *arena);
+
+// NOTE: @Jon
+// Creates and frees a table of interned names, which has to outlive every tree parsed with it
+// A name table can be kept for one document or shared between many, but only by one thread at a time
+JSONLIB_NameTable *JSONLIB_CreateNameTable(void);
+void JSONLIB_DestroyNameTable(JSONLIB_NameTable *names);
+
+// NOTE: @Jon
+// Gets the table's copy of a name (NUL terminated), adding it if it isn't there yet
+// Looking up a member by its interned name only compares pointers
+const char *JSONLIB_InternName(JSONLIB_NameTable *names, const char *name, u32 nameLength);
+
+// NOTE: @Jon
+// Parses a JSON string like JSONLIB_ParseJSONEx, except every name points at the table's copy of it
+JSON *JSONLIB_ParseJSONInterned(const char *jsonString, size_t stringLength, u32 flags, JSONLIB_Arena *arena, JSONLIB_NameTable *names);
 
 // NOTE: @Jon
 // Constructs a JSON string from a given tree
 const char *JSONLIB_MakeJSON(const JSON *const json, const bool humanReadable);
 
+// NOTE: @Jon
+// Gets the exact length of the JSON string for a tree, not counting the NUL terminator
+size_t JSONLIB_MeasureJSON(const JSON *const json, const u32 flags);
+
+// NOTE: @Jon
+// Writes the JSON string for a tree into a caller owned buffer without allocating anything
+// Gives back the full length like snprintf, if it isn't less than capacity the output was cut short
+size_t JSONLIB_MakeJSONInto(const JSON *const json, char *buffer, const size_t capacity, const u32 flags);
+
+// NOTE: @Jon
+// Creates a writer that hands its output to write in chunks of up to bufferSize bytes (0 uses the default)
+// JSON_MAKE_HUMAN_READABLE lays the output out like JSONLIB_MakeJSON's humanReadable, top level values go on separate lines
+JSONLIB_Writer *JSONLIB_CreateWriter(JSON_WRITE write, void *context, u32 bufferSize, const u32 flags);
+
+// NOTE: @Jon
+// Creates a writer like JSONLIB_CreateWriter whose buffer comes from the given allocator, which is copied into it
+JSONLIB_Writer *JSONLIB_CreateWriterWith(JSON_WRITE write, void *context, u32 bufferSize, const u32 flags, const JSONLIB_Allocator *allocator);
+
+// NOTE: @Jon
+// Sends whatever the writer has buffered, gives back false if any write has failed
+bool JSONLIB_FlushWriter(JSONLIB_Writer *writer);
+
+// NOTE: @Jon
+// Flushes and frees a writer, gives back false if any write has failed
+bool JSONLIB_DestroyWriter(JSONLIB_Writer *writer);
+
+// NOTE: @Jon
+// Opens and closes containers, every Begin needs its matching End
+void JSONLIB_BeginObject(JSONLIB_Writer *writer);
+void JSONLIB_EndObject(JSONLIB_Writer *writer);
+void JSONLIB_BeginArray(JSONLIB_Writer *writer);
+void JSONLIB_EndArray(JSONLIB_Writer *writer);
+
+// NOTE: @Jon
+// Writes the name of the next object member, which has to be followed by its value
+void JSONLIB_WriteKey(JSONLIB_Writer *writer, const char *name, const u32 nameLength);
+
+// NOTE: @Jon
+// Writes a value into the current array, after a key or at the top level
+void JSONLIB_WriteInteger(JSONLIB_Writer *writer, const i64 integer);
+void JSONLIB_WriteUnsigned(JSONLIB_Writer *writer, const u64 integer);
+void JSONLIB_WriteDouble(JSONLIB_Writer *writer, const f64 decimal);
+void JSONLIB_WriteString(JSONLIB_Writer *writer, const char *string, const u32 stringLength);
+void JSONLIB_WriteBoolean(JSONLIB_Writer *writer, const bool boolean);
+void JSONLIB_WriteNull(JSONLIB_Writer *writer);
+
+// NOTE: @Jon
+// Writes a whole tree as the next value, inside an object the node's name is used as its key
+void JSONLIB_WriteJSON(JSONLIB_Writer *writer, const JSON *json);
+
 // NOTE: @Jon
 // Allocates a JSON node
-// Uses the allocation functions specified with JSONLIB_SetAllocator
+// Uses the calling thread's node pool or allocator, which the name and string have to come from as they're freed with the node
+// These give back NULL if the node can't be allocated or added to parent, the name and string stay the caller's then
 JSON* JSONLIB_AllocateJSON(const char* name, struct JSON* parent);
 
 // NOTE: @Jon
 // Allocates a JSON node
-// Uses the allocation functions specified with JSONLIB_SetAllocator
+// Uses the calling thread's node pool or allocator
 JSON* JSONLIB_AllocateIntegerJSON(const char* name, struct JSON* parent, const i32 integer);
 
 // NOTE: @Jon
 // Allocates a JSON node
-// Uses the allocation functions specified with JSONLIB_SetAllocator
+// Uses the calling thread's node pool or allocator
 JSON* JSONLIB_AllocateStringJSON(const char* name, struct JSON* parent, const char* string);
 
 
 // NOTE: @Jon
 // Allocates a JSON node
-// Uses the allocation functions specified with JSONLIB_SetAllocator
+// Uses the calling thread's node pool or allocator
 JSON* JSONLIB_AllocateBooleanJSON(const char* name, struct JSON* parent, const bool boolean);
 
 // NOTE: @Jon
 // Allocates a JSON node
-// Uses the allocation functions specified with JSONLIB_SetAllocator
+// Uses the calling thread's node pool or allocator
 JSON* JSONLIB_AllocateDecimalJSON(const char* name, struct JSON* parent, f32 decimal);
 
+// NOTE: @Jon
+// Allocates a JSON node holding a 64 bit integer
+// Uses the calling thread's node pool or allocator
+JSON* JSONLIB_AllocateInteger64JSON(const char* name, struct JSON* parent, const i64 integer);
+
+// NOTE: @Jon
+// Allocates a JSON node holding an unsigned 64 bit integer
+// Uses the calling thread's node pool or allocator
+JSON* JSONLIB_AllocateUnsigned64JSON(const char* name, struct JSON* parent, const u64 integer);
+
+// NOTE: @Jon
+// Allocates a JSON node holding a double
+// Uses the calling thread's node pool or allocator
+JSON* JSONLIB_AllocateDecimal64JSON(const char* name, struct JSON* parent, const f64 decimal);
+
 // NOTE: @Jon
 // Adds a node as a child of another node
-void JSONLIB_AddValueJSON(JSON *json, JSON *val);
+// Gives back false, leaving both nodes as they were, if the parent's values couldn't grow
+bool JSONLIB_AddValueJSON(JSON *json, JSON *val);
+
+// NOTE: @Jon
+// Makes sure a node has room for at least valueCount values without growing again
+// Gives back false, leaving the node as it was, if the values couldn't be allocated
+bool JSONLIB_ReserveValuesJSON(JSON *json, u32 valueCount);
 
 // NOTE: @Jon
 // Gets a value by name from a given node
+// Parsed objects with many members are given a hash index of their names which JSONLIB_AddValueJSON and
+// JSONLIB_FreeJSON keep up to date, call JSONLIB_IndexJSON again after changing the values array by hand
 JSON *JSONLIB_GetValueJSON(const char *name, u32 nameLength, JSON *json);
 
+// NOTE: @Jon
+// Makes a key for a name that's looked up again and again, and gets a value by it
+JSONLIB_Key JSONLIB_MakeKey(const char *name, u32 nameLength);
+JSON *JSONLIB_GetValueByKeyJSON(const JSONLIB_Key *key, JSON *json);
+
+// NOTE: @Jon
+// Builds the name index for an object of any size, arena trees need the arena they were parsed into
+// Gives back false if the node isn't an object or there's no memory for the index
+bool JSONLIB_IndexJSON(JSON *json, JSONLIB_Arena *arena);
+
+// NOTE: @Jon
+// Compiles a JSON Pointer such as "/orders/0/items/3/sku" (or "" for the whole document), NULL if it isn't valid
+JSONLIB_Path *JSONLIB_CompilePath(const char *pointer);
+
+// NOTE: @Jon
+// Frees a compiled path
+void JSONLIB_DestroyPath(JSONLIB_Path *path);
+
+// NOTE: @Jon
+// Gets the node a compiled path points to under root, NULL if there isn't one
+// A path can be evaluated on any number of trees, and from several threads at once
+JSON *JSONLIB_EvalPath(const JSONLIB_Path *path, JSON *root);
+
+// NOTE: @Jon
+// Gets the name of a node along with its length (the name may not be NUL terminated)
+const char *JSONLIB_GetNameJSON(const JSON *json, u32 *nameLength);
+
+// NOTE: @Jon
+// Gets the string value of a node along with its length (the string may not be NUL terminated)
+const char *JSONLIB_GetStringJSON(const JSON *json, u32 *stringLength);
+
 // NOTE: @Jon
 // Frees memory associated with a given node and all of its children
 void JSONLIB_FreeJSON(JSON *json);
 
 // NOTE: @Jon
 // Frees memory associated with a given string
+// The calling thread has to have the allocator it had when JSONLIB_MakeJSON made the string
 // N.B. This will set the str pointer to NULL
 void JSONLIB_ClearJSON(const char *str);
 
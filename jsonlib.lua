@@ -8,6 +8,7 @@ project "jsonlib"
   language "C"
   includedirs { "." }
   filter "system:Windows"
-    files { "include/jsonlib/*.h", "src/*.c" }
+    files { "include/jsonlib/*.h", "src/*.h", "src/*.c" }
   filter "system:Linux"
-    files { "include/jsonlib/*.h", "src/*.c" }
\ No newline at end of file
+    files { "include/jsonlib/*.h", "src/*.h", "src/*.c" }
+    links { "pthread" }
\ No newline at end of file
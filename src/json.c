@@ -1,10 +1,73 @@
 #include <include/jsonlib/json.h>
 
 #include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
 #include <string.h>
 #include <stdio.h>
 #include <assert.h>
 
+#include "json_tables.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define JSON_X64 1
+#include <immintrin.h>
+#else
+#define JSON_X64 0
+#endif
+
+// NOTE: @Jon
+// Vector kernels are compiled for their instruction set and only called once CPUID says they're supported
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define JSON_TARGET_AVX2
+#define JSON_TARGET_AVX512
+#define JSON_THREAD_LOCAL __declspec(thread)
+#else
+#define JSON_TARGET_AVX2 __attribute__((target("avx2")))
+#define JSON_TARGET_AVX512 __attribute__((target("avx512f,avx512bw")))
+#define JSON_THREAD_LOCAL _Thread_local
+#endif
+
+// NOTE: @Jon
+// Just enough threading for the line delimited parser's workers, and file mapping for parsing files and snapshots
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+typedef HANDLE JSON_THREAD;
+typedef SRWLOCK JSON_MUTEX;
+typedef CONDITION_VARIABLE JSON_CONDITION;
+#else
+#include <pthread.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+typedef pthread_t JSON_THREAD;
+typedef pthread_mutex_t JSON_MUTEX;
+typedef pthread_cond_t JSON_CONDITION;
+#endif
+
+// NOTE: @Jon
+// A whole file mapped read only into memory
+typedef struct JSON_FILE_MAPPING
+{
+	const char *data;
+	size_t length;
+#if defined(_WIN32)
+	HANDLE file;
+	HANDLE mapping;
+#endif
+} JSON_FILE_MAPPING;
+
+// NOTE: @Jon
+// What a thread runs, the task has to outlive the thread
+typedef struct JSON_THREAD_TASK
+{
+	void (*work)(void *context);
+	void *context;
+} JSON_THREAD_TASK;
+
 // TODO: @Jon
 // Big TODO list for this file:
 //  - Add convenience functions for checking if a JSON struct contains a value of given type
@@ -13,20 +76,68 @@
 //  - Way of enforcing precision of floating point string outputs
 //  - Make C standard library dependencies optional (allow for user-provided alternatives to these functions)
 
-#define JSON_DEFAULT_TOKENS 32
-#define JSON_DEFAULT_DIVIDER_STACK_SIZE 4
+#define JSON_DEFAULT_VALUE_STACK_SIZE 32
+#define JSON_DEFAULT_VALUE_CAPACITY 4
+#define JSON_MAX_PARSE_DEPTH 1024
+#define JSON_MAX_DECIMAL_DIGITS 768
+#define JSON_BIG_INTEGER_LIMBS 128
+#define JSON_MAX_DECIMAL_LENGTH 32
+#define JSON_DEFAULT_ARENA_BLOCK_SIZE 65536
+#define JSON_DEFAULT_NODE_SLAB_SIZE 1024
+#define JSON_DEFAULT_WRITER_BUFFER_SIZE 65536
+#define JSON_MAX_WRITER_DEPTH 1024
+#define JSON_MIN_LINES_CHUNK_SIZE (64 * 1024)
+#define JSON_MAX_LINES_CHUNK_SIZE (1024 * 1024)
+#define JSON_LINES_FILE_BLOCK_SIZE (16 * 1024 * 1024)
+#define JSON_MIN_PARALLEL_PARSE_SIZE (1024 * 1024)
+#define JSON_MIN_PARALLEL_SLICE_SIZE (256 * 1024)
+#define JSON_PARALLEL_SLICES_PER_THREAD 4
+#define JSON_MIN_INDEXED_MEMBER_COUNT 16
+#define JSON_MIN_MEMBER_INDEX_CAPACITY 32
+#define JSON_DEFAULT_NAME_TABLE_CAPACITY 64
+#define JSON_TAPE_COUNT_MASK 0xFFFFFFULL
+#define JSON_MIN_TAPE_WORDS 64
+#define JSON_MAX_TAPE_WORDS 0xFFFFFFFFu
+#define JSON_MIN_TAPE_STRINGS 256
+#define JSON_BINARY_VERSION 1
+#define JSON_BINARY_BYTE_ORDER 0x01020304u
+#define JSON_PATH_NO_INDEX 0xFFFFFFFFu
+#define JSON_ARENA_ALIGNMENT 8
+#define JSON_ALLOCATION_ALIGNMENT 16
 
 // NOTE: @Jon
 // Tags for JSON nodes
-const u8 JSON_STRING_TAG = 1 << 0;
-const u8 JSON_INTEGER_TAG = 1 << 1;
-const u8 JSON_DECIMAL_TAG = 1 << 2;
-const u8 JSON_ARRAY_TAG = 1 << 3;
-const u8 JSON_OBJECT_TAG = 1 << 4;
-const u8 JSON_BOOLEAN_TAG = 1 << 5;
-const u8 JSON_NULL_TAG = 1 << 6;
+const u16 JSON_STRING_TAG = 1 << 0;
+const u16 JSON_INTEGER_TAG = 1 << 1;
+const u16 JSON_DECIMAL_TAG = 1 << 2;
+const u16 JSON_ARRAY_TAG = 1 << 3;
+const u16 JSON_OBJECT_TAG = 1 << 4;
+const u16 JSON_BOOLEAN_TAG = 1 << 5;
+const u16 JSON_NULL_TAG = 1 << 6;
+const u16 JSON_INTEGER64_TAG = 1 << 7;
+const u16 JSON_UNSIGNED64_TAG = 1 << 8;
+const u16 JSON_DECIMAL64_TAG = 1 << 9;
+
+// NOTE: @Jon
+// Flags for parsing
+const u32 JSON_PARSE_BORROW_STRINGS = 1 << 0;
+const u32 JSON_PARSE_STRUCTURAL_INDEX = 1 << 1;
+
+const u32 JSON_MAKE_HUMAN_READABLE = 1 << 0;
+
+// NOTE: @Jon
+// Only set by JSONLIB_ParseJSONInSitu since it needs a writable input
+static const u32 JSON_PARSE_IN_SITU = 1u << 31;
+
+// NOTE: @Jon
+// Flags for how a node's memory is owned
+static const u8 JSON_ARENA_FLAG = 1 << 0;
+static const u8 JSON_BORROWED_NAME_FLAG = 1 << 1;
+static const u8 JSON_BORROWED_STRING_FLAG = 1 << 2;
+static const u8 JSON_POOLED_FLAG = 1 << 3;
+static const u8 JSON_ALLOCATED_FLAG = 1 << 4;
 
-static bool HasTags(const JSON* json, const u8 tags)
+static bool HasTags(const JSON* json, const u16 tags)
 {
 	return json->tags & tags;
 }
@@ -38,927 +149,7030 @@ static const char* const JSONfalseStr = "false";
 static const char* const JSONnullStr = "null";
 
 // NOTE: @Jon
-// A struct for handling a char * string
+// Output of the serializer, length keeps counting past capacity so the same walk can measure
 typedef struct JSON_STRING_STRUCT
 {
 	char *raw;
-	u32 length;
-	u32 capacity;
+	size_t length;
+	size_t capacity;
+	bool boundDecimals;
 } JSON_STRING_STRUCT;
 
 // NOTE: @Jon
-// JSON Divider Stack for tracking different dividers (e.g. {} or [])
-typedef struct JSON_DIVIDER_STACK
-{
-	char *dividerStack;
-	u32 dividerCount;
-	u32 dividerCapacity;
-} JSON_DIVIDER_STACK;
-
-// NOTE: @Jon
-// JSON Token Types
-enum JSON_TOKEN_TYPE
-{
-	LEFT_BRACE,
-	RIGHT_BRACE,
-	LEFT_SQUARE_BRACKET,
-	RIGHT_SQUARE_BRACKET,
-	COLON,
-	IDENTIFIER,
-	COMMA,
-	INTEGER,
-	FLOAT,
-	STRING,
-	JSON_TRUE,
-	JSON_FALSE,
-	JSON_NULL,
-	JSON_EOF,
-	JSON_ERROR,
-	JSON_TOKEN_TYPE_COUNT
+// Stack of parsed nodes waiting for their parent to be finished
+typedef struct JSON_VALUE_STACK
+{
+	JSON **values;
+	u32 valueCount;
+	u32 valueCapacity;
+} JSON_VALUE_STACK;
+
+typedef struct JSON_MEMBER_INDEX JSON_MEMBER_INDEX;
+
+// NOTE: @Jon
+// Hash table over an object's member names, open addressed with linear probing
+// Each slot holds a name's hash and the 1 based position of its member, 0 marks an empty slot
+typedef struct JSON_MEMBER_SLOT
+{
+	u32 hash;
+	u32 position;
+} JSON_MEMBER_SLOT;
+
+struct JSON_MEMBER_INDEX
+{
+	u32 capacity;
+	u32 count;
+	JSON_MEMBER_SLOT slots[];
 };
 
 // NOTE: @Jon
-// Struct to store token information for the JSON
-typedef struct JSON_TOKEN
+// One reference token of a compiled JSON Pointer, as a member key and (if it's a valid one) an array index
+typedef struct JSON_PATH_SEGMENT
 {
-	enum JSON_TOKEN_TYPE type; // = JSON_TOKEN_TYPE::JSON_ERROR;
-	char* identifier; // = NULL;
-} JSON_TOKEN;
+	JSONLIB_Key key;
+	u32 index;
+} JSON_PATH_SEGMENT;
 
-typedef struct JSON_TOKENS
+// NOTE: @Jon
+// A compiled JSON Pointer is one allocation, the decoded names are stored after the segments
+struct JSONLIB_Path
 {
-	JSON_TOKEN *tokens;
-	u32 tokenCount;
-	u32 tokenCapacity;
-} JSON_TOKENS;
+	JSONLIB_Allocator allocator;
+	size_t size;
+	u32 segmentCount;
+	JSON_PATH_SEGMENT segments[];
+};
+
+// NOTE: @Jon
+// Interned names, every distinct name is copied once into the table's arena
+// Entries are open addressed like the member index, an empty entry has no name
+typedef struct JSON_NAME_ENTRY
+{
+	const char *name;
+	u32 nameLength;
+	u32 hash;
+} JSON_NAME_ENTRY;
 
-static JSON_ALLOC JSON_Allocate = malloc;
-static JSON_DEALLOC JSON_Deallocate = free;
+struct JSONLIB_NameTable
+{
+	struct JSONLIB_Arena *arena;
+	JSON_NAME_ENTRY *entries;
+	u32 capacity;
+	u32 count;
+	JSONLIB_Allocator allocator;
+};
 
 // NOTE: @Jon
-// Parses an identifier
-static void ParseIdentifier(JSON_TOKEN *token, const char *ident, u32 valueLength)
+// Block of memory owned by an arena, the usable bytes follow the header
+typedef struct JSON_ARENA_BLOCK
 {
-	token->type = IDENTIFIER;
-	token->identifier = (char*)JSON_Allocate(sizeof(char) * ((size_t)valueLength + 1));
-	token->identifier[valueLength] = '\0';
-	memcpy((void*)token->identifier, ident, sizeof(char) * (valueLength));
-}
+	struct JSON_ARENA_BLOCK *next;
+	size_t used;
+	size_t capacity;
+} JSON_ARENA_BLOCK;
+
+struct JSONLIB_Arena
+{
+	JSON_ARENA_BLOCK *first;
+	JSON_ARENA_BLOCK *current;
+	size_t blockSize;
+	JSONLIB_Allocator allocator;
+};
 
 // NOTE: @Jon
-// Parses a value
-static void ParseValue(JSON_TOKEN *token, const char *value, u32 valueLength)
+// A pooled node along with the pool it came from, so it goes back there whichever pool is in use when it's freed
+typedef struct JSON_POOLED_NODE
 {
-	token->type = JSON_ERROR;
+	struct JSONLIB_NodePool *pool;
+	JSON node;
+} JSON_POOLED_NODE;
 
-	// If the value matches a string
-	if (value[0] == '"' && value[valueLength] == '"')
-	{
-		token->type = STRING;
-		token->identifier = (char*)JSON_Allocate(sizeof(char) * (valueLength));
-		token->identifier[valueLength - 1] = '\0';
-		memcpy(token->identifier, &value[1], sizeof(char) * (valueLength - 1));
-		return;
-	}
+// NOTE: @Jon
+// A node made with a thread's own allocator, which it keeps so it's freed with the same one on any thread
+typedef struct JSON_ALLOCATED_NODE
+{
+	const JSONLIB_Allocator *allocator;
+	JSON node;
+} JSON_ALLOCATED_NODE;
 
-	// If it starts with a number
-	if ((value[0] > 47 && value[0] < 58) || value[0] == '-')
-	{
-		token->identifier = (char*)JSON_Allocate(sizeof(char) * ((size_t)valueLength + 1));
-		token->identifier[valueLength] = '\0';
-		memcpy(token->identifier, value, sizeof(char) * (valueLength));
-		for (u32 i = 0; i < valueLength; ++i)
-		{
-			if (value[i] == '.')
-			{
-				token->type = FLOAT;
-				return;
-			}
-		}
-		token->type = INTEGER;
-		return;
-	}
+// NOTE: @Jon
+// Slab of nodes owned by a node pool, nodes are handed out from it in order until it's used up
+typedef struct JSON_NODE_SLAB
+{
+	struct JSON_NODE_SLAB *next;
+	u32 used;
+	u32 capacity;
+	JSON_POOLED_NODE nodes[];
+} JSON_NODE_SLAB;
 
-	// If it's a boolean value
-	if ((value[0] == 't' && (value[3] == 'e')) || (value[0] == 'f'&& (value[4] == 'e')))
-	{
-		if (value[0] == 't')
-			token->type = JSON_TRUE;
-		else
-			token->type = JSON_FALSE;
-		return;
-	}
-	// If it's just null
-	if (value[0] == 'n' && value[valueLength] == 'l')
-	{
-		token->type = JSON_NULL;
-	}
-}
+// NOTE: @Jon
+// Freed nodes are linked through their parent pointer, and are handed out again before the slab's unused ones
+struct JSONLIB_NodePool
+{
+	JSON_NODE_SLAB *slabs;
+	JSON *freeNodes;
+	u32 nodesPerSlab;
+	JSONLIB_Allocator allocator;
+};
 
 // NOTE: @Jon
-// Allocates a JSON node
-// Uses the allocation functions specified with JSONLIB_SetAllocator
-JSON* JSONLIB_AllocateJSON(const char* name, struct JSON* parent)
+// Streams JSON out through a fixed buffer, scopes holds an open bracket for every container being written
+struct JSONLIB_Writer
 {
-	JSON* node = JSON_Allocate(sizeof(JSON));
-	node->name = name;
-	node->parent = NULL;
-	node->values = NULL;
-	node->valueCount = 0;
-	node->tags = JSON_OBJECT_TAG;
-	
-	if (parent != NULL)
-	{
-		JSONLIB_AddValueJSON(parent, node);
-	}
-	
-	return node;
-}
+	JSONLIB_Allocator allocator;
+	JSON_STRING_STRUCT buffer;
+	JSON_WRITE write;
+	void *context;
+	u32 depth;
+	u32 valueCount;
+	bool humanReadable;
+	bool afterKey;
+	bool failed;
+	u32 scopeValueCounts[JSON_MAX_WRITER_DEPTH];
+	char scopes[JSON_MAX_WRITER_DEPTH];
+};
 
 // NOTE: @Jon
-// Allocates a JSON node
-// Uses the allocation functions specified with JSONLIB_SetAllocator
-JSON* JSONLIB_AllocateIntegerJSON(const char* name, struct JSON* parent, const i32 integer)
+// Positions of every token start in the input, built by the structural indexing stage
+typedef struct JSON_STRUCTURAL_INDEX
 {
-	JSON* node = JSONLIB_AllocateJSON(name, parent);
-	node->integer = integer;
-	node->tags = JSON_INTEGER_TAG;
-	return node;
-}
+	u32 *positions;
+	size_t positionCount;
+	size_t positionCapacity;
+	const JSONLIB_Allocator *allocator;
+} JSON_STRUCTURAL_INDEX;
 
 // NOTE: @Jon
-// Allocates a JSON node
-// Uses the allocation functions specified with JSONLIB_SetAllocator
-JSON* JSONLIB_AllocateDecimalJSON(const char* name, struct JSON* parent, const f32 decimal)
+// State for the single pass parser, which hands every token to a handler as it goes
+// When there is a structural index the parser hops between its positions rather than skipping whitespace
+// Strings with escapes are decoded into the scratch buffer unless parsing in situ
+typedef struct JSON_PARSER
 {
-	JSON* node = JSONLIB_AllocateJSON(name, parent);
-	node->decimal = decimal;
-	node->tags = JSON_DECIMAL_TAG;
-	return node;
-}
+	const char *input;
+	const char *cursor;
+	const char *end;
+	const u32 *index;
+	size_t indexPosition;
+	size_t indexCount;
+	const struct JSON_KERNELS *kernels;
+	const JSONLIB_Handler *handler;
+	void *user;
+	const JSONLIB_Allocator *allocator;
+	char *scratch;
+	size_t scratchCapacity;
+	u32 flags;
+	u32 depth;
+} JSON_PARSER;
 
 // NOTE: @Jon
-// Allocates a JSON node
-// Uses the allocation functions specified with JSONLIB_SetAllocator
-JSON* JSONLIB_AllocateStringJSON(const char* name, struct JSON* parent, const char* string)
+// Handler state for building a tree out of parse events, small documents keep their value stack inline
+// Nodes wait on the stack until their container ends, current is the container being filled
+// Nodes come from the pool and allocator the thread had when it was set up, allocator is where the rest goes outside an arena
+typedef struct JSON_DOM_BUILDER
 {
-	JSON* node = JSONLIB_AllocateJSON(name, parent);
-	node->string = string;
-	node->tags = JSON_STRING_TAG;
-	return node;
-}
+	const char *input;
+	const char *end;
+	JSONLIB_Arena *arena;
+	JSONLIB_NodePool *pool;
+	const JSONLIB_Allocator *nodeAllocator;
+	const JSONLIB_Allocator *allocator;
+	JSON_VALUE_STACK stack;
+	JSON *current;
+	const char *name;
+	u32 nameLength;
+	bool nameBorrowed;
+	u32 flags;
+	JSONLIB_NameTable *names;
+	JSON *inlineValues[JSON_DEFAULT_VALUE_STACK_SIZE];
+} JSON_DOM_BUILDER;
 
 // NOTE: @Jon
-// Allocates a JSON node
-// Uses the allocation functions specified with JSONLIB_SetAllocator
-JSON* JSONLIB_AllocateBooleanJSON(const char* name, struct JSON* parent, const bool boolean)
+// What a tape word holds, kept in its top byte
+typedef enum JSON_TAPE_TYPE
 {
-	JSON* node = JSONLIB_AllocateJSON(name, parent);
-	node->boolean = boolean;
-	node->tags = JSON_BOOLEAN_TAG;
-	return node;
-}
+	JSON_TAPE_ROOT,
+	JSON_TAPE_OBJECT,
+	JSON_TAPE_OBJECT_END,
+	JSON_TAPE_ARRAY,
+	JSON_TAPE_ARRAY_END,
+	JSON_TAPE_KEY,
+	JSON_TAPE_STRING,
+	JSON_TAPE_INTEGER,
+	JSON_TAPE_UNSIGNED,
+	JSON_TAPE_DECIMAL,
+	JSON_TAPE_TRUE,
+	JSON_TAPE_FALSE,
+	JSON_TAPE_NULL
+} JSON_TAPE_TYPE;
+
+struct JSONLIB_Tape
+{
+	u64 *words;
+	u32 wordCount;
+	u32 wordCapacity;
+	char *strings;
+	size_t stringsLength;
+	size_t stringsCapacity;
+
+	// A tape mapped from a binary snapshot points into the mapping instead of owning its buffers
+	JSON_FILE_MAPPING mapping;
+	bool mapped;
+	JSONLIB_Allocator allocator;
+};
 
 // NOTE: @Jon
-// Adds a value to the JSON node given
-void JSONLIB_AddValueJSON(JSON *json, JSON *val)
+// Start of a binary snapshot, which is followed by the tape's words and then its strings
+// The byte order mark is written natively so a snapshot from a machine of the other endianness is turned away
+typedef struct JSON_BINARY_HEADER
 {
-	json->valueCount++;
+	char magic[4];
+	u32 version;
+	u32 byteOrder;
+	u32 wordCount;
+	u64 stringsLength;
+} JSON_BINARY_HEADER;
 
-	if (val != NULL)
-		val->parent = json;
+// NOTE: @Jon
+// Handler state for writing parse events to a tape, scopes holds the opening word of every open container
+typedef struct JSON_TAPE_BUILDER
+{
+	JSONLIB_Tape *tape;
+	u32 depth;
+	u32 scopes[JSON_MAX_PARSE_DEPTH];
+} JSON_TAPE_BUILDER;
 
-	// Allocate the memory
-	JSON **newValueArray = (JSON**)JSON_Allocate(sizeof(JSON*) * json->valueCount);
-	assert(newValueArray != NULL);
+// NOTE: @Jon
+// A document that has only had its structure indexed, values are parsed when they're asked for
+// matches holds the token of the closing bracket for every token that opens a container
+struct JSONLIB_LazyDocument
+{
+	const char *input;
+	size_t inputLength;
+	u32 *positions;
+	size_t positionCapacity;
+	u32 *matches;
+	u32 tokenCount;
+	JSONLIB_Arena *arena;
+	JSONLIB_Allocator allocator;
+};
 
-	// Copy over the old array and free the memory
-	if (json->valueCount - 1 > 0)
-		memcpy(newValueArray, json->values, sizeof(JSON*) * (json->valueCount - 1));
-	if (json->values != NULL)
-		JSON_Deallocate((void*)json->values);
+// NOTE: @Jon
+// Handler state for parsing one scalar of a lazy document into a node on the stack
+// Keys being searched for are compared as they're decoded rather than kept
+typedef struct JSON_LAZY_SCALAR
+{
+	JSONLIB_LazyDocument *document;
+	JSON value;
+	const char *compareName;
+	u32 compareLength;
+	bool matched;
+} JSON_LAZY_SCALAR;
 
-	json->values = newValueArray;
+// NOTE: @Jon
+// One line of a line delimited batch, json is NULL when the line isn't valid JSON
+typedef struct JSON_LINES_RECORD
+{
+	JSON *json;
+	const char *text;
+	size_t length;
+} JSON_LINES_RECORD;
 
-	if (val != NULL)
-		json->values[json->valueCount - 1] = val;
-}
+// NOTE: @Jon
+// A run of whole lines parsed by one worker into its own arena, failed is set when it ran out of memory
+typedef struct JSON_LINES_CHUNK
+{
+	const char *start;
+	const char *end;
+	JSONLIB_Arena *arena;
+	JSON_LINES_RECORD *records;
+	u32 recordCount;
+	u32 recordCapacity;
+	bool done;
+	bool failed;
+} JSON_LINES_CHUNK;
 
-static void DividerStackPush(JSON_DIVIDER_STACK *const stack, const char toPush)
+// NOTE: @Jon
+// Work shared between the line parser's workers, nextChunk is the next to hand out and a window
+// (when streaming) keeps workers from getting too far ahead of the chunks delivered so far
+// The chunks, their records and arenas all come from the calling thread's allocator, copied for the workers
+typedef struct JSON_LINES_POOL
 {
-	if (stack->dividerCount + 1 >= stack->dividerCapacity)
-	{
-		char *expanded = (char*)JSON_Allocate(sizeof(char) * stack->dividerCapacity * 2);
+	JSONLIB_Allocator allocator;
+	JSON_LINES_CHUNK *chunks;
+	u32 chunkCount;
+	size_t chunkCapacity;
+	u32 nextChunk;
+	u32 deliveredCount;
+	u32 window;
+	JSONLIB_Arena **slotArenas;
+	u32 flags;
+	bool stop;
+	JSON_MUTEX mutex;
+	JSON_CONDITION workReady;
+	JSON_CONDITION chunkDone;
+} JSON_LINES_POOL;
 
-		assert(expanded != NULL);
+struct JSONLIB_Batch
+{
+	JSONLIB_Allocator allocator;
+	JSON_LINES_CHUNK *chunks;
+	u32 chunkCount;
+	size_t chunkCapacity;
+	JSON **roots;
+	u32 rootCount;
+};
 
-		memcpy(expanded, stack->dividerStack, sizeof(char) * stack->dividerCount);
-		stack->dividerCapacity *= 2;
-		JSON_Deallocate(stack->dividerStack);
-		stack->dividerStack = expanded;
-	}
-	stack->dividerStack[stack->dividerCount++] = toPush;
-}
+// NOTE: @Jon
+// A run of the root container's members, parsed by one worker into values waiting to go under the root
+typedef struct JSON_PARALLEL_SLICE
+{
+	const char *start;
+	const char *end;
+	JSONLIB_Arena *arena;
+	JSON **values;
+	u32 valueCount;
+	bool parsed;
+} JSON_PARALLEL_SLICE;
 
-static char DividerStackPop(JSON_DIVIDER_STACK *const stack)
+// NOTE: @Jon
+// Workers take on the allocator of the thread that started the parse, so every node can be freed the same way
+typedef struct JSON_PARALLEL_POOL
 {
-	return stack->dividerStack[--stack->dividerCount];
-}
+	JSON_PARALLEL_SLICE *slices;
+	u32 sliceCount;
+	u32 nextSlice;
+	JSON *root;
+	u32 flags;
+	const JSONLIB_Allocator *allocator;
+	JSON_MUTEX mutex;
+} JSON_PARALLEL_POOL;
 
 // NOTE: @Jon
-// Get the closing token to the current divider
-static u32 GetCloserOffset(JSON_TOKEN *token, u32 startToken, u32 tokenCount, JSON_DIVIDER_STACK *stack, enum JSON_TOKEN_TYPE opener, enum JSON_TOKEN_TYPE closer)
+// What a push parser expects to see next
+typedef enum JSON_PUSH_STATE
 {
-	for (u32 i = 0; i < tokenCount; ++i)
-	{
-		if (token[i].type == LEFT_BRACE || token[i].type == LEFT_SQUARE_BRACKET)
-			DividerStackPush(stack, 'S');
-		else if (token[i].type == RIGHT_BRACE || token[i].type == RIGHT_SQUARE_BRACKET)
-			DividerStackPop(stack);
+	JSON_PUSH_VALUE,
+	JSON_PUSH_FIRST_VALUE,
+	JSON_PUSH_KEY,
+	JSON_PUSH_FIRST_KEY,
+	JSON_PUSH_COLON,
+	JSON_PUSH_NEXT,
+	JSON_PUSH_DONE
+} JSON_PUSH_STATE;
+
+// NOTE: @Jon
+// Resumable parser fed a chunk at a time, scopes and scopeCounts track the open containers
+// A string, number or literal cut off by the end of a chunk waits in carry until the rest of it arrives
+// Its buffers come from a copy of the allocator the creating thread had, whichever thread feeds it
+struct JSONLIB_PushParser
+{
+	JSONLIB_Allocator allocator;
+	const struct JSON_KERNELS *kernels;
+	const JSONLIB_Handler *handler;
+	void *user;
+	JSON_DOM_BUILDER *builder;
+	char *scratch;
+	size_t scratchCapacity;
+	char *carry;
+	size_t carryLength;
+	size_t carryCapacity;
+	bool escapePending;
+	bool failed;
+	JSON_PUSH_STATE state;
+	u32 depth;
+	u32 scopeCounts[JSON_MAX_PARSE_DEPTH];
+	char scopes[JSON_MAX_PARSE_DEPTH];
+};
+
+static JSON_ALLOC JSONlegacyAllocate = malloc;
+static JSON_DEALLOC JSONlegacyDeallocate = free;
+
+// NOTE: @Jon
+// The default allocator goes through the functions given to JSONLIB_SetAllocator, which don't take a size or alignment
+static void *LegacyAllocate(void *context, size_t numBytes, size_t alignment)
+{
+	(void)context;
+	(void)alignment;
+	return JSONlegacyAllocate(numBytes);
+}
+
+static void *LegacyReallocate(void *context, void *bytes, size_t oldNumBytes, size_t newNumBytes)
+{
+	(void)context;
+	if (JSONlegacyAllocate == malloc && JSONlegacyDeallocate == free)
+		return realloc(bytes, newNumBytes);
 
-		if (stack->dividerCount == 0)
-			return i - startToken;
+	void *resized = JSONlegacyAllocate(newNumBytes);
+	if (resized == NULL)
+		return NULL;
+	if (bytes != NULL)
+	{
+		memcpy(resized, bytes, oldNumBytes < newNumBytes ? oldNumBytes : newNumBytes);
+		JSONlegacyDeallocate(bytes);
 	}
-	return -1;
+	return resized;
 }
 
-// NOTE: @Jon
-// Convenience function for adding a new value to an array that's being parsed
-static void AddValueToArray(JSON** json)
+static void LegacyDeallocate(void *context, void *bytes, size_t numBytes)
 {
-	JSONLIB_AddValueJSON((*json), NULL);
-	JSON* newVal = (JSON*)JSON_Allocate(sizeof(JSON));
-	newVal->parent = (*json);
-	assert((*json)->values != NULL);
-	(*json)->values[(*json)->valueCount - 1] = newVal;
-	(*json) = newVal;
-	(*json)->name = NULL;
+	(void)context;
+	(void)numBytes;
+	JSONlegacyDeallocate(bytes);
 }
 
+static const JSONLIB_Allocator JSONlegacyAllocator = { NULL, LegacyAllocate, LegacyReallocate, LegacyDeallocate };
+
 // NOTE: @Jon
-// Convenience function for adding a decimal number to a node
-static void AddDecimalValue(JSON **json, const char *decimalStr)
+// What the library allocates with when nothing more specific (like an arena's allocator) is given
+static JSONLIB_Allocator JSONallocator = { NULL, LegacyAllocate, LegacyReallocate, LegacyDeallocate };
+
+static void *AllocateWith(const JSONLIB_Allocator *allocator, size_t numBytes)
 {
-	(*json)->decimal = (f32)atof(decimalStr);
-	(*json)->tags = 0;
-	(*json)->tags |= JSON_DECIMAL_TAG;
-	(*json)->valueCount = 0;
-	*json = (*json)->parent;
-	JSON_Deallocate((void*)decimalStr);
+	return allocator->allocate(allocator->context, numBytes, JSON_ALLOCATION_ALIGNMENT);
 }
 
 // NOTE: @Jon
-// Convenience function for adding an integer number to a node
-static void AddIntegerValue(JSON **json, const char *integerStr)
+// Resizes a block keeping its contents, on failure the old block is left as it was
+static void *ReallocateWith(const JSONLIB_Allocator *allocator, void *bytes, size_t oldNumBytes, size_t newNumBytes)
 {
-	(*json)->integer = atoi(integerStr);
-	(*json)->tags = 0;
-	(*json)->tags |= JSON_INTEGER_TAG;
-	(*json)->valueCount = 0;
-	*json = (*json)->parent;
-	JSON_Deallocate((void*)integerStr);
+	return allocator->reallocate(allocator->context, bytes, oldNumBytes, newNumBytes);
 }
 
-// NOTE: @Jon
-// Convenience function for adding a string to a node
-static void AddStringValue(JSON **json, const char *str)
+static void DeallocateWith(const JSONLIB_Allocator *allocator, void *bytes, size_t numBytes)
 {
-	(*json)->string = str;
-	(*json)->tags = 0;
-	(*json)->tags |= JSON_STRING_TAG;
-	(*json)->valueCount = 0;
-	*json = (*json)->parent;
+	allocator->deallocate(allocator->context, bytes, numBytes);
 }
 
 // NOTE: @Jon
-// Convenience function for adding a boolean value to a node
-static void AddBooleanValue(JSON** json, bool boolean)
+// The allocator the calling thread set with JSONLIB_UseAllocator, NULL when it uses the library's
+static JSON_THREAD_LOCAL const JSONLIB_Allocator *JSONthreadAllocator = NULL;
+
+static const JSONLIB_Allocator *CurrentAllocator(void)
 {
-	(*json)->boolean = boolean;
-	(*json)->tags = 0;
-	(*json)->tags |= JSON_BOOLEAN_TAG;
-	(*json)->valueCount = 0;
-	*json = (*json)->parent;
+	return JSONthreadAllocator != NULL ? JSONthreadAllocator : &JSONallocator;
 }
 
 // NOTE: @Jon
-// Convenience function for adding a null value to a node
-static void AddNullValue(JSON** json)
+// The calling thread's allocator, for working memory and for objects that keep a copy of it to free themselves with
+static void *JSON_Allocate(size_t numBytes)
+{
+	return AllocateWith(CurrentAllocator(), numBytes);
+}
+
+static void *JSON_Reallocate(void *bytes, size_t oldNumBytes, size_t newNumBytes)
+{
+	return ReallocateWith(CurrentAllocator(), bytes, oldNumBytes, newNumBytes);
+}
+
+static void JSON_Deallocate(void *bytes, size_t numBytes)
 {
-	(*json)->values = NULL;
-	(*json)->tags = 0;
-	(*json)->tags |= JSON_NULL_TAG;
-	(*json)->valueCount = 0;
-	*json = (*json)->parent;
+	DeallocateWith(CurrentAllocator(), bytes, numBytes);
 }
 
 // NOTE: @Jon
-// Function for tokenising the given input string
-static JSON_TOKENS* Tokenise(const char* jsonString, u32 stringLength, JSON_DIVIDER_STACK* dividerStack)
+// Bump allocates from the arena, moving on to (or appending) another block when the current one is full
+static void *ArenaAllocate(JSONLIB_Arena *arena, size_t numBytes)
 {
-	JSON_TOKENS* container = (JSON_TOKENS*)JSON_Allocate(sizeof(JSON_TOKENS));
-	container->tokens = (JSON_TOKEN*)JSON_Allocate(sizeof(JSON_TOKEN) * JSON_DEFAULT_TOKENS);
-	container->tokenCount = 0;
-	container->tokenCapacity = JSON_DEFAULT_TOKENS;
+	numBytes = (numBytes + JSON_ARENA_ALIGNMENT - 1) & ~(size_t)(JSON_ARENA_ALIGNMENT - 1);
 
-	for (u32 i = 0; i < stringLength; ++i)
+	JSON_ARENA_BLOCK *block = arena->current;
+	while (block == NULL || block->used + numBytes > block->capacity)
 	{
-		if (container->tokenCount >= container->tokenCapacity)
+		JSON_ARENA_BLOCK *next = block != NULL ? block->next : arena->first;
+		if (next == NULL)
 		{
-			JSON_TOKEN* newTokenAlloc = (JSON_TOKEN*)JSON_Allocate(sizeof(JSON_TOKEN) * container->tokenCapacity * 2);
-			assert(newTokenAlloc != NULL);
-
-			memcpy(newTokenAlloc, container->tokens, sizeof(JSON_TOKEN) * container->tokenCapacity);
-			JSON_Deallocate(container->tokens);
+			const size_t capacity = numBytes > arena->blockSize ? numBytes : arena->blockSize;
+			next = (JSON_ARENA_BLOCK*)AllocateWith(&arena->allocator, sizeof(JSON_ARENA_BLOCK) + capacity);
+			if (next == NULL)
+				return NULL;
+			next->next = NULL;
+			next->capacity = capacity;
 
-			container->tokens = newTokenAlloc;
-			container->tokenCapacity *= 2;
-
-		}
-		switch (jsonString[i])
-		{
-			// NOTE: @Jon
-			// Fairly standard JSON character handling
-		case '{':
-			container->tokens[container->tokenCount++].type = LEFT_BRACE;
-			DividerStackPush(dividerStack, jsonString[i]);
-			break;
-		case '}':
-			container->tokens[container->tokenCount++].type = RIGHT_BRACE;
-			DividerStackPop(dividerStack);
-			break;
-		case '[':
-			container->tokens[container->tokenCount++].type = LEFT_SQUARE_BRACKET;
-			DividerStackPush(dividerStack, jsonString[i]);
-			break;
-		case ']':
-			container->tokens[container->tokenCount++].type = RIGHT_SQUARE_BRACKET;
-			DividerStackPop(dividerStack);
-			break;
-		case '"':
-			if (dividerStack->dividerStack[dividerStack->dividerCount - 1] == '"')
-				dividerStack->dividerCount--;
+			if (block != NULL)
+				block->next = next;
 			else
-				DividerStackPush(dividerStack, jsonString[i]);
-			break;
-		case ':':
-			container->tokens[container->tokenCount++].type = COLON;
-			break;
-		case ',':
-			container->tokens[container->tokenCount++].type = COMMA;
-			break;
-		default:
-			if (container->tokens[container->tokenCount - 1].type == COLON)
-			{
-				if (dividerStack->dividerStack[dividerStack->dividerCount - 1] == '"')
-				{
-					for (u32 iter = i; iter < stringLength; ++iter)
-					{
-						if (jsonString[iter] == '"')
-						{
-							// Get the length of the string
-							u32 length = (iter - i) + 1;
-
-							ParseValue(&container->tokens[container->tokenCount++], &jsonString[i - 1], length);
-
-							// Stop checking for an identifier
-							i = iter - 1;
-							break;
-						}
-					}
-				}
-				else if ((jsonString[i] > 47 && jsonString[i] < 58) || jsonString[i] == '-')
-				{
-					for (u32 iter = i; iter < stringLength; ++iter)
-					{
-						if (jsonString[iter] == ',' || jsonString[iter] == '}')
-						{
-							u32 length = iter - i;
-							ParseValue(&container->tokens[container->tokenCount++], &jsonString[i], length);
-							i = iter - 1;
-							break;
-						}
-					}
-				}
-				else if (jsonString[i] == 'n' || jsonString[i] == 't' || jsonString[i] == 'f')
-				{
-					for (u32 iter = i; iter < stringLength; ++iter)
-					{
-						if (jsonString[iter] == ',' || jsonString[iter] == '}')
-						{
-							u32 length = iter - i;
-							ParseValue(&container->tokens[container->tokenCount++], &jsonString[i], length - 1);
-							i = iter - 1;
-							break;
-						}
-					}
-				}
-			}
-			else if ((container->tokens[container->tokenCount - 1].type == COMMA || container->tokens[container->tokenCount - 1].type == LEFT_BRACE || container->tokens[container->tokenCount - 1].type == LEFT_SQUARE_BRACKET))
-			{
-				if (dividerStack->dividerStack[dividerStack->dividerCount - 1] == '"')
-				{
-					for (u32 iter = i; iter < stringLength; ++iter)
-					{
-						if (jsonString[iter] == '"')
-						{
-							// Get the length of the string
-							u32 length = iter - i;
-
-							ParseIdentifier(&container->tokens[container->tokenCount++] , &jsonString[i], length);
-							// printf("%s\n", container->tokens[container->tokenCount].identifier);
-
-							// Stop checking for an identifier
-							i = iter - 1;
-							break;
-						}
-					}
-				}
-				bool divstack = false;
-				if (dividerStack->dividerCount > 1)
-					divstack = dividerStack->dividerStack[dividerStack->dividerCount - 2] == '[';
-				if (dividerStack->dividerStack[dividerStack->dividerCount - 1] == '[' || divstack)
-				{
-					if (jsonString[i] > 47 && jsonString[i] < 58)
-					{
-						for (u32 iter = i; iter < stringLength; ++iter)
-						{
-							if (jsonString[iter] == ',' || jsonString[iter] == '}' || jsonString[iter] == ']' || jsonString[iter] == '\r' || jsonString[iter] == '\n')
-							{
-								u32 length = iter - i;
-								ParseValue(&container->tokens[container->tokenCount++], &jsonString[i], length);
-								i = iter - 1;
-								break;
-							}
-						}
-					}
-				}
-			}
-			break;
+				arena->first = next;
 		}
+		next->used = 0;
+		block = next;
 	}
-	return container;
+	arena->current = block;
+
+	void *ptr = (char*)(block + 1) + block->used;
+	block->used += numBytes;
+	return ptr;
+}
+
+// NOTE: @Jon
+// Allocation helpers for the parts of a tree, going to the arena when there is one and the nodes' allocator otherwise
+static void *ParseAllocate(JSONLIB_Arena *arena, const JSONLIB_Allocator *allocator, size_t numBytes)
+{
+	if (arena != NULL)
+		return ArenaAllocate(arena, numBytes);
+	return AllocateWith(allocator, numBytes);
+}
+
+static void ParseDeallocate(JSONLIB_Arena *arena, const JSONLIB_Allocator *allocator, void *bytes, size_t numBytes)
+{
+	if (arena == NULL)
+		DeallocateWith(allocator, bytes, numBytes);
 }
 
 // NOTE: @Jon
-// Corrects some problems with the tokenisation process after it has finished running
-static bool CorrectTokens(JSON_TOKENS* tokens, JSON_DIVIDER_STACK* dividerStack)
+// Node pools and thread allocators
+// Nodes that aren't going into an arena come from the calling thread's node pool when it has one, or on their own
+// from its allocator. Both are per thread so no locking is needed, and every node remembers where it came from so
+// any thread can free it. The parallel parser's workers allocate nodes on their own with the starting thread's allocator.
+
+// NOTE: @Jon
+// The node pool of the calling thread, set with JSONLIB_UseNodePool
+static JSON_THREAD_LOCAL JSONLIB_NodePool *JSONnodePool = NULL;
+
+static JSON *PoolAllocateNode(JSONLIB_NodePool *pool)
 {
-	for (u32 i = 0; i < dividerStack->dividerCapacity; ++i)
+	JSON *node = pool->freeNodes;
+	if (node != NULL)
 	{
-		dividerStack->dividerStack[i] = ' ';
+		pool->freeNodes = node->parent;
+		return node;
 	}
 
-	for (u32 i = 0; i < tokens->tokenCount; ++i)
+	JSON_NODE_SLAB *slab = pool->slabs;
+	if (slab == NULL || slab->used == slab->capacity)
 	{
-		//JSON_TOKEN* prev = i > 0 ? &tokens->tokens[i - 1] : NULL;
-		JSON_TOKEN* next = i < tokens->tokenCount - 1 ? &tokens->tokens[i + 1] : NULL;
-		JSON_TOKEN* current = &tokens->tokens[i];
-
-		switch (current->type)
-		{
-		default:
-			break;
-		case LEFT_BRACE:
-			DividerStackPush(dividerStack, '{');
-			break;
-		case LEFT_SQUARE_BRACKET:
-			DividerStackPush(dividerStack, '[');
-			break;
-		case RIGHT_BRACE:
-		case RIGHT_SQUARE_BRACKET:
-			DividerStackPop(dividerStack);
-			break;
-		case JSON_ERROR:
-			return false;
-		}
+		slab = (JSON_NODE_SLAB*)AllocateWith(&pool->allocator, sizeof(JSON_NODE_SLAB) + sizeof(JSON_POOLED_NODE) * pool->nodesPerSlab);
+		if (slab == NULL)
+			return NULL;
+		slab->next = pool->slabs;
+		slab->used = 0;
+		slab->capacity = pool->nodesPerSlab;
+		pool->slabs = slab;
+	}
+	JSON_POOLED_NODE *cell = &slab->nodes[slab->used++];
+	cell->pool = pool;
+	return &cell->node;
+}
 
-		if (current->type == IDENTIFIER)
+// NOTE: @Jon
+// Allocates a node from pool if there is one, otherwise on its own with allocator (NULL for the library's)
+// The node's flags say where it came from
+static JSON *AllocateNodeFrom(JSONLIB_NodePool *pool, const JSONLIB_Allocator *allocator)
+{
+	JSON *node = NULL;
+	if (pool != NULL)
+	{
+		node = PoolAllocateNode(pool);
+		if (node != NULL)
+			node->flags = JSON_POOLED_FLAG;
+	}
+	else if (allocator != NULL)
+	{
+		JSON_ALLOCATED_NODE *cell = (JSON_ALLOCATED_NODE*)AllocateWith(allocator, sizeof(JSON_ALLOCATED_NODE));
+		if (cell != NULL)
 		{
-			if (dividerStack->dividerCount != 0 && next != NULL)
-			{
-				if (dividerStack->dividerStack[dividerStack->dividerCount - 1] == '[' && next->type != COLON)
-					current->type = STRING;
-			}
+			cell->allocator = allocator;
+			node = &cell->node;
+			node->flags = JSON_ALLOCATED_FLAG;
 		}
 	}
-
-	return true;
+	else
+	{
+		node = (JSON*)AllocateWith(&JSONallocator, sizeof(JSON));
+		if (node != NULL)
+			node->flags = 0;
+	}
+	return node;
 }
 
+// NOTE: @Jon
+// Allocates a node the way the calling thread is set up to
+static JSON *AllocateNode(void)
+{
+	return AllocateNodeFrom(JSONnodePool, JSONthreadAllocator);
+}
 
 // NOTE: @Jon
-// Internal parsing function
-static JSON *ParseJSONInternal(JSON_TOKEN *tokens, u32 tokenCount, JSON_DIVIDER_STACK *stack, const u8 tags, JSON *parent)
+// Where the parts of a node from AllocateNodeFrom (its name, string, values and index) come from
+static const JSONLIB_Allocator *NodeSourceAllocator(const JSONLIB_NodePool *pool, const JSONLIB_Allocator *allocator)
 {
-	JSON* json = NULL;
-	if ((!(tags & JSON_ARRAY_TAG) && !(tags & JSON_OBJECT_TAG)) || parent == NULL)
-	{
-		json = (JSON*)JSON_Allocate(sizeof(JSON));
+	if (pool != NULL)
+		return &pool->allocator;
+	return allocator != NULL ? allocator : &JSONallocator;
+}
 
-		assert(json != NULL);
+static JSON_POOLED_NODE *PooledCell(const JSON *node)
+{
+	return (JSON_POOLED_NODE*)((char*)node - offsetof(JSON_POOLED_NODE, node));
+}
 
-		json->name = NULL;
-		json->valueCount = 0;
-		json->tags = 0;
-		json->tags |= tags;
-		json->values = NULL;
-		json->parent = parent;
-	}
-	else
-		json = parent;
+static JSON_ALLOCATED_NODE *AllocatedCell(const JSON *node)
+{
+	return (JSON_ALLOCATED_NODE*)((char*)node - offsetof(JSON_ALLOCATED_NODE, node));
+}
 
-	assert(json != NULL);
+// NOTE: @Jon
+// The allocator a heap node's parts belong to, whichever thread is asking
+static const JSONLIB_Allocator *NodeAllocator(const JSON *node)
+{
+	if (node->flags & JSON_POOLED_FLAG)
+		return &PooledCell(node)->pool->allocator;
+	if (node->flags & JSON_ALLOCATED_FLAG)
+		return AllocatedCell(node)->allocator;
+	return &JSONallocator;
+}
 
-	bool finished = true;
-	for (u32 i = 1; i < tokenCount - 1; ++i)
+static void DeallocateNode(JSON *node)
+{
+	if (node->flags & JSON_POOLED_FLAG)
 	{
-		switch (tokens[i].type)
-		{
-		case LEFT_BRACE:
-		{
-			u32 offset = GetCloserOffset(&tokens[i], 0, tokenCount - i, stack, LEFT_BRACE, RIGHT_BRACE);
-
-			if (offset == -1)
-			{
-				finished = false;
-				break;
-			}
+		// Back onto the free list of the pool it came from, not whichever one the thread is using now
+		JSON_POOLED_NODE *cell = PooledCell(node);
+		node->parent = cell->pool->freeNodes;
+		cell->pool->freeNodes = node;
+	}
+	else if (node->flags & JSON_ALLOCATED_FLAG)
+	{
+		JSON_ALLOCATED_NODE *cell = AllocatedCell(node);
+		DeallocateWith(cell->allocator, cell, sizeof(JSON_ALLOCATED_NODE));
+	}
+	else
+	{
+		DeallocateWith(&JSONallocator, node, sizeof(JSON));
+	}
+}
 
-			assert(json != NULL);
+// NOTE: @Jon
+// Creates a node pool whose slabs hold nodesPerSlab nodes each (0 uses the default)
+JSONLIB_NodePool *JSONLIB_CreateNodePool(u32 nodesPerSlab)
+{
+	return JSONLIB_CreateNodePoolWith(nodesPerSlab, CurrentAllocator());
+}
 
-			if (HasTags(json, JSON_ARRAY_TAG))
+// NOTE: @Jon
+// Creates a node pool that takes itself, its slabs and the parts of its nodes from a copy of the given allocator
+JSONLIB_NodePool *JSONLIB_CreateNodePoolWith(u32 nodesPerSlab, const JSONLIB_Allocator *allocator)
+{
+	assert(allocator != NULL);
+	JSONLIB_NodePool *pool = (JSONLIB_NodePool*)AllocateWith(allocator, sizeof(JSONLIB_NodePool));
+	if (pool == NULL)
+		return NULL;
+
+	pool->slabs = NULL;
+	pool->freeNodes = NULL;
+	pool->nodesPerSlab = nodesPerSlab > 0 ? nodesPerSlab : JSON_DEFAULT_NODE_SLAB_SIZE;
+	pool->allocator = *allocator;
+	return pool;
+}
+
+// NOTE: @Jon
+// Frees a node pool along with every slab it has, the calling thread stops using it if it was
+void JSONLIB_DestroyNodePool(JSONLIB_NodePool *pool)
+{
+	if (pool == NULL)
+		return;
+
+	if (JSONnodePool == pool)
+		JSONnodePool = NULL;
+
+	// The pool's allocator is copied out first since it's freed along with the pool
+	const JSONLIB_Allocator allocator = pool->allocator;
+	JSON_NODE_SLAB *slab = pool->slabs;
+	while (slab != NULL)
+	{
+		JSON_NODE_SLAB *next = slab->next;
+		DeallocateWith(&allocator, slab, sizeof(JSON_NODE_SLAB) + sizeof(JSON_POOLED_NODE) * slab->capacity);
+		slab = next;
+	}
+	DeallocateWith(&allocator, pool, sizeof(JSONLIB_NodePool));
+}
+
+// NOTE: @Jon
+// Sets the node pool for the calling thread, NULL goes back to allocating every node on its own
+void JSONLIB_UseNodePool(JSONLIB_NodePool *pool)
+{
+	JSONnodePool = pool;
+}
+
+// NOTE: @Jon
+// Sets the allocator for the calling thread, NULL goes back to the library's
+void JSONLIB_UseAllocator(const JSONLIB_Allocator *allocator)
+{
+	JSONthreadAllocator = allocator;
+}
+
+// NOTE: @Jon
+// Allocates an empty node for the parser, from the arena if there is one and otherwise like AllocateNodeFrom
+static JSON *ParseAllocateNode(JSONLIB_Arena *arena, JSONLIB_NodePool *pool, const JSONLIB_Allocator *allocator, JSON *parent)
+{
+	JSON *node = arena != NULL ? (JSON*)ArenaAllocate(arena, sizeof(JSON)) : AllocateNodeFrom(pool, allocator);
+	if (node == NULL)
+		return NULL;
+
+	node->parent = parent;
+	node->name = NULL;
+	node->nameLength = 0;
+	node->values = NULL;
+	node->index = NULL;
+	node->valueCount = 0;
+	node->valueCapacity = 0;
+	node->tags = 0;
+	if (arena != NULL)
+		node->flags = JSON_ARENA_FLAG;
+	return node;
+}
+
+// NOTE: @Jon
+// Stores an integer, tagging every member that holds it exactly
+static void SetInteger64(JSON *json, const i64 integer)
+{
+	json->integer64 = integer;
+	json->integer = (i32)integer;
+	json->tags = JSON_INTEGER64_TAG;
+	if (integer >= -2147483647 - 1 && integer <= 2147483647)
+		json->tags |= JSON_INTEGER_TAG;
+	if (integer >= 0)
+		json->tags |= JSON_UNSIGNED64_TAG;
+}
+
+static void SetUnsigned64(JSON *json, const u64 integer)
+{
+	if (integer <= 0x7FFFFFFFFFFFFFFFULL)
+	{
+		SetInteger64(json, (i64)integer);
+		return;
+	}
+	json->unsigned64 = integer;
+	json->integer = (i32)integer;
+	json->tags = JSON_UNSIGNED64_TAG;
+}
+
+// NOTE: @Jon
+// Stores a double, the 32 bit member gets the nearest float for code that only reads that
+static void SetDecimal64(JSON *json, const f64 decimal)
+{
+	json->decimal64 = decimal;
+	json->decimal = (f32)decimal;
+	json->tags = JSON_DECIMAL_TAG | JSON_DECIMAL64_TAG;
+}
+
+// NOTE: @Jon
+// Allocates a JSON node
+// Uses the allocation functions specified with JSONLIB_SetAllocator
+JSON* JSONLIB_AllocateJSON(const char* name, struct JSON* parent)
+{
+	JSON* node = AllocateNode();
+	if (node == NULL)
+		return NULL;
+
+	node->name = name;
+	node->nameLength = name != NULL ? (u32)strlen(name) : 0;
+	node->parent = NULL;
+	node->values = NULL;
+	node->index = NULL;
+	node->valueCount = 0;
+	node->valueCapacity = 0;
+	node->tags = JSON_OBJECT_TAG;
+	
+	// A node that can't be added to its parent is given back, leaving the name with the caller
+	if (parent != NULL && !JSONLIB_AddValueJSON(parent, node))
+	{
+		DeallocateNode(node);
+		return NULL;
+	}
+	
+	return node;
+}
+
+// NOTE: @Jon
+// Allocates a JSON node
+// Uses the allocation functions specified with JSONLIB_SetAllocator
+JSON* JSONLIB_AllocateIntegerJSON(const char* name, struct JSON* parent, const i32 integer)
+{
+	JSON* node = JSONLIB_AllocateJSON(name, parent);
+	if (node != NULL)
+		SetInteger64(node, integer);
+	return node;
+}
+
+// NOTE: @Jon
+// Allocates a JSON node
+// Uses the allocation functions specified with JSONLIB_SetAllocator
+JSON* JSONLIB_AllocateDecimalJSON(const char* name, struct JSON* parent, const f32 decimal)
+{
+	JSON* node = JSONLIB_AllocateJSON(name, parent);
+	if (node != NULL)
+	{
+		node->decimal = decimal;
+		node->tags = JSON_DECIMAL_TAG;
+	}
+	return node;
+}
+
+// NOTE: @Jon
+// Allocates a JSON node holding a 64 bit integer
+// Uses the allocation functions specified with JSONLIB_SetAllocator
+JSON* JSONLIB_AllocateInteger64JSON(const char* name, struct JSON* parent, const i64 integer)
+{
+	JSON* node = JSONLIB_AllocateJSON(name, parent);
+	if (node != NULL)
+		SetInteger64(node, integer);
+	return node;
+}
+
+// NOTE: @Jon
+// Allocates a JSON node holding an unsigned 64 bit integer
+// Uses the allocation functions specified with JSONLIB_SetAllocator
+JSON* JSONLIB_AllocateUnsigned64JSON(const char* name, struct JSON* parent, const u64 integer)
+{
+	JSON* node = JSONLIB_AllocateJSON(name, parent);
+	if (node != NULL)
+		SetUnsigned64(node, integer);
+	return node;
+}
+
+// NOTE: @Jon
+// Allocates a JSON node holding a double
+// Uses the allocation functions specified with JSONLIB_SetAllocator
+JSON* JSONLIB_AllocateDecimal64JSON(const char* name, struct JSON* parent, const f64 decimal)
+{
+	JSON* node = JSONLIB_AllocateJSON(name, parent);
+	if (node != NULL)
+		SetDecimal64(node, decimal);
+	return node;
+}
+
+// NOTE: @Jon
+// Allocates a JSON node
+// Uses the allocation functions specified with JSONLIB_SetAllocator
+JSON* JSONLIB_AllocateStringJSON(const char* name, struct JSON* parent, const char* string)
+{
+	JSON* node = JSONLIB_AllocateJSON(name, parent);
+	if (node != NULL)
+	{
+		node->string = string;
+		node->stringLength = (u32)strlen(string);
+		node->tags = JSON_STRING_TAG;
+	}
+	return node;
+}
+
+// NOTE: @Jon
+// Allocates a JSON node
+// Uses the allocation functions specified with JSONLIB_SetAllocator
+JSON* JSONLIB_AllocateBooleanJSON(const char* name, struct JSON* parent, const bool boolean)
+{
+	JSON* node = JSONLIB_AllocateJSON(name, parent);
+	if (node != NULL)
+	{
+		node->boolean = boolean;
+		node->tags = JSON_BOOLEAN_TAG;
+	}
+	return node;
+}
+
+// NOTE: @Jon
+// Member index
+// Objects with many members get a hash table over their names so lookups don't compare every name
+
+// NOTE: @Jon
+// Hashes a member name eight bytes at a time
+static u32 HashName(const char *name, const u32 nameLength)
+{
+	u64 hash = 0x9E3779B97F4A7C15ULL ^ nameLength;
+	u32 i = 0;
+	for (; i + 8 <= nameLength; i += 8)
+	{
+		u64 word;
+		memcpy(&word, &name[i], sizeof(word));
+		hash = (hash ^ word) * 0xFF51AFD7ED558CCDULL;
+		hash ^= hash >> 32;
+	}
+	if (i < nameLength)
+	{
+		// A short copy of unknown length is a library call, the few bytes left are cheaper by hand
+		u64 word = 0;
+		for (u32 shift = 0; i < nameLength; ++i, shift += 8)
+			word |= (u64)(u8)name[i] << shift;
+		hash = (hash ^ word) * 0xFF51AFD7ED558CCDULL;
+	}
+
+	hash ^= hash >> 29;
+	hash *= 0xC4CEB9FE1A85EC53ULL;
+	hash ^= hash >> 32;
+	return (u32)hash;
+}
+
+// NOTE: @Jon
+// Adds the member at position to the index, a name that's already there keeps its first member
+// just like a linear search would find it
+static void InsertMember(JSON_MEMBER_INDEX *index, JSON **values, const u32 position)
+{
+	const JSON *member = values[position];
+	if (member == NULL || member->name == NULL)
+		return;
+
+	const u32 mask = index->capacity - 1;
+	const u32 hash = HashName(member->name, member->nameLength);
+	u32 slot = hash & mask;
+	while (index->slots[slot].position != 0)
+	{
+		const JSON *other = values[index->slots[slot].position - 1];
+		if (index->slots[slot].hash == hash && other->nameLength == member->nameLength && memcmp(other->name, member->name, member->nameLength) == 0)
+			return;
+		slot = (slot + 1) & mask;
+	}
+
+	index->slots[slot].hash = hash;
+	index->slots[slot].position = position + 1;
+	index->count++;
+}
+
+// NOTE: @Jon
+// Clears the index and adds every member of the object to it again
+static void FillMemberIndex(JSON_MEMBER_INDEX *index, JSON *json)
+{
+	memset(index->slots, 0, sizeof(JSON_MEMBER_SLOT) * index->capacity);
+	index->count = 0;
+	for (u32 i = 0; i < json->valueCount; ++i)
+		InsertMember(index, json->values, i);
+}
+
+static size_t MemberIndexSize(const u32 capacity)
+{
+	return sizeof(JSON_MEMBER_INDEX) + sizeof(JSON_MEMBER_SLOT) * capacity;
+}
+
+// NOTE: @Jon
+// Builds (or rebuilds) an object's index, with at least twice as many slots as members
+// Gives back false if there's no memory for it, the old index is left as it was
+static bool IndexMembers(JSON *json, JSONLIB_Arena *arena)
+{
+	u32 capacity = JSON_MIN_MEMBER_INDEX_CAPACITY;
+	while (capacity / 2 < json->valueCount)
+		capacity *= 2;
+
+	JSON_MEMBER_INDEX *index = (JSON_MEMBER_INDEX*)ParseAllocate(arena, NodeAllocator(json), MemberIndexSize(capacity));
+	if (index == NULL)
+		return false;
+
+	index->capacity = capacity;
+	FillMemberIndex(index, json);
+	if (json->index != NULL)
+		ParseDeallocate(arena, NodeAllocator(json), json->index, MemberIndexSize(json->index->capacity));
+	json->index = index;
+	return true;
+}
+
+// NOTE: @Jon
+// Finds the first member with the name, through the index when the object has one
+static JSON *FindMember(const JSON *json, const char *name, const u32 nameLength, const u32 hash)
+{
+	// Interned names match by pointer, anything else falls back to comparing the bytes
+	// The lengths are checked first since a shorter name can start at the same pointer as a longer one
+	if (HasTags(json, JSON_OBJECT_TAG) && json->index != NULL)
+	{
+		const JSON_MEMBER_INDEX *index = json->index;
+		const u32 mask = index->capacity - 1;
+		for (u32 slot = hash & mask; index->slots[slot].position != 0; slot = (slot + 1) & mask)
+		{
+			if (index->slots[slot].hash != hash)
+				continue;
+
+			JSON *member = json->values[index->slots[slot].position - 1];
+			if (member->nameLength == nameLength && (member->name == name || memcmp(member->name, name, nameLength) == 0))
+				return member;
+		}
+		return NULL;
+	}
+
+	for (u32 i = 0; i < json->valueCount; ++i)
+	{
+		JSON *value = json->values[i];
+		if (value == NULL || value->name == NULL)
+			continue;
+		if (value->nameLength == nameLength && (value->name == name || memcmp(value->name, name, nameLength) == 0))
+			return value;
+	}
+	return NULL;
+}
+
+// NOTE: @Jon
+// Name interning
+// A name table keeps one copy of every distinct name it's given, so trees parsed with it share their names
+
+// NOTE: @Jon
+// Creates an empty name table
+// Everything it holds comes from the calling thread's allocator, which it keeps a copy of
+JSONLIB_NameTable *JSONLIB_CreateNameTable(void)
+{
+	const JSONLIB_Allocator *allocator = CurrentAllocator();
+	JSONLIB_NameTable *names = (JSONLIB_NameTable*)AllocateWith(allocator, sizeof(JSONLIB_NameTable));
+	if (names == NULL)
+		return NULL;
+
+	names->allocator = *allocator;
+	names->arena = JSONLIB_CreateArenaWith(0, allocator);
+	names->entries = (JSON_NAME_ENTRY*)AllocateWith(allocator, sizeof(JSON_NAME_ENTRY) * JSON_DEFAULT_NAME_TABLE_CAPACITY);
+	if (names->arena == NULL || names->entries == NULL)
+	{
+		JSONLIB_DestroyArena(names->arena);
+		if (names->entries != NULL)
+			DeallocateWith(allocator, names->entries, sizeof(JSON_NAME_ENTRY) * JSON_DEFAULT_NAME_TABLE_CAPACITY);
+		DeallocateWith(allocator, names, sizeof(JSONLIB_NameTable));
+		return NULL;
+	}
+
+	memset(names->entries, 0, sizeof(JSON_NAME_ENTRY) * JSON_DEFAULT_NAME_TABLE_CAPACITY);
+	names->capacity = JSON_DEFAULT_NAME_TABLE_CAPACITY;
+	names->count = 0;
+	return names;
+}
+
+// NOTE: @Jon
+// Frees a name table and every name in it
+void JSONLIB_DestroyNameTable(JSONLIB_NameTable *names)
+{
+	if (names == NULL)
+		return;
+
+	// The allocator is copied out first since it's freed along with the table
+	const JSONLIB_Allocator allocator = names->allocator;
+	JSONLIB_DestroyArena(names->arena);
+	DeallocateWith(&allocator, names->entries, sizeof(JSON_NAME_ENTRY) * names->capacity);
+	DeallocateWith(&allocator, names, sizeof(JSONLIB_NameTable));
+}
+
+// NOTE: @Jon
+// Doubles the entries of a name table, moving every name over by its hash
+static bool GrowNameTable(JSONLIB_NameTable *names)
+{
+	const u32 capacity = names->capacity * 2;
+	JSON_NAME_ENTRY *entries = (JSON_NAME_ENTRY*)AllocateWith(&names->allocator, sizeof(JSON_NAME_ENTRY) * capacity);
+	if (entries == NULL)
+		return false;
+	memset(entries, 0, sizeof(JSON_NAME_ENTRY) * capacity);
+
+	for (u32 i = 0; i < names->capacity; ++i)
+	{
+		const JSON_NAME_ENTRY *entry = &names->entries[i];
+		if (entry->name == NULL)
+			continue;
+
+		u32 slot = entry->hash & (capacity - 1);
+		while (entries[slot].name != NULL)
+			slot = (slot + 1) & (capacity - 1);
+		entries[slot] = *entry;
+	}
+
+	DeallocateWith(&names->allocator, names->entries, sizeof(JSON_NAME_ENTRY) * names->capacity);
+	names->entries = entries;
+	names->capacity = capacity;
+	return true;
+}
+
+// NOTE: @Jon
+// Gets the canonical copy of a name, adding it to the table the first time it's seen
+const char *JSONLIB_InternName(JSONLIB_NameTable *names, const char *name, u32 nameLength)
+{
+	const u32 hash = HashName(name, nameLength);
+	u32 mask = names->capacity - 1;
+	u32 slot = hash & mask;
+	while (names->entries[slot].name != NULL)
+	{
+		const JSON_NAME_ENTRY *entry = &names->entries[slot];
+		if (entry->hash == hash && entry->nameLength == nameLength && memcmp(entry->name, name, nameLength) == 0)
+			return entry->name;
+		slot = (slot + 1) & mask;
+	}
+
+	// Kept at most half full so probes stay short
+	if ((names->count + 1) * 2 > names->capacity)
+	{
+		if (!GrowNameTable(names))
+			return NULL;
+		mask = names->capacity - 1;
+		slot = hash & mask;
+		while (names->entries[slot].name != NULL)
+			slot = (slot + 1) & mask;
+	}
+
+	char *copy = (char*)ArenaAllocate(names->arena, sizeof(char) * (nameLength + 1));
+	if (copy == NULL)
+		return NULL;
+	memcpy(copy, name, sizeof(char) * nameLength);
+	copy[nameLength] = '\0';
+
+	names->entries[slot].name = copy;
+	names->entries[slot].nameLength = nameLength;
+	names->entries[slot].hash = hash;
+	names->count++;
+	return copy;
+}
+
+// NOTE: @Jon
+// Adds a value to the JSON node given, leaving both as they were if the node's values can't grow
+bool JSONLIB_AddValueJSON(JSON *json, JSON *val)
+{
+	// Grow geometrically so appending is amortised O(1), until the count can't go any higher
+	if (json->valueCount >= json->valueCapacity)
+	{
+		const u32 capacity = json->valueCapacity == 0 ? JSON_DEFAULT_VALUE_CAPACITY :
+			json->valueCapacity < UINT32_MAX / 2 ? json->valueCapacity * 2 : UINT32_MAX;
+		if (json->valueCount == UINT32_MAX || !JSONLIB_ReserveValuesJSON(json, capacity))
+			return false;
+	}
+
+	if (val != NULL)
+		val->parent = json;
+
+	json->values[json->valueCount++] = val;
+
+	// An indexed object keeps its index up to date, growing it before it gets too full
+	if (HasTags(json, JSON_OBJECT_TAG) && json->index != NULL)
+	{
+		if (json->valueCount * 2 > json->index->capacity)
+		{
+			if (!IndexMembers(json, NULL))
+			{
+				DeallocateWith(NodeAllocator(json), json->index, MemberIndexSize(json->index->capacity));
+				json->index = NULL;
+			}
+		}
+		else
+		{
+			InsertMember(json->index, json->values, json->valueCount - 1);
+		}
+	}
+	return true;
+}
+
+// NOTE: @Jon
+// Grows the value array of the JSON node given to hold at least valueCount values, leaving it as it was if that fails
+bool JSONLIB_ReserveValuesJSON(JSON *json, u32 valueCount)
+{
+	// Arena trees can't have their value arrays swapped out from under them
+	assert(!(json->flags & JSON_ARENA_FLAG));
+
+	if (valueCount <= json->valueCapacity)
+		return true;
+	if ((u64)valueCount * sizeof(JSON*) > SIZE_MAX)
+		return false;
+
+	// Resize the old array where the allocator can, otherwise it's copied over
+	JSON **newValueArray = json->valueCapacity > 0 ?
+		(JSON**)ReallocateWith(NodeAllocator(json), json->values, sizeof(JSON*) * json->valueCapacity, sizeof(JSON*) * valueCount) :
+		(JSON**)AllocateWith(NodeAllocator(json), sizeof(JSON*) * valueCount);
+	if (newValueArray == NULL)
+		return false;
+
+	json->values = newValueArray;
+	json->valueCapacity = valueCount;
+	return true;
+}
+
+// NOTE: @Jon
+// Structural indexing
+// Classifies the input 64 bytes at a time into bitmasks and flattens them into the positions of every
+// token boundary outside of strings: {}[]:, characters, both quotes of each string and the first character of each scalar.
+// The parser then hops between those positions instead of looking at every byte.
+
+// NOTE: @Jon
+// Character classes for one 64 byte block, bit n is set when byte n is in the class
+typedef struct JSON_BLOCK_MASKS
+{
+	u64 quote;
+	u64 backslash;
+	u64 op;
+	u64 whitespace;
+} JSON_BLOCK_MASKS;
+
+typedef void (*JSON_CLASSIFY_BLOCK)(const u8 *block, JSON_BLOCK_MASKS *masks);
+
+// NOTE: @Jon
+// Skips string bytes up to the next quote, backslash or control character, noting if any skipped byte wasn't ASCII
+typedef const u8 *(*JSON_SCAN_STRING)(const u8 *iter, const u8 *end, bool *nonASCII);
+
+typedef bool (*JSON_VALIDATE_UTF8)(const u8 *str, const size_t length);
+
+// NOTE: @Jon
+// The vector kernels picked for this CPU
+typedef struct JSON_KERNELS
+{
+	JSON_CLASSIFY_BLOCK classifyBlock;
+	JSON_SCAN_STRING scanString;
+	JSON_VALIDATE_UTF8 validateUTF8;
+} JSON_KERNELS;
+
+static u32 CountTrailingZeros(const u64 bits)
+{
+#if defined(_MSC_VER) && JSON_X64
+	unsigned long index;
+	_BitScanForward64(&index, bits);
+	return (u32)index;
+#elif defined(_MSC_VER)
+	unsigned long index;
+	if (_BitScanForward(&index, (unsigned long)bits))
+		return (u32)index;
+	_BitScanForward(&index, (unsigned long)(bits >> 32));
+	return (u32)index + 32;
+#else
+	return (u32)__builtin_ctzll(bits);
+#endif
+}
+
+#if !JSON_X64
+static const u8 JSON_CLASS_QUOTE = 1 << 0;
+static const u8 JSON_CLASS_BACKSLASH = 1 << 1;
+static const u8 JSON_CLASS_OP = 1 << 2;
+static const u8 JSON_CLASS_WHITESPACE = 1 << 3;
+
+static u8 CharacterClass(const u8 c)
+{
+	switch (c)
+	{
+	case '"': return JSON_CLASS_QUOTE;
+	case '\\': return JSON_CLASS_BACKSLASH;
+	case '{': case '}': case '[': case ']': case ':': case ',': return JSON_CLASS_OP;
+	case ' ': case '\t': case '\n': case '\r': return JSON_CLASS_WHITESPACE;
+	default: return 0;
+	}
+}
+
+// NOTE: @Jon
+// Portable fallback for CPUs without a vector kernel, every x64 CPU has at least SSE2
+static void ClassifyBlockScalar(const u8 *block, JSON_BLOCK_MASKS *masks)
+{
+	u64 quote = 0, backslash = 0, op = 0, whitespace = 0;
+	for (u32 i = 0; i < 64; ++i)
+	{
+		const u8 characterClass = CharacterClass(block[i]);
+		if (characterClass == 0)
+			continue;
+
+		const u64 bit = (u64)1 << i;
+		if (characterClass == JSON_CLASS_QUOTE)
+			quote |= bit;
+		else if (characterClass == JSON_CLASS_BACKSLASH)
+			backslash |= bit;
+		else if (characterClass == JSON_CLASS_OP)
+			op |= bit;
+		else
+			whitespace |= bit;
+	}
+	masks->quote = quote;
+	masks->backslash = backslash;
+	masks->op = op;
+	masks->whitespace = whitespace;
+}
+#endif
+
+static const u64 JSON_BYTES_ONES = 0x0101010101010101ULL;
+static const u64 JSON_BYTES_HIGH = 0x8080808080808080ULL;
+
+static u64 HasZeroByte(const u64 word)
+{
+	return (word - JSON_BYTES_ONES) & ~word & JSON_BYTES_HIGH;
+}
+
+static bool IsStringSpecial(const u8 c)
+{
+	return c == '"' || c == '\\' || c < 0x20;
+}
+
+// NOTE: @Jon
+// Portable string scan, clean runs are skipped eight bytes at a time
+static const u8 *ScanStringScalar(const u8 *iter, const u8 *end, bool *nonASCII)
+{
+	u64 high = 0;
+	while (end - iter >= 8)
+	{
+		u64 word;
+		memcpy(&word, iter, sizeof(word));
+		const u64 special = HasZeroByte(word ^ (JSON_BYTES_ONES * '"')) | HasZeroByte(word ^ (JSON_BYTES_ONES * '\\'))
+			| ((word - JSON_BYTES_ONES * 0x20) & ~word & JSON_BYTES_HIGH);
+		if (special != 0)
+			break;
+		high |= word;
+		iter += 8;
+	}
+	while (iter < end && !IsStringSpecial(*iter))
+		high |= *iter++;
+
+	*nonASCII |= (high & JSON_BYTES_HIGH) != 0;
+	return iter;
+}
+
+// NOTE: @Jon
+// Checks a string is well formed UTF-8: no stray continuation bytes, truncated or overlong sequences,
+// surrogates or codepoints past U+10FFFF
+static bool ValidateUTF8Scalar(const u8 *str, const size_t length)
+{
+	const u8 *iter = str;
+	const u8 *end = str + length;
+	while (iter < end)
+	{
+		if (end - iter >= 8)
+		{
+			u64 word;
+			memcpy(&word, iter, sizeof(word));
+			if ((word & JSON_BYTES_HIGH) == 0)
+			{
+				iter += 8;
+				continue;
+			}
+		}
+
+		const u8 lead = *iter;
+		if (lead < 0x80)
+		{
+			++iter;
+			continue;
+		}
+
+		// The second byte's range is what rules out overlong forms, surrogates and codepoints that are too large
+		u32 continuations = 0;
+		u8 secondMin = 0x80, secondMax = 0xBF;
+		if (lead >= 0xC2 && lead <= 0xDF)
+			continuations = 1;
+		else if (lead >= 0xE0 && lead <= 0xEF)
+		{
+			continuations = 2;
+			if (lead == 0xE0)
+				secondMin = 0xA0;
+			else if (lead == 0xED)
+				secondMax = 0x9F;
+		}
+		else if (lead >= 0xF0 && lead <= 0xF4)
+		{
+			continuations = 3;
+			if (lead == 0xF0)
+				secondMin = 0x90;
+			else if (lead == 0xF4)
+				secondMax = 0x8F;
+		}
+		else
+			return false;
+
+		if ((size_t)(end - iter) <= continuations || iter[1] < secondMin || iter[1] > secondMax)
+			return false;
+		for (u32 i = 2; i <= continuations; ++i)
+		{
+			if ((iter[i] & 0xC0) != 0x80)
+				return false;
+		}
+		iter += continuations + 1;
+	}
+	return true;
+}
+
+#if JSON_X64
+// NOTE: @Jon
+// '[' and ']' are '{' and '}' without bit 5, so OR-ing 0x20 in folds the four brackets into two compares
+static void ClassifyBlockSSE2(const u8 *block, JSON_BLOCK_MASKS *masks)
+{
+	const __m128i quote = _mm_set1_epi8('"');
+	const __m128i backslash = _mm_set1_epi8('\\');
+	const __m128i caseBit = _mm_set1_epi8(0x20);
+	const __m128i leftBrace = _mm_set1_epi8('{');
+	const __m128i rightBrace = _mm_set1_epi8('}');
+	const __m128i colon = _mm_set1_epi8(':');
+	const __m128i comma = _mm_set1_epi8(',');
+	const __m128i space = _mm_set1_epi8(' ');
+	const __m128i tab = _mm_set1_epi8('\t');
+	const __m128i newline = _mm_set1_epi8('\n');
+	const __m128i carriageReturn = _mm_set1_epi8('\r');
+
+	masks->quote = masks->backslash = masks->op = masks->whitespace = 0;
+	for (u32 i = 0; i < 4; ++i)
+	{
+		const __m128i chunk = _mm_loadu_si128((const __m128i*)(block + i * 16));
+		const __m128i folded = _mm_or_si128(chunk, caseBit);
+		const __m128i op = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(folded, leftBrace), _mm_cmpeq_epi8(folded, rightBrace)),
+			_mm_or_si128(_mm_cmpeq_epi8(chunk, colon), _mm_cmpeq_epi8(chunk, comma)));
+		const __m128i whitespace = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, space), _mm_cmpeq_epi8(chunk, tab)),
+			_mm_or_si128(_mm_cmpeq_epi8(chunk, newline), _mm_cmpeq_epi8(chunk, carriageReturn)));
+
+		const u32 shift = i * 16;
+		masks->quote |= (u64)(u32)_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, quote)) << shift;
+		masks->backslash |= (u64)(u32)_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, backslash)) << shift;
+		masks->op |= (u64)(u32)_mm_movemask_epi8(op) << shift;
+		masks->whitespace |= (u64)(u32)_mm_movemask_epi8(whitespace) << shift;
+	}
+}
+
+JSON_TARGET_AVX2 static void ClassifyBlockAVX2(const u8 *block, JSON_BLOCK_MASKS *masks)
+{
+	const __m256i quote = _mm256_set1_epi8('"');
+	const __m256i backslash = _mm256_set1_epi8('\\');
+	const __m256i caseBit = _mm256_set1_epi8(0x20);
+	const __m256i leftBrace = _mm256_set1_epi8('{');
+	const __m256i rightBrace = _mm256_set1_epi8('}');
+	const __m256i colon = _mm256_set1_epi8(':');
+	const __m256i comma = _mm256_set1_epi8(',');
+	const __m256i space = _mm256_set1_epi8(' ');
+	const __m256i tab = _mm256_set1_epi8('\t');
+	const __m256i newline = _mm256_set1_epi8('\n');
+	const __m256i carriageReturn = _mm256_set1_epi8('\r');
+
+	masks->quote = masks->backslash = masks->op = masks->whitespace = 0;
+	for (u32 i = 0; i < 2; ++i)
+	{
+		const __m256i chunk = _mm256_loadu_si256((const __m256i*)(block + i * 32));
+		const __m256i folded = _mm256_or_si256(chunk, caseBit);
+		const __m256i op = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(folded, leftBrace), _mm256_cmpeq_epi8(folded, rightBrace)),
+			_mm256_or_si256(_mm256_cmpeq_epi8(chunk, colon), _mm256_cmpeq_epi8(chunk, comma)));
+		const __m256i whitespace = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(chunk, space), _mm256_cmpeq_epi8(chunk, tab)),
+			_mm256_or_si256(_mm256_cmpeq_epi8(chunk, newline), _mm256_cmpeq_epi8(chunk, carriageReturn)));
+
+		const u32 shift = i * 32;
+		masks->quote |= (u64)(u32)_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, quote)) << shift;
+		masks->backslash |= (u64)(u32)_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, backslash)) << shift;
+		masks->op |= (u64)(u32)_mm256_movemask_epi8(op) << shift;
+		masks->whitespace |= (u64)(u32)_mm256_movemask_epi8(whitespace) << shift;
+	}
+}
+
+JSON_TARGET_AVX512 static void ClassifyBlockAVX512(const u8 *block, JSON_BLOCK_MASKS *masks)
+{
+	const __m512i chunk = _mm512_loadu_si512((const void*)block);
+	const __m512i folded = _mm512_or_si512(chunk, _mm512_set1_epi8(0x20));
+
+	masks->quote = _mm512_cmpeq_epi8_mask(chunk, _mm512_set1_epi8('"'));
+	masks->backslash = _mm512_cmpeq_epi8_mask(chunk, _mm512_set1_epi8('\\'));
+	masks->op = _mm512_cmpeq_epi8_mask(folded, _mm512_set1_epi8('{')) | _mm512_cmpeq_epi8_mask(folded, _mm512_set1_epi8('}'))
+		| _mm512_cmpeq_epi8_mask(chunk, _mm512_set1_epi8(':')) | _mm512_cmpeq_epi8_mask(chunk, _mm512_set1_epi8(','));
+	masks->whitespace = _mm512_cmpeq_epi8_mask(chunk, _mm512_set1_epi8(' ')) | _mm512_cmpeq_epi8_mask(chunk, _mm512_set1_epi8('\t'))
+		| _mm512_cmpeq_epi8_mask(chunk, _mm512_set1_epi8('\n')) | _mm512_cmpeq_epi8_mask(chunk, _mm512_set1_epi8('\r'));
+}
+
+// NOTE: @Jon
+// Bytes below 0x20 are the ones min(c, 0x1F) leaves unchanged, SSE2 has no unsigned compare
+static const u8 *ScanStringSSE2(const u8 *iter, const u8 *end, bool *nonASCII)
+{
+	const __m128i quote = _mm_set1_epi8('"');
+	const __m128i backslash = _mm_set1_epi8('\\');
+	const __m128i control = _mm_set1_epi8(0x1F);
+	while (end - iter >= 16)
+	{
+		const __m128i chunk = _mm_loadu_si128((const __m128i*)iter);
+		const __m128i special = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash)),
+			_mm_cmpeq_epi8(_mm_min_epu8(chunk, control), chunk));
+		const u32 specialMask = (u32)_mm_movemask_epi8(special);
+		const u32 highMask = (u32)_mm_movemask_epi8(chunk);
+		if (specialMask != 0)
+		{
+			const u32 position = CountTrailingZeros(specialMask);
+			*nonASCII |= (highMask & ((1u << position) - 1)) != 0;
+			return iter + position;
+		}
+		*nonASCII |= highMask != 0;
+		iter += 16;
+	}
+	return ScanStringScalar(iter, end, nonASCII);
+}
+
+JSON_TARGET_AVX2 static const u8 *ScanStringAVX2(const u8 *iter, const u8 *end, bool *nonASCII)
+{
+	const __m256i quote = _mm256_set1_epi8('"');
+	const __m256i backslash = _mm256_set1_epi8('\\');
+	const __m256i control = _mm256_set1_epi8(0x1F);
+	while (end - iter >= 32)
+	{
+		const __m256i chunk = _mm256_loadu_si256((const __m256i*)iter);
+		const __m256i special = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(chunk, quote), _mm256_cmpeq_epi8(chunk, backslash)),
+			_mm256_cmpeq_epi8(_mm256_min_epu8(chunk, control), chunk));
+		const u32 specialMask = (u32)_mm256_movemask_epi8(special);
+		const u32 highMask = (u32)_mm256_movemask_epi8(chunk);
+		if (specialMask != 0)
+		{
+			const u32 position = CountTrailingZeros(specialMask);
+			*nonASCII |= (highMask & ((1u << position) - 1)) != 0;
+			return iter + position;
+		}
+		*nonASCII |= highMask != 0;
+		iter += 32;
+	}
+	return ScanStringSSE2(iter, end, nonASCII);
+}
+
+JSON_TARGET_AVX512 static const u8 *ScanStringAVX512(const u8 *iter, const u8 *end, bool *nonASCII)
+{
+	const __m512i quote = _mm512_set1_epi8('"');
+	const __m512i backslash = _mm512_set1_epi8('\\');
+	const __m512i control = _mm512_set1_epi8(0x20);
+	while (end - iter >= 64)
+	{
+		const __m512i chunk = _mm512_loadu_si512((const void*)iter);
+		const u64 specialMask = _mm512_cmpeq_epi8_mask(chunk, quote) | _mm512_cmpeq_epi8_mask(chunk, backslash)
+			| _mm512_cmplt_epu8_mask(chunk, control);
+		const u64 highMask = _mm512_movepi8_mask(chunk);
+		if (specialMask != 0)
+		{
+			const u32 position = CountTrailingZeros(specialMask);
+			*nonASCII |= (highMask & (((u64)1 << position) - 1)) != 0;
+			return iter + position;
+		}
+		*nonASCII |= highMask != 0;
+		iter += 64;
+	}
+	return ScanStringSSE2(iter, end, nonASCII);
+}
+
+// NOTE: @Jon
+// Lookup tables for the vector UTF-8 check (Keiser and Lemire), each error class has a bit and a pair of
+// bytes is bad when the high nibble of the first, its low nibble and the high nibble of the second agree on one
+#define JSON_UTF8_TOO_SHORT (1 << 0)
+#define JSON_UTF8_TOO_LONG (1 << 1)
+#define JSON_UTF8_OVERLONG_3 (1 << 2)
+#define JSON_UTF8_TOO_LARGE (1 << 3)
+#define JSON_UTF8_SURROGATE (1 << 4)
+#define JSON_UTF8_OVERLONG_2 (1 << 5)
+#define JSON_UTF8_TOO_LARGE_1000 (1 << 6)
+#define JSON_UTF8_OVERLONG_4 (1 << 6)
+#define JSON_UTF8_TWO_CONTINUATIONS (1 << 7)
+#define JSON_UTF8_CARRY (JSON_UTF8_TOO_SHORT | JSON_UTF8_TOO_LONG | JSON_UTF8_TWO_CONTINUATIONS)
+
+static const u8 JSONutf8FirstHigh[16] =
+{
+	JSON_UTF8_TOO_LONG, JSON_UTF8_TOO_LONG, JSON_UTF8_TOO_LONG, JSON_UTF8_TOO_LONG,
+	JSON_UTF8_TOO_LONG, JSON_UTF8_TOO_LONG, JSON_UTF8_TOO_LONG, JSON_UTF8_TOO_LONG,
+	JSON_UTF8_TWO_CONTINUATIONS, JSON_UTF8_TWO_CONTINUATIONS, JSON_UTF8_TWO_CONTINUATIONS, JSON_UTF8_TWO_CONTINUATIONS,
+	JSON_UTF8_TOO_SHORT | JSON_UTF8_OVERLONG_2,
+	JSON_UTF8_TOO_SHORT,
+	JSON_UTF8_TOO_SHORT | JSON_UTF8_OVERLONG_3 | JSON_UTF8_SURROGATE,
+	JSON_UTF8_TOO_SHORT | JSON_UTF8_TOO_LARGE | JSON_UTF8_TOO_LARGE_1000 | JSON_UTF8_OVERLONG_4
+};
+
+static const u8 JSONutf8FirstLow[16] =
+{
+	JSON_UTF8_CARRY | JSON_UTF8_OVERLONG_3 | JSON_UTF8_OVERLONG_2 | JSON_UTF8_OVERLONG_4,
+	JSON_UTF8_CARRY | JSON_UTF8_OVERLONG_2,
+	JSON_UTF8_CARRY,
+	JSON_UTF8_CARRY,
+	JSON_UTF8_CARRY | JSON_UTF8_TOO_LARGE,
+	JSON_UTF8_CARRY | JSON_UTF8_TOO_LARGE | JSON_UTF8_TOO_LARGE_1000,
+	JSON_UTF8_CARRY | JSON_UTF8_TOO_LARGE | JSON_UTF8_TOO_LARGE_1000,
+	JSON_UTF8_CARRY | JSON_UTF8_TOO_LARGE | JSON_UTF8_TOO_LARGE_1000,
+	JSON_UTF8_CARRY | JSON_UTF8_TOO_LARGE | JSON_UTF8_TOO_LARGE_1000,
+	JSON_UTF8_CARRY | JSON_UTF8_TOO_LARGE | JSON_UTF8_TOO_LARGE_1000,
+	JSON_UTF8_CARRY | JSON_UTF8_TOO_LARGE | JSON_UTF8_TOO_LARGE_1000,
+	JSON_UTF8_CARRY | JSON_UTF8_TOO_LARGE | JSON_UTF8_TOO_LARGE_1000,
+	JSON_UTF8_CARRY | JSON_UTF8_TOO_LARGE | JSON_UTF8_TOO_LARGE_1000,
+	JSON_UTF8_CARRY | JSON_UTF8_TOO_LARGE | JSON_UTF8_TOO_LARGE_1000 | JSON_UTF8_SURROGATE,
+	JSON_UTF8_CARRY | JSON_UTF8_TOO_LARGE | JSON_UTF8_TOO_LARGE_1000,
+	JSON_UTF8_CARRY | JSON_UTF8_TOO_LARGE | JSON_UTF8_TOO_LARGE_1000
+};
+
+static const u8 JSONutf8SecondHigh[16] =
+{
+	JSON_UTF8_TOO_SHORT, JSON_UTF8_TOO_SHORT, JSON_UTF8_TOO_SHORT, JSON_UTF8_TOO_SHORT,
+	JSON_UTF8_TOO_SHORT, JSON_UTF8_TOO_SHORT, JSON_UTF8_TOO_SHORT, JSON_UTF8_TOO_SHORT,
+	JSON_UTF8_TOO_LONG | JSON_UTF8_OVERLONG_2 | JSON_UTF8_TWO_CONTINUATIONS | JSON_UTF8_OVERLONG_3 | JSON_UTF8_TOO_LARGE_1000 | JSON_UTF8_OVERLONG_4,
+	JSON_UTF8_TOO_LONG | JSON_UTF8_OVERLONG_2 | JSON_UTF8_TWO_CONTINUATIONS | JSON_UTF8_OVERLONG_3 | JSON_UTF8_TOO_LARGE,
+	JSON_UTF8_TOO_LONG | JSON_UTF8_OVERLONG_2 | JSON_UTF8_TWO_CONTINUATIONS | JSON_UTF8_SURROGATE | JSON_UTF8_TOO_LARGE,
+	JSON_UTF8_TOO_LONG | JSON_UTF8_OVERLONG_2 | JSON_UTF8_TWO_CONTINUATIONS | JSON_UTF8_SURROGATE | JSON_UTF8_TOO_LARGE,
+	JSON_UTF8_TOO_SHORT, JSON_UTF8_TOO_SHORT, JSON_UTF8_TOO_SHORT, JSON_UTF8_TOO_SHORT
+};
+
+// NOTE: @Jon
+// Error bits for a 32 byte block given the block before it, non-zero means the UTF-8 is bad
+JSON_TARGET_AVX2 static __m256i CheckUTF8BlockAVX2(const __m256i input, const __m256i previous)
+{
+	const __m256i lowNibble = _mm256_set1_epi8(0x0F);
+	const __m256i firstHigh = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)JSONutf8FirstHigh));
+	const __m256i firstLow = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)JSONutf8FirstLow));
+	const __m256i secondHigh = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)JSONutf8SecondHigh));
+
+	// Lines the bytes up with the one, two and three bytes before them, reaching back into the previous block
+	const __m256i straddle = _mm256_permute2x128_si256(previous, input, 0x21);
+	const __m256i prev1 = _mm256_alignr_epi8(input, straddle, 15);
+	const __m256i prev2 = _mm256_alignr_epi8(input, straddle, 14);
+	const __m256i prev3 = _mm256_alignr_epi8(input, straddle, 13);
+
+	const __m256i special = _mm256_and_si256(_mm256_and_si256(
+		_mm256_shuffle_epi8(firstHigh, _mm256_and_si256(_mm256_srli_epi16(prev1, 4), lowNibble)),
+		_mm256_shuffle_epi8(firstLow, _mm256_and_si256(prev1, lowNibble))),
+		_mm256_shuffle_epi8(secondHigh, _mm256_and_si256(_mm256_srli_epi16(input, 4), lowNibble)));
+
+	// The third and fourth bytes of long sequences have to be continuations, which the pair check can't see
+	const __m256i thirdByte = _mm256_subs_epu8(prev2, _mm256_set1_epi8((char)(0xE0 - 0x80)));
+	const __m256i fourthByte = _mm256_subs_epu8(prev3, _mm256_set1_epi8((char)(0xF0 - 0x80)));
+	const __m256i mustContinue = _mm256_and_si256(_mm256_or_si256(thirdByte, fourthByte), _mm256_set1_epi8((char)0x80));
+	return _mm256_xor_si256(mustContinue, special);
+}
+
+// NOTE: @Jon
+// Non-zero if the block ends part way through a multibyte sequence
+JSON_TARGET_AVX2 static __m256i IncompleteUTF8BlockAVX2(const __m256i block)
+{
+	const __m256i maxValue = _mm256_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+		-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, (char)(0xF0 - 1), (char)(0xE0 - 1), (char)(0xC0 - 1));
+	return _mm256_subs_epu8(block, maxValue);
+}
+
+JSON_TARGET_AVX2 static bool ValidateUTF8AVX2(const u8 *str, const size_t length)
+{
+	__m256i previous = _mm256_setzero_si256();
+	__m256i error = _mm256_setzero_si256();
+	size_t offset = 0;
+	for (; offset + 32 <= length; offset += 32)
+	{
+		const __m256i input = _mm256_loadu_si256((const __m256i*)(str + offset));
+
+		// An ASCII block can only be wrong if the one before it was cut short
+		if (_mm256_movemask_epi8(input) == 0)
+			error = _mm256_or_si256(error, IncompleteUTF8BlockAVX2(previous));
+		else
+			error = _mm256_or_si256(error, CheckUTF8BlockAVX2(input, previous));
+		previous = input;
+	}
+
+	if (offset < length)
+	{
+		// Zero padding is ASCII so a sequence cut off by the end of the string shows up as too short
+		u8 padded[32] = { 0 };
+		memcpy(padded, str + offset, length - offset);
+		const __m256i input = _mm256_loadu_si256((const __m256i*)padded);
+		error = _mm256_or_si256(error, CheckUTF8BlockAVX2(input, previous));
+		previous = input;
+	}
+
+	error = _mm256_or_si256(error, IncompleteUTF8BlockAVX2(previous));
+	return _mm256_testz_si256(error, error) != 0;
+}
+#endif
+
+#if JSON_X64
+// NOTE: @Jon
+// CPU feature detection, the best kernel is picked once and reused
+static const u32 JSON_CPU_AVX2 = 1 << 0;
+static const u32 JSON_CPU_AVX512 = 1 << 1;
+
+static u32 DetectCPUFeatures(void)
+{
+	u32 features = 0;
+#if defined(_MSC_VER)
+	int info[4];
+	__cpuid(info, 0);
+	const int maxLeaf = info[0];
+	__cpuid(info, 1);
+	// The OS has to save the wider registers for the instructions to be usable
+	const bool osxsave = (info[2] & (1 << 27)) != 0;
+	if (osxsave && maxLeaf >= 7)
+	{
+		const u64 xcr0 = _xgetbv(0);
+		__cpuidex(info, 7, 0);
+		if ((xcr0 & 0x6) == 0x6 && (info[1] & (1 << 5)))
+			features |= JSON_CPU_AVX2;
+		if ((xcr0 & 0xE6) == 0xE6 && (info[1] & (1 << 16)) && (info[1] & (1 << 30)))
+			features |= JSON_CPU_AVX512;
+	}
+#else
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2"))
+		features |= JSON_CPU_AVX2;
+	if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw"))
+		features |= JSON_CPU_AVX512;
+#endif
+	return features;
+}
+#endif
+
+// NOTE: @Jon
+// The kernels are picked once for the whole process, parsers on any thread can be the first to ask for them
+static JSON_KERNELS JSONkernels = { NULL, NULL, NULL };
+
+static void PickKernels(void)
+{
+	JSON_KERNELS kernels;
+#if JSON_X64
+	const u32 features = DetectCPUFeatures();
+	// The UTF-8 check leans on byte shuffles, AVX-512 parts all have AVX2 so they share its version
+	kernels.validateUTF8 = (features & JSON_CPU_AVX2) ? ValidateUTF8AVX2 : ValidateUTF8Scalar;
+	if (features & JSON_CPU_AVX512)
+	{
+		kernels.scanString = ScanStringAVX512;
+		kernels.classifyBlock = ClassifyBlockAVX512;
+	}
+	else if (features & JSON_CPU_AVX2)
+	{
+		kernels.scanString = ScanStringAVX2;
+		kernels.classifyBlock = ClassifyBlockAVX2;
+	}
+	else
+	{
+		kernels.scanString = ScanStringSSE2;
+		kernels.classifyBlock = ClassifyBlockSSE2;
+	}
+#else
+	kernels.validateUTF8 = ValidateUTF8Scalar;
+	kernels.scanString = ScanStringScalar;
+	kernels.classifyBlock = ClassifyBlockScalar;
+#endif
+	JSONkernels = kernels;
+}
+
+#if defined(_WIN32)
+static INIT_ONCE JSONkernelsOnce = INIT_ONCE_STATIC_INIT;
+
+static BOOL CALLBACK PickKernelsOnce(PINIT_ONCE once, PVOID parameter, PVOID *context)
+{
+	(void)once;
+	(void)parameter;
+	(void)context;
+	PickKernels();
+	return TRUE;
+}
+
+static const JSON_KERNELS *SelectKernels(void)
+{
+	InitOnceExecuteOnce(&JSONkernelsOnce, PickKernelsOnce, NULL, NULL);
+	return &JSONkernels;
+}
+#else
+static pthread_once_t JSONkernelsOnce = PTHREAD_ONCE_INIT;
+
+static const JSON_KERNELS *SelectKernels(void)
+{
+	pthread_once(&JSONkernelsOnce, PickKernels);
+	return &JSONkernels;
+}
+#endif
+
+// NOTE: @Jon
+// Finds the characters escaped by an odd length run of backslashes, carrying runs over block boundaries
+static u64 FindEscaped(u64 backslash, u64 *prevEscaped)
+{
+	const u64 evenBits = 0x5555555555555555ULL;
+
+	backslash &= ~*prevEscaped;
+	const u64 followsEscape = (backslash << 1) | *prevEscaped;
+	const u64 oddSequenceStarts = backslash & ~evenBits & ~followsEscape;
+	const u64 sequencesStartingOnEvenBits = oddSequenceStarts + backslash;
+	*prevEscaped = sequencesStartingOnEvenBits < oddSequenceStarts;
+	const u64 invertMask = sequencesStartingOnEvenBits << 1;
+	return (evenBits ^ invertMask) & followsEscape;
+}
+
+// NOTE: @Jon
+// Turns a mask of quotes into a mask of everything from an opening quote up to (not including) its closer
+static u64 PrefixXor(u64 bits)
+{
+	bits ^= bits << 1;
+	bits ^= bits << 2;
+	bits ^= bits << 4;
+	bits ^= bits << 8;
+	bits ^= bits << 16;
+	bits ^= bits << 32;
+	return bits;
+}
+
+// NOTE: @Jon
+// Builds the index of token starts for the input
+// Gives back false if the input ends inside a string or memory runs out
+static bool BuildStructuralIndex(const char *input, const size_t length, const JSONLIB_Allocator *allocator, JSON_STRUCTURAL_INDEX *index)
+{
+	const JSON_CLASSIFY_BLOCK classifyBlock = SelectKernels()->classifyBlock;
+
+	// Most documents have far fewer tokens than bytes, the positions grow if this guess is short
+	index->positionCapacity = length / 4 + 64;
+	index->positionCount = 0;
+	index->allocator = allocator;
+	index->positions = (u32*)AllocateWith(allocator, sizeof(u32) * index->positionCapacity);
+	if (index->positions == NULL)
+		return false;
+
+	u64 prevEscaped = 0;
+	u64 prevInString = 0;
+	u64 prevScalar = 0;
+	for (size_t offset = 0; offset < length; offset += 64)
+	{
+		const u8 *block = (const u8*)input + offset;
+		u8 padded[64];
+		if (length - offset < 64)
+		{
+			// Whitespace never starts a token so it's safe padding for the last block
+			memset(padded, ' ', sizeof(padded));
+			memcpy(padded, block, length - offset);
+			block = padded;
+		}
+
+		JSON_BLOCK_MASKS masks;
+		classifyBlock(block, &masks);
+
+		const u64 quotes = masks.quote & ~FindEscaped(masks.backslash, &prevEscaped);
+		const u64 inString = PrefixXor(quotes) ^ prevInString;
+		prevInString = (u64)((i64)inString >> 63);
+
+		// Closing quotes are the only quotes outside the string mask, both ends of a string are indexed
+		const u64 outside = ~(inString | quotes);
+		const u64 scalar = outside & ~(masks.op | masks.whitespace);
+		const u64 scalarStarts = scalar & ~((scalar << 1) | prevScalar);
+		prevScalar = scalar >> 63;
+
+		u64 structurals = (masks.op & outside) | quotes | scalarStarts;
+
+		if (index->positionCount + 64 > index->positionCapacity)
+		{
+			u32 *expanded = (u32*)ReallocateWith(index->allocator, index->positions, sizeof(u32) * index->positionCapacity, sizeof(u32) * index->positionCapacity * 2);
+			if (expanded == NULL)
+				return false;
+			index->positions = expanded;
+			index->positionCapacity *= 2;
+		}
+
+		u32 *positions = index->positions + index->positionCount;
+		while (structurals != 0)
+		{
+			*positions++ = (u32)offset + CountTrailingZeros(structurals);
+			structurals &= structurals - 1;
+		}
+		index->positionCount = (size_t)(positions - index->positions);
+	}
+
+	return prevInString == 0;
+}
+
+static bool IsWhitespace(const char c)
+{
+	return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+static bool IsDigit(const char c)
+{
+	return c >= '0' && c <= '9';
+}
+
+static void SkipWhitespace(JSON_PARSER *parser)
+{
+	if (parser->index != NULL)
+	{
+		const char *next = parser->indexPosition < parser->indexCount ? parser->input + parser->index[parser->indexPosition++] : parser->end;
+
+		// Only whitespace can sit between tokens, anything else is left under the cursor for the caller to reject
+		if (parser->cursor == next || parser->cursor >= parser->end || IsWhitespace(*parser->cursor))
+			parser->cursor = next;
+		return;
+	}
+
+	while (parser->cursor < parser->end && IsWhitespace(*parser->cursor))
+		parser->cursor++;
+}
+
+// NOTE: @Jon
+// Pushes a node onto the stack of values waiting for their parent to be finished
+static bool ValueStackPush(JSON_DOM_BUILDER *builder, JSON *json)
+{
+	JSON_VALUE_STACK *stack = &builder->stack;
+	if (stack->valueCount >= stack->valueCapacity)
+	{
+		const JSONLIB_Allocator *allocator = builder->allocator;
+		const size_t oldNumBytes = sizeof(JSON*) * stack->valueCapacity;
+		JSON **expanded;
+		if (stack->values != builder->inlineValues)
+		{
+			expanded = (JSON**)ReallocateWith(allocator, stack->values, oldNumBytes, oldNumBytes * 2);
+		}
+		else
+		{
+			expanded = (JSON**)AllocateWith(allocator, oldNumBytes * 2);
+			if (expanded != NULL)
+				memcpy(expanded, stack->values, sizeof(JSON*) * stack->valueCount);
+		}
+		if (expanded == NULL)
+			return false;
+
+		stack->values = expanded;
+		stack->valueCapacity *= 2;
+	}
+	stack->values[stack->valueCount++] = json;
+	return true;
+}
+
+// NOTE: @Jon
+// Moves the values parsed since base off the stack into an exactly sized value array for the node
+static bool ValueStackPopInto(JSON_DOM_BUILDER *builder, JSON *json, const u32 base)
+{
+	const u32 count = builder->stack.valueCount - base;
+	if (count == 0)
+		return true;
+
+	JSON **values = (JSON**)ParseAllocate(builder->arena, builder->allocator, sizeof(JSON*) * count);
+	if (values == NULL)
+		return false;
+
+	memcpy(values, &builder->stack.values[base], sizeof(JSON*) * count);
+	json->values = values;
+	json->valueCount = count;
+	json->valueCapacity = count;
+	builder->stack.valueCount = base;
+	return true;
+}
+
+// NOTE: @Jon
+// Reads the four hex digits of a \u escape sequence
+static bool ParseHex4(const char *hex, u32 *codepoint)
+{
+	u32 value = 0;
+	for (u32 i = 0; i < 4; ++i)
+	{
+		const char c = hex[i];
+		value <<= 4;
+		if (c >= '0' && c <= '9')
+			value |= (u32)(c - '0');
+		else if (c >= 'a' && c <= 'f')
+			value |= (u32)(c - 'a' + 10);
+		else if (c >= 'A' && c <= 'F')
+			value |= (u32)(c - 'A' + 10);
+		else
+			return false;
+	}
+	*codepoint = value;
+	return true;
+}
+
+// NOTE: @Jon
+// Writes a codepoint out as UTF-8, giving back the end of what was written
+static char *EncodeUTF8(char *dest, const u32 codepoint)
+{
+	if (codepoint < 0x80)
+	{
+		*dest++ = (char)codepoint;
+	}
+	else if (codepoint < 0x800)
+	{
+		*dest++ = (char)(0xC0 | (codepoint >> 6));
+		*dest++ = (char)(0x80 | (codepoint & 0x3F));
+	}
+	else if (codepoint < 0x10000)
+	{
+		*dest++ = (char)(0xE0 | (codepoint >> 12));
+		*dest++ = (char)(0x80 | ((codepoint >> 6) & 0x3F));
+		*dest++ = (char)(0x80 | (codepoint & 0x3F));
+	}
+	else
+	{
+		*dest++ = (char)(0xF0 | (codepoint >> 18));
+		*dest++ = (char)(0x80 | ((codepoint >> 12) & 0x3F));
+		*dest++ = (char)(0x80 | ((codepoint >> 6) & 0x3F));
+		*dest++ = (char)(0x80 | (codepoint & 0x3F));
+	}
+	return dest;
+}
+
+// NOTE: @Jon
+// Decodes the escape sequences in [src, end) into dest, giving back the end of the decoded string
+// Decoding never writes past the source so dest can be the same memory as src
+// Gives back NULL for bad escape sequences and unpaired surrogates
+static char *DecodeString(char *dest, const char *src, const char *end)
+{
+	while (src < end)
+	{
+		if (*src != '\\')
+		{
+			*dest++ = *src++;
+			continue;
+		}
+
+		if (++src >= end)
+			return NULL;
+
+		switch (*src++)
+		{
+		case '"': *dest++ = '"'; break;
+		case '\\': *dest++ = '\\'; break;
+		case '/': *dest++ = '/'; break;
+		case 'b': *dest++ = '\b'; break;
+		case 'f': *dest++ = '\f'; break;
+		case 'n': *dest++ = '\n'; break;
+		case 'r': *dest++ = '\r'; break;
+		case 't': *dest++ = '\t'; break;
+		case 'u':
+		{
+			u32 codepoint = 0;
+			if (end - src < 4 || !ParseHex4(src, &codepoint))
+				return NULL;
+			src += 4;
+
+			// Characters outside the BMP come as a high surrogate followed by a low one
+			if (codepoint >= 0xD800 && codepoint <= 0xDBFF)
+			{
+				u32 low = 0;
+				if (end - src < 6 || src[0] != '\\' || src[1] != 'u' || !ParseHex4(src + 2, &low) || low < 0xDC00 || low > 0xDFFF)
+					return NULL;
+				src += 6;
+				codepoint = 0x10000 + ((codepoint - 0xD800) << 10) + (low - 0xDC00);
+			}
+			else if (codepoint >= 0xDC00 && codepoint <= 0xDFFF)
+				return NULL;
+
+			dest = EncodeUTF8(dest, codepoint);
+			break;
+		}
+		default:
+			return NULL;
+		}
+	}
+	return dest;
+}
+
+// NOTE: @Jon
+// Parses the string starting at the opening quote under the cursor, decoding any escape sequences
+// Raw control characters and malformed UTF-8 are rejected, the same scan serves names and values
+// Gives back a span of the input when there's nothing to decode (or when parsing in situ, NUL terminated),
+// otherwise the decoded string in the scratch buffer which the next string overwrites
+static const char *ParseString(JSON_PARSER *parser, u32 *stringLength)
+{
+	const char *start = ++parser->cursor;
+	const char *iter = start;
+	const char *escape = NULL;
+	bool nonASCII = false;
+	for (;;)
+	{
+		iter = (const char*)parser->kernels->scanString((const u8*)iter, (const u8*)parser->end, &nonASCII);
+		if (iter >= parser->end || *iter == '"')
+			break;
+
+		// Anything else the scan stops on is a control character, which JSON only allows escaped
+		if (*iter != '\\' || parser->end - iter < 2)
+			return NULL;
+		if (escape == NULL)
+			escape = iter;
+		iter += 2;
+	}
+
+	if (iter >= parser->end)
+		return NULL;
+
+	if (parser->index != NULL)
+	{
+		// The closing quote has its own entry in the structural index
+		if (parser->indexPosition >= parser->indexCount || parser->input + parser->index[parser->indexPosition] != iter)
+			return NULL;
+		parser->indexPosition++;
+	}
+
+	// Escapes always decode to valid UTF-8 so only the raw bytes need checking
+	if (nonASCII && !parser->kernels->validateUTF8((const u8*)start, (size_t)(iter - start)))
+		return NULL;
+
+	// Lengths are 32 bit from here on, only a string can be that long in a bigger input
+	size_t length = (size_t)(iter - start);
+	if (length > 0xFFFFFFFFu)
+		return NULL;
+	parser->cursor = iter + 1;
+
+	if (parser->flags & JSON_PARSE_IN_SITU)
+	{
+		// The caller handed over a writable buffer so the decoded string overwrites the raw one
+		char *str = (char*)start;
+		if (escape != NULL)
+		{
+			const char *decodedEnd = DecodeString(str + (escape - start), escape, iter);
+			if (decodedEnd == NULL)
+				return NULL;
+			length = (size_t)(decodedEnd - str);
+		}
+		str[length] = '\0';
+		*stringLength = (u32)length;
+		return str;
+	}
+
+	if (escape == NULL)
+	{
+		*stringLength = (u32)length;
+		return start;
+	}
+
+	// Decoding never makes a string longer
+	if (parser->scratchCapacity < length + 1)
+	{
+		size_t capacity = parser->scratchCapacity > 0 ? parser->scratchCapacity : 64;
+		while (capacity < length + 1)
+			capacity *= 2;
+
+		char *expanded = (char*)AllocateWith(parser->allocator, sizeof(char) * capacity);
+		if (expanded == NULL)
+			return NULL;
+		if (parser->scratch != NULL)
+			DeallocateWith(parser->allocator, parser->scratch, parser->scratchCapacity);
+		parser->scratch = expanded;
+		parser->scratchCapacity = capacity;
+	}
+
+	char *str = parser->scratch;
+	const size_t prefixLength = (size_t)(escape - start);
+	memcpy(str, start, sizeof(char) * prefixLength);
+	const char *decodedEnd = DecodeString(str + prefixLength, escape, iter);
+	if (decodedEnd == NULL)
+		return NULL;
+	length = (size_t)(decodedEnd - str);
+	str[length] = '\0';
+	*stringLength = (u32)length;
+	return str;
+}
+
+// NOTE: @Jon
+// Eight ASCII digits loaded as a little endian word, checked and converted without looking at each byte
+static bool IsEightDigits(const u64 word)
+{
+	return ((word & 0xF0F0F0F0F0F0F0F0ULL) | (((word + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4)) == 0x3333333333333333ULL;
+}
+
+static u32 EightDigitsValue(u64 word)
+{
+	// Pairs of digits, then pairs of pairs, are combined with one multiply each
+	const u64 mask = 0x000000FF000000FFULL;
+	const u64 hundreds = 100 + (1000000ULL << 32);
+	const u64 ones = 1 + (10000ULL << 32);
+	word -= 0x3030303030303030ULL;
+	word = (word * 10) + (word >> 8);
+	return (u32)((((word & mask) * hundreds) + (((word >> 16) & mask) * ones)) >> 32);
+}
+
+// NOTE: @Jon
+// Accumulates a run of digits onto value, which wraps if there are too many (the caller counts them)
+static const char *ParseDigits(const char *iter, const char *end, u64 *value)
+{
+	u64 accumulated = *value;
+	while (end - iter >= 8)
+	{
+		u64 word;
+		memcpy(&word, iter, sizeof(word));
+		if (!IsEightDigits(word))
+			break;
+		accumulated = accumulated * 100000000 + EightDigitsValue(word);
+		iter += 8;
+	}
+	while (iter < end && IsDigit(*iter))
+		accumulated = accumulated * 10 + (u64)(*iter++ - '0');
+
+	*value = accumulated;
+	return iter;
+}
+
+static u32 CountLeadingZeros(const u64 bits)
+{
+#if defined(_MSC_VER) && JSON_X64
+	unsigned long index;
+	_BitScanReverse64(&index, bits);
+	return 63 - (u32)index;
+#elif defined(_MSC_VER)
+	unsigned long index;
+	if (_BitScanReverse(&index, (unsigned long)(bits >> 32)))
+		return 31 - (u32)index;
+	_BitScanReverse(&index, (unsigned long)bits);
+	return 63 - (u32)index;
+#else
+	return (u32)__builtin_clzll(bits);
+#endif
+}
+
+static void Multiply128(const u64 a, const u64 b, u64 *high, u64 *low)
+{
+#if defined(_MSC_VER) && JSON_X64
+	*low = _umul128(a, b, high);
+#elif defined(__SIZEOF_INT128__)
+	const unsigned __int128 product = (unsigned __int128)a * b;
+	*high = (u64)(product >> 64);
+	*low = (u64)product;
+#else
+	// Schoolbook multiply on 32 bit halves for targets without a 64x64->128 multiply
+	const u64 aLow = (u32)a, aHigh = a >> 32;
+	const u64 bLow = (u32)b, bHigh = b >> 32;
+	const u64 lowLow = aLow * bLow;
+	const u64 highLow = aHigh * bLow;
+	const u64 lowHigh = aLow * bHigh;
+	const u64 middle = (lowLow >> 32) + (u32)highLow + (u32)lowHigh;
+	*high = aHigh * bHigh + (highLow >> 32) + (lowHigh >> 32) + (middle >> 32);
+	*low = (middle << 32) | (u32)lowLow;
+#endif
+}
+
+static f64 DoubleFromBits(const u64 bits)
+{
+	f64 value;
+	memcpy(&value, &bits, sizeof(value));
+	return value;
+}
+
+static const f64 JSONexactPowersOfTen[] =
+{
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+// NOTE: @Jon
+// Gives back the double nearest to mantissa * 10^exponent, correctly rounded (Eisel-Lemire)
+// The mantissa has to be exact, which any number of up to 19 digits is
+static f64 ComputeFloat64(const u64 mantissa, const i64 exponent)
+{
+	// Both sides fit a double exactly here so the one rounding of the multiply or divide is the right one
+	if (exponent >= -22 && exponent <= 22 && mantissa <= (1ULL << 53))
+		return exponent < 0 ? (f64)mantissa / JSONexactPowersOfTen[-exponent] : (f64)mantissa * JSONexactPowersOfTen[exponent];
+
+	if (mantissa == 0 || exponent < JSON_SMALLEST_POWER_OF_FIVE)
+		return 0.0;
+	if (exponent > JSON_LARGEST_POWER_OF_FIVE)
+		return DoubleFromBits(0x7FF0000000000000ULL);
+
+	// Normalise the mantissa then multiply by the truncated 128 bit power of five, the second word of the power is
+	// only needed when the bits under the 55 we keep are all ones and could carry
+	const u32 leadingZeros = CountLeadingZeros(mantissa);
+	const u64 normalised = mantissa << leadingZeros;
+	const u32 index = 2 * (u32)(exponent - JSON_SMALLEST_POWER_OF_FIVE);
+	u64 high, low;
+	Multiply128(normalised, JSONpowersOfFive128[index], &high, &low);
+	const u64 precisionMask = 0xFFFFFFFFFFFFFFFFULL >> 55;
+	if ((high & precisionMask) == precisionMask)
+	{
+		u64 secondHigh, secondLow;
+		Multiply128(normalised, JSONpowersOfFive128[index + 1], &secondHigh, &secondLow);
+		low += secondHigh;
+		if (secondHigh > low)
+			++high;
+	}
+
+	const u32 upperBit = (u32)(high >> 63);
+	const u32 shift = upperBit + 64 - 52 - 3;
+	u64 bits = high >> shift;
+
+	// floor(exponent * log2(10)) + 63, with the exponent bias added on
+	i32 power2 = (i32)((((152170 + 65536) * (i32)exponent) >> 16) + 63) + (i32)upperBit - (i32)leadingZeros + 1023;
+	if (power2 <= 0)
+	{
+		// Subnormal, which can round up into the smallest normal
+		if (-power2 + 1 >= 64)
+			return 0.0;
+		bits >>= -power2 + 1;
+		bits += bits & 1;
+		bits >>= 1;
+		power2 = bits < (1ULL << 52) ? 0 : 1;
+		return DoubleFromBits(bits | ((u64)power2 << 52));
+	}
+
+	// Exactly halfway between two doubles can only happen for small exponents, those round to even
+	if (low <= 1 && exponent >= -4 && exponent <= 23 && (bits & 3) == 1 && (bits << shift) == high)
+		bits &= ~1ULL;
+
+	bits += bits & 1;
+	bits >>= 1;
+	if (bits >= (2ULL << 52))
+	{
+		bits = 1ULL << 52;
+		++power2;
+	}
+	bits &= ~(1ULL << 52);
+	if (power2 >= 0x7FF)
+		return DoubleFromBits(0x7FF0000000000000ULL);
+
+	return DoubleFromBits(bits | ((u64)power2 << 52));
+}
+
+// NOTE: @Jon
+// Unsigned big integer with its 32 bit limbs least significant first, count is 0 for zero and never has a top limb of 0
+typedef struct JSON_BIG_INTEGER
+{
+	u32 limbs[JSON_BIG_INTEGER_LIMBS];
+	u32 count;
+} JSON_BIG_INTEGER;
+
+// NOTE: @Jon
+// big = big * factor + addend, giving back false if it outgrows its limbs
+static bool BigMultiplyAdd(JSON_BIG_INTEGER *big, const u32 factor, const u32 addend)
+{
+	u64 carry = addend;
+	for (u32 i = 0; i < big->count; ++i)
+	{
+		const u64 product = (u64)big->limbs[i] * factor + carry;
+		big->limbs[i] = (u32)product;
+		carry = product >> 32;
+	}
+	if (carry == 0)
+		return true;
+	if (big->count == JSON_BIG_INTEGER_LIMBS)
+		return false;
+	big->limbs[big->count++] = (u32)carry;
+	return true;
+}
+
+static bool BigMultiplyPowerOfFive(JSON_BIG_INTEGER *big, u32 power)
+{
+	// 5^13 is the biggest power of five that fits a limb
+	static const u32 powersOfFive[] =
+	{
+		1, 5, 25, 125, 625, 3125, 15625, 78125, 390625, 1953125, 9765625, 48828125, 244140625, 1220703125
+	};
+	for (; power >= 13; power -= 13)
+	{
+		if (!BigMultiplyAdd(big, powersOfFive[13], 0))
+			return false;
+	}
+	return BigMultiplyAdd(big, powersOfFive[power], 0);
+}
+
+static bool BigShiftLeft(JSON_BIG_INTEGER *big, const u32 shift)
+{
+	const u32 words = shift / 32;
+	const u32 bits = shift % 32;
+	if (big->count == 0)
+		return true;
+
+	if (bits != 0)
+	{
+		u32 carry = 0;
+		for (u32 i = 0; i < big->count; ++i)
+		{
+			const u32 limb = big->limbs[i];
+			big->limbs[i] = (limb << bits) | carry;
+			carry = limb >> (32 - bits);
+		}
+		if (carry != 0)
+		{
+			if (big->count == JSON_BIG_INTEGER_LIMBS)
+				return false;
+			big->limbs[big->count++] = carry;
+		}
+	}
+
+	if (words != 0)
+	{
+		if (words > JSON_BIG_INTEGER_LIMBS - big->count)
+			return false;
+		memmove(&big->limbs[words], big->limbs, sizeof(u32) * big->count);
+		memset(big->limbs, 0, sizeof(u32) * words);
+		big->count += words;
+	}
+	return true;
+}
+
+static i32 BigCompare(const JSON_BIG_INTEGER *a, const JSON_BIG_INTEGER *b)
+{
+	if (a->count != b->count)
+		return a->count > b->count ? 1 : -1;
+	for (u32 i = a->count; i > 0; --i)
+	{
+		if (a->limbs[i - 1] != b->limbs[i - 1])
+			return a->limbs[i - 1] > b->limbs[i - 1] ? 1 : -1;
+	}
+	return 0;
+}
+
+// NOTE: @Jon
+// Converts the magnitude of a number with more than 19 significant digits, the first 19 nearly always settle the rounding
+// on their own. When they don't, the digits are compared exactly against the point halfway between the two doubles
+// it could be. No double's halfway point has more than 767 significant digits, so past 768 of them any other digit
+// only matters for being nonzero. Gives back false if the comparison outgrew its big integers, which it shouldn't.
+static bool ParseLongDecimal(const char *digits, const char *digitsEnd, const i64 exponent, f64 *value)
+{
+	u64 mantissa = 0;
+	u32 kept = 0;
+	i64 exponent10 = exponent;
+	bool truncated = false;
+	bool fraction = false;
+	for (const char *digit = digits; digit < digitsEnd; ++digit)
+	{
+		if (*digit == '.')
+		{
+			fraction = true;
+			continue;
+		}
+
+		if (kept < 19 && (kept > 0 || *digit != '0'))
+		{
+			mantissa = mantissa * 10 + (u64)(*digit - '0');
+			++kept;
+		}
+		else if (kept > 0)
+		{
+			truncated |= *digit != '0';
+			++exponent10;
+		}
+
+		if (fraction)
+			--exponent10;
+	}
+
+	const f64 lower = ComputeFloat64(mantissa, exponent10);
+	*value = lower;
+	if (!truncated || lower == ComputeFloat64(mantissa + 1, exponent10))
+		return true;
+
+	// The digits again, this time as many as can matter, in a big integer with exponent10 scaling it
+	JSON_BIG_INTEGER big;
+	big.count = 0;
+	kept = 0;
+	exponent10 = exponent;
+	truncated = false;
+	fraction = false;
+	u32 chunk = 0;
+	u32 chunkScale = 1;
+	for (const char *digit = digits; digit < digitsEnd; ++digit)
+	{
+		if (*digit == '.')
+		{
+			fraction = true;
+			continue;
+		}
+
+		if (kept < JSON_MAX_DECIMAL_DIGITS && (kept > 0 || *digit != '0'))
+		{
+			// Nine digits go in at a time
+			chunk = chunk * 10 + (u32)(*digit - '0');
+			chunkScale *= 10;
+			if (chunkScale == 1000000000)
+			{
+				if (!BigMultiplyAdd(&big, chunkScale, chunk))
+					return false;
+				chunk = 0;
+				chunkScale = 1;
+			}
+			++kept;
+		}
+		else if (kept > 0)
+		{
+			truncated |= *digit != '0';
+			++exponent10;
+		}
+
+		if (fraction)
+			--exponent10;
+	}
+	if (chunkScale > 1 && !BigMultiplyAdd(&big, chunkScale, chunk))
+		return false;
+
+	// The halfway point above lower is (2 * its significand + 1) * 2^(its exponent - 1)
+	u64 bits;
+	memcpy(&bits, &lower, sizeof(bits));
+	const u64 biased = bits >> 52;
+	const u64 significand = biased == 0 ? bits & ((1ULL << 52) - 1) : (bits & ((1ULL << 52) - 1)) | (1ULL << 52);
+	const i64 exponent2 = (biased == 0 ? -1074 : (i64)biased - 1075) - 1;
+	const u64 halfway = 2 * significand + 1;
+
+	JSON_BIG_INTEGER half;
+	half.limbs[0] = (u32)halfway;
+	half.limbs[1] = (u32)(halfway >> 32);
+	half.count = half.limbs[1] != 0 ? 2 : 1;
+
+	// digits * 5^e10 * 2^e10 against halfway * 2^e2, with the fives moved to whichever side keeps them whole
+	// and both sides shifted so the smaller power of two is gone
+	i64 digits2 = exponent10;
+	i64 half2 = exponent2;
+	if (exponent10 >= 0 && !BigMultiplyPowerOfFive(&big, (u32)exponent10))
+		return false;
+	if (exponent10 < 0)
+	{
+		if (!BigMultiplyPowerOfFive(&half, (u32)-exponent10))
+			return false;
+		half2 -= exponent10;
+		digits2 = 0;
+	}
+	const i64 smaller = digits2 < half2 ? digits2 : half2;
+	if (!BigShiftLeft(&big, (u32)(digits2 - smaller)) || !BigShiftLeft(&half, (u32)(half2 - smaller)))
+		return false;
+
+	// Exactly halfway rounds to the even one of the two
+	const i32 order = BigCompare(&big, &half);
+	if (order > 0 || (order == 0 && truncated) || (order == 0 && (significand & 1) != 0))
+		*value = DoubleFromBits(bits + 1);
+	return true;
+}
+
+// NOTE: @Jon
+// Hands a parsed integer to the handler, anything that fits an i64 goes to integer
+static bool EmitUnsigned(JSON_PARSER *parser, const u64 integer)
+{
+	if (integer <= 0x7FFFFFFFFFFFFFFFULL)
+		return parser->handler->integer == NULL || parser->handler->integer(parser->user, (i64)integer);
+	return parser->handler->unsignedInteger == NULL || parser->handler->unsignedInteger(parser->user, integer);
+}
+
+// NOTE: @Jon
+// Parses a number following the JSON grammar in place, giving it to the handler as an integer unless it has
+// a fraction or exponent (or doesn't fit in 64 bits)
+static bool ParseNumber(JSON_PARSER *parser)
+{
+	const char *start = parser->cursor;
+	const char *iter = start;
+	const char *end = parser->end;
+
+	const bool negative = iter < end && *iter == '-';
+	if (negative)
+		++iter;
+	if (iter >= end || !IsDigit(*iter))
+		return false;
+
+	const char *integerStart = iter;
+	u64 mantissa = 0;
+	if (*iter == '0')
+		++iter;
+	else
+		iter = ParseDigits(iter, end, &mantissa);
+	const char *integerEnd = iter;
+
+	bool decimal = false;
+	const char *fractionStart = iter;
+	const char *fractionEnd = iter;
+	if (iter < end && *iter == '.')
+	{
+		decimal = true;
+		fractionStart = ++iter;
+		iter = ParseDigits(iter, end, &mantissa);
+		if (iter == fractionStart)
+			return false;
+		fractionEnd = iter;
+	}
+
+	i64 exponent = 0;
+	if (iter < end && (*iter == 'e' || *iter == 'E'))
+	{
+		decimal = true;
+		bool negativeExponent = false;
+		if (++iter < end && (*iter == '+' || *iter == '-'))
+			negativeExponent = *iter++ == '-';
+		if (iter >= end || !IsDigit(*iter))
+			return false;
+		while (iter < end && IsDigit(*iter))
+		{
+			// Past this the value is already zero or infinity whatever the other digits are
+			if (exponent < 0x10000000)
+				exponent = exponent * 10 + (*iter - '0');
+			++iter;
+		}
+		if (negativeExponent)
+			exponent = -exponent;
+	}
+
+	parser->cursor = iter;
+
+	// Leading zeros aren't significant, and up to 19 significant digits always fit the mantissa
+	size_t digitCount = (size_t)(integerEnd - integerStart) + (size_t)(fractionEnd - fractionStart);
+	if (digitCount > 19)
+	{
+		for (const char *digit = integerStart; digit < fractionEnd && (*digit == '0' || *digit == '.'); ++digit)
+			digitCount -= *digit == '0';
+	}
+
+	if (!decimal)
+	{
+		if (digitCount <= 19 && !negative)
+			return EmitUnsigned(parser, mantissa);
+		if (digitCount <= 19 && mantissa <= (1ULL << 63))
+		{
+			const i64 integer = mantissa == (1ULL << 63) ? (-0x7FFFFFFFFFFFFFFFLL - 1) : -(i64)mantissa;
+			return parser->handler->integer == NULL || parser->handler->integer(parser->user, integer);
+		}
+		if (digitCount == 20 && !negative)
+		{
+			// Twenty digits can still fit an unsigned 64 bit integer
+			u64 value = 0;
+			const char *digit = integerStart;
+			for (; digit < integerEnd && value <= (0xFFFFFFFFFFFFFFFFULL - (u64)(*digit - '0')) / 10; ++digit)
+				value = value * 10 + (u64)(*digit - '0');
+			if (digit == integerEnd)
+				return EmitUnsigned(parser, value);
+		}
+	}
+
+	f64 value = 0.0;
+	if (digitCount <= 19)
+		value = ComputeFloat64(mantissa, exponent - (fractionEnd - fractionStart));
+	else if (!ParseLongDecimal(integerStart, fractionEnd, exponent, &value))
+		return false;
+
+	// Numbers too big for a double are turned away rather than becoming infinity
+	if (value == DoubleFromBits(0x7FF0000000000000ULL))
+		return false;
+	return parser->handler->decimal == NULL || parser->handler->decimal(parser->user, negative ? -value : value);
+}
+
+// NOTE: @Jon
+// Consumes the given literal (true, false or null) if it is under the cursor
+static bool ParseLiteral(JSON_PARSER *parser, const char *literal, const size_t literalLength)
+{
+	if ((size_t)(parser->end - parser->cursor) < literalLength || memcmp(parser->cursor, literal, literalLength) != 0)
+		return false;
+	parser->cursor += literalLength;
+	return true;
+}
+
+static bool ParseObject(JSON_PARSER *parser);
+static bool ParseArray(JSON_PARSER *parser);
+
+// NOTE: @Jon
+// Parses the value under the cursor, handing it to the handler
+static bool ParseValue(JSON_PARSER *parser)
+{
+	if (parser->cursor >= parser->end)
+		return false;
+
+	const JSONLIB_Handler *handler = parser->handler;
+	switch (*parser->cursor)
+	{
+	case '{':
+		return ParseObject(parser);
+	case '[':
+		return ParseArray(parser);
+	case '"':
+	{
+		u32 length = 0;
+		const char *str = ParseString(parser, &length);
+		if (str == NULL)
+			return false;
+		return handler->string == NULL || handler->string(parser->user, str, length);
+	}
+	case 't':
+	case 'f':
+	{
+		const bool boolean = *parser->cursor == 't';
+		if (!ParseLiteral(parser, boolean ? JSONtrueStr : JSONfalseStr, boolean ? 4 : 5))
+			return false;
+		return handler->boolean == NULL || handler->boolean(parser->user, boolean);
+	}
+	case 'n':
+		if (!ParseLiteral(parser, JSONnullStr, 4))
+			return false;
+		return handler->null == NULL || handler->null(parser->user);
+	default:
+		return ParseNumber(parser);
+	}
+}
+
+// NOTE: @Jon
+// Parses the members of an object up to its closing brace, which is left under the cursor
+// A closer of '\0' parses members up to the end of the input instead, as in one slice of a bigger object
+static bool ParseMembers(JSON_PARSER *parser, const char closer, u32 *memberCount)
+{
+	const JSONLIB_Handler *handler = parser->handler;
+	for (;;)
+	{
+		if (parser->cursor >= parser->end || *parser->cursor != '"')
+			return false;
+
+		u32 nameLength = 0;
+		const char *name = ParseString(parser, &nameLength);
+		if (name == NULL)
+			return false;
+		if (handler->key != NULL && !handler->key(parser->user, name, nameLength))
+			return false;
+
+		SkipWhitespace(parser);
+		if (parser->cursor >= parser->end || *parser->cursor != ':')
+			return false;
+		parser->cursor++;
+		SkipWhitespace(parser);
+
+		// Counts are 32 bit like a node's, so a container with more values than that is turned away
+		if (!ParseValue(parser) || ++(*memberCount) == 0)
+			return false;
+
+		SkipWhitespace(parser);
+		if (parser->cursor >= parser->end)
+			return closer == '\0';
+
+		if (*parser->cursor == closer)
+			return true;
+		if (*parser->cursor != ',')
+			return false;
+
+		parser->cursor++;
+		SkipWhitespace(parser);
+	}
+}
+
+// NOTE: @Jon
+// Parses the elements of an array the same way
+static bool ParseElements(JSON_PARSER *parser, const char closer, u32 *elementCount)
+{
+	for (;;)
+	{
+		if (!ParseValue(parser) || ++(*elementCount) == 0)
+			return false;
+
+		SkipWhitespace(parser);
+		if (parser->cursor >= parser->end)
+			return closer == '\0';
+
+		if (*parser->cursor == closer)
+			return true;
+		if (*parser->cursor != ',')
+			return false;
+
+		parser->cursor++;
+		SkipWhitespace(parser);
+	}
+}
+
+// NOTE: @Jon
+// Parses an object, the cursor should be on the opening brace
+static bool ParseObject(JSON_PARSER *parser)
+{
+	const JSONLIB_Handler *handler = parser->handler;
+	if (++parser->depth > JSON_MAX_PARSE_DEPTH)
+		return false;
+	if (handler->startObject != NULL && !handler->startObject(parser->user))
+		return false;
+
+	u32 memberCount = 0;
+	parser->cursor++;
+	SkipWhitespace(parser);
+
+	if (parser->cursor < parser->end && *parser->cursor == '}')
+	{
+		parser->cursor++;
+		parser->depth--;
+		return handler->endObject == NULL || handler->endObject(parser->user, 0);
+	}
+
+	if (!ParseMembers(parser, '}', &memberCount))
+		return false;
+
+	parser->cursor++;
+	parser->depth--;
+	return handler->endObject == NULL || handler->endObject(parser->user, memberCount);
+}
+
+// NOTE: @Jon
+// Parses an array, the cursor should be on the opening bracket
+static bool ParseArray(JSON_PARSER *parser)
+{
+	const JSONLIB_Handler *handler = parser->handler;
+	if (++parser->depth > JSON_MAX_PARSE_DEPTH)
+		return false;
+	if (handler->startArray != NULL && !handler->startArray(parser->user))
+		return false;
+
+	u32 elementCount = 0;
+	parser->cursor++;
+	SkipWhitespace(parser);
+
+	if (parser->cursor < parser->end && *parser->cursor == ']')
+	{
+		parser->cursor++;
+		parser->depth--;
+		return handler->endArray == NULL || handler->endArray(parser->user, 0);
+	}
+
+	if (!ParseElements(parser, ']', &elementCount))
+		return false;
+
+	parser->cursor++;
+	parser->depth--;
+	return handler->endArray == NULL || handler->endArray(parser->user, elementCount);
+}
+
+// NOTE: @Jon
+// Parses a whole document, handing every token to the handler
+// With sliceTags the input is instead a run of members (JSON_OBJECT_TAG) or elements (JSON_ARRAY_TAG)
+// cut out of the root container, without its brackets
+// Gives back false if the document is malformed or a handler stopped the parse
+// Temporary buffers come from the given allocator
+static bool ParseSAXInternal(const char *jsonString, size_t stringLength, u32 flags, const JSONLIB_Handler *handler, void *user, const u16 sliceTags, const JSONLIB_Allocator *allocator)
+{
+	JSON_PARSER parser;
+	parser.input = jsonString;
+	parser.cursor = jsonString;
+	parser.end = jsonString + stringLength;
+	parser.index = NULL;
+	parser.indexPosition = 0;
+	parser.indexCount = 0;
+	parser.kernels = SelectKernels();
+	parser.handler = handler;
+	parser.user = user;
+	parser.allocator = allocator;
+	parser.scratch = NULL;
+	parser.scratchCapacity = 0;
+	parser.flags = flags;
+	parser.depth = 0;
+
+	// The positions are 32 bit so inputs past 4GB are parsed without an index
+	JSON_STRUCTURAL_INDEX structuralIndex;
+	structuralIndex.positions = NULL;
+	if ((flags & JSON_PARSE_STRUCTURAL_INDEX) && stringLength <= 0xFFFFFFFFu)
+	{
+		if (!BuildStructuralIndex(jsonString, stringLength, allocator, &structuralIndex))
+		{
+			if (structuralIndex.positions != NULL)
+				DeallocateWith(allocator, structuralIndex.positions, sizeof(u32) * structuralIndex.positionCapacity);
+			return false;
+		}
+		parser.index = structuralIndex.positions;
+		parser.indexCount = structuralIndex.positionCount;
+	}
+
+	SkipWhitespace(&parser);
+	bool parsed = false;
+	if (sliceTags == 0)
+	{
+		parsed = ParseValue(&parser);
+		SkipWhitespace(&parser);
+	}
+	else
+	{
+		// A slice sits one level down, inside the root container
+		u32 valueCount = 0;
+		parser.depth = 1;
+		if (sliceTags == JSON_OBJECT_TAG)
+			parsed = ParseMembers(&parser, '\0', &valueCount);
+		else
+			parsed = ParseElements(&parser, '\0', &valueCount);
+	}
+	parsed = parsed && parser.cursor == parser.end;
+
+	if (parser.scratch != NULL)
+		DeallocateWith(allocator, parser.scratch, parser.scratchCapacity);
+
+	if (structuralIndex.positions != NULL)
+		DeallocateWith(allocator, structuralIndex.positions, sizeof(u32) * structuralIndex.positionCapacity);
+
+	return parsed;
+}
+
+// NOTE: @Jon
+// Tree building handler
+// Every value becomes a node pushed onto the value stack, and a container's end moves its children
+// (the last memberCount nodes) off the stack into it
+
+// NOTE: @Jon
+// Copies a string or name for a node, or points at the input when it's allowed to borrow it
+static const char *KeepString(JSON_DOM_BUILDER *builder, const char *str, const u32 length, bool *borrowed)
+{
+	// Only spans of the input can be borrowed, decoded strings live in the parser's scratch buffer
+	*borrowed = (builder->flags & (JSON_PARSE_BORROW_STRINGS | JSON_PARSE_IN_SITU)) && str >= builder->input && str < builder->end;
+	if (*borrowed)
+		return str;
+
+	char *copy = (char*)ParseAllocate(builder->arena, builder->allocator, sizeof(char) * (length + 1));
+	if (copy == NULL)
+		return NULL;
+	memcpy(copy, str, sizeof(char) * length);
+	copy[length] = '\0';
+	return copy;
+}
+
+// NOTE: @Jon
+// Makes the node for the next value, taking the name from the key before it
+static JSON *BuildNode(JSON_DOM_BUILDER *builder, const u16 tags)
+{
+	JSON *json = ParseAllocateNode(builder->arena, builder->pool, builder->nodeAllocator, builder->current);
+	if (json == NULL)
+		return NULL;
+
+	json->tags = tags;
+	json->name = builder->name;
+	json->nameLength = builder->nameLength;
+	if (builder->name != NULL && builder->nameBorrowed)
+		json->flags |= JSON_BORROWED_NAME_FLAG;
+	builder->name = NULL;
+
+	if (!ValueStackPush(builder, json))
+	{
+		JSONLIB_FreeJSON(json);
+		return NULL;
+	}
+	return json;
+}
+
+static bool BuildKey(void *user, const char *name, u32 nameLength)
+{
+	JSON_DOM_BUILDER *builder = (JSON_DOM_BUILDER*)user;
+
+	// Interned names belong to their table, so the nodes treat them like borrowed ones and never free them
+	if (builder->names != NULL)
+	{
+		builder->name = JSONLIB_InternName(builder->names, name, nameLength);
+		builder->nameBorrowed = true;
+		builder->nameLength = nameLength;
+		return builder->name != NULL;
+	}
+
+	builder->name = KeepString(builder, name, nameLength, &builder->nameBorrowed);
+	builder->nameLength = nameLength;
+	return builder->name != NULL;
+}
+
+static bool BuildStart(void *user, const u16 tags)
+{
+	JSON_DOM_BUILDER *builder = (JSON_DOM_BUILDER*)user;
+	JSON *json = BuildNode(builder, tags);
+	if (json == NULL)
+		return false;
+	builder->current = json;
+	return true;
+}
+
+static bool BuildEnd(void *user, u32 valueCount)
+{
+	JSON_DOM_BUILDER *builder = (JSON_DOM_BUILDER*)user;
+	JSON *json = builder->current;
+	builder->current = json->parent;
+	if (!ValueStackPopInto(builder, json, builder->stack.valueCount - valueCount))
+		return false;
+
+	// Big objects are indexed as they're parsed, an object without an index is still searchable
+	if (HasTags(json, JSON_OBJECT_TAG) && valueCount >= JSON_MIN_INDEXED_MEMBER_COUNT)
+		IndexMembers(json, builder->arena);
+	return true;
+}
+
+static bool BuildStartObject(void *user)
+{
+	return BuildStart(user, JSON_OBJECT_TAG);
+}
+
+static bool BuildStartArray(void *user)
+{
+	return BuildStart(user, JSON_ARRAY_TAG);
+}
+
+static bool BuildStringValue(void *user, const char *string, u32 stringLength)
+{
+	JSON_DOM_BUILDER *builder = (JSON_DOM_BUILDER*)user;
+	JSON *json = BuildNode(builder, JSON_STRING_TAG);
+	if (json == NULL)
+		return false;
+
+	bool borrowed = false;
+	json->string = KeepString(builder, string, stringLength, &borrowed);
+	json->stringLength = stringLength;
+	if (borrowed)
+		json->flags |= JSON_BORROWED_STRING_FLAG;
+	// A node that never got its string isn't a string node, so nothing tries to free it
+	if (json->string == NULL)
+		json->tags = 0;
+	return json->string != NULL;
+}
+
+static bool BuildInteger(void *user, i64 integer)
+{
+	JSON *json = BuildNode((JSON_DOM_BUILDER*)user, 0);
+	if (json == NULL)
+		return false;
+	SetInteger64(json, integer);
+	return true;
+}
+
+static bool BuildUnsigned(void *user, u64 integer)
+{
+	JSON *json = BuildNode((JSON_DOM_BUILDER*)user, 0);
+	if (json == NULL)
+		return false;
+	SetUnsigned64(json, integer);
+	return true;
+}
+
+static bool BuildDecimal(void *user, f64 decimal)
+{
+	JSON *json = BuildNode((JSON_DOM_BUILDER*)user, 0);
+	if (json == NULL)
+		return false;
+	SetDecimal64(json, decimal);
+	return true;
+}
+
+static bool BuildBoolean(void *user, bool boolean)
+{
+	JSON *json = BuildNode((JSON_DOM_BUILDER*)user, JSON_BOOLEAN_TAG);
+	if (json == NULL)
+		return false;
+	json->boolean = boolean;
+	return true;
+}
+
+static bool BuildNull(void *user)
+{
+	return BuildNode((JSON_DOM_BUILDER*)user, JSON_NULL_TAG) != NULL;
+}
+
+static const JSONLIB_Handler JSONdomHandler =
+{
+	BuildStartObject, BuildEnd, BuildStartArray, BuildEnd, BuildKey, BuildStringValue,
+	BuildInteger, BuildUnsigned, BuildDecimal, BuildBoolean, BuildNull
+};
+// NOTE: @Jon
+// Sets the allocation functions for the library to use internally
+void JSONLIB_SetAllocator(JSON_ALLOC alloc, JSON_DEALLOC dealloc)
+{
+	JSONlegacyAllocate = alloc;
+	JSONlegacyDeallocate = dealloc;
+	JSONallocator = JSONlegacyAllocator;
+}
+
+// NOTE: @Jon
+// Sets the allocator the library uses when it isn't given one, NULL goes back to malloc and free
+void JSONLIB_SetAllocatorEx(const JSONLIB_Allocator *allocator)
+{
+	if (allocator == NULL)
+		JSONLIB_SetAllocator(malloc, free);
+	else
+		JSONallocator = *allocator;
+}
+
+static void InitDOMBuilder(JSON_DOM_BUILDER *builder, const char *input, size_t inputLength, u32 flags, JSONLIB_Arena *arena)
+{
+	builder->input = input;
+	builder->end = input + inputLength;
+	builder->arena = arena;
+	builder->pool = JSONnodePool;
+	builder->nodeAllocator = JSONthreadAllocator;
+	builder->allocator = arena != NULL ? &arena->allocator : NodeSourceAllocator(JSONnodePool, JSONthreadAllocator);
+	builder->stack.values = builder->inlineValues;
+	builder->stack.valueCount = 0;
+	builder->stack.valueCapacity = JSON_DEFAULT_VALUE_STACK_SIZE;
+	builder->current = NULL;
+	builder->name = NULL;
+	builder->nameLength = 0;
+	builder->nameBorrowed = false;
+	builder->flags = flags;
+	builder->names = NULL;
+}
+
+// NOTE: @Jon
+// Gives back the finished tree, or frees everything built so far when the parse failed
+static JSON *FinishDOMBuilder(JSON_DOM_BUILDER *builder, const bool parsed)
+{
+	JSON *json = NULL;
+	if (parsed)
+	{
+		assert(builder->stack.valueCount == 1);
+		json = builder->stack.values[0];
+	}
+	else
+	{
+		// A name is only left over when its value never got a node
+		if (builder->name != NULL && !builder->nameBorrowed)
+			ParseDeallocate(builder->arena, builder->allocator, (void*)builder->name, sizeof(char) * (builder->nameLength + 1));
+		builder->name = NULL;
+
+		// Everything still on the stack is either finished or has no values yet, so freeing
+		// them newest first releases each node exactly once
+		for (u32 i = builder->stack.valueCount; i > 0; --i)
+			JSONLIB_FreeJSON(builder->stack.values[i - 1]);
+	}
+	builder->stack.valueCount = 0;
+
+	if (builder->stack.values != builder->inlineValues)
+		DeallocateWith(builder->allocator, builder->stack.values, sizeof(JSON*) * builder->stack.valueCapacity);
+	builder->stack.values = builder->inlineValues;
+	builder->stack.valueCapacity = JSON_DEFAULT_VALUE_STACK_SIZE;
+
+	return json;
+}
+
+// NOTE: @Jon
+// Parses a JSON string with the given flags, placing the tree in the arena if one is given
+static JSON *ParseJSONInternal(const char *jsonString, size_t stringLength, u32 flags, JSONLIB_Arena *arena)
+{
+	JSON_DOM_BUILDER builder;
+	InitDOMBuilder(&builder, jsonString, stringLength, flags, arena);
+	const bool parsed = ParseSAXInternal(jsonString, stringLength, flags, &JSONdomHandler, &builder, 0, builder.allocator);
+	return FinishDOMBuilder(&builder, parsed);
+}
+
+// NOTE: @Jon
+// Parses a JSON string, handing each token to the handler instead of building a tree
+bool JSONLIB_ParseSAX(const char *jsonString, size_t stringLength, const JSONLIB_Handler *handler, void *user)
+{
+	return ParseSAXInternal(jsonString, stringLength, 0, handler, user, 0, CurrentAllocator());
+}
+
+// NOTE: @Jon
+// Parses a JSON string
+JSON *JSONLIB_ParseJSON(const char *jsonString, size_t stringLength)
+{
+	return ParseJSONInternal(jsonString, stringLength, 0, NULL);
+}
+
+// NOTE: @Jon
+// Parses a JSON string with the given flags, placing the tree in the arena if one is given
+JSON *JSONLIB_ParseJSONEx(const char *jsonString, size_t stringLength, u32 flags, JSONLIB_Arena *arena)
+{
+	return ParseJSONInternal(jsonString, stringLength, flags & ~JSON_PARSE_IN_SITU, arena);
+}
+
+// NOTE: @Jon
+// Parses a JSON string, taking every name from the name table instead of copying it
+JSON *JSONLIB_ParseJSONInterned(const char *jsonString, size_t stringLength, u32 flags, JSONLIB_Arena *arena, JSONLIB_NameTable *names)
+{
+	assert(names != NULL);
+
+	JSON_DOM_BUILDER builder;
+	InitDOMBuilder(&builder, jsonString, stringLength, flags & ~JSON_PARSE_IN_SITU, arena);
+	builder.names = names;
+	const bool parsed = ParseSAXInternal(jsonString, stringLength, flags & ~JSON_PARSE_IN_SITU, &JSONdomHandler, &builder, 0, builder.allocator);
+	return FinishDOMBuilder(&builder, parsed);
+}
+
+// NOTE: @Jon
+// Parses a writable JSON buffer, decoding names and strings in place
+JSON *JSONLIB_ParseJSONInSitu(char *buffer, size_t bufferLength)
+{
+	return ParseJSONInternal(buffer, bufferLength, JSON_PARSE_IN_SITU, NULL);
+}
+
+// NOTE: @Jon
+// Parsing files
+// Files are mapped rather than read so there's no copy of the input, and nothing in the parser limits it to 4GB
+
+// NOTE: @Jon
+// Maps a whole file read only, an empty file can't be mapped
+// Files read front to back are mapped with a hint to read ahead, the rest are left to be read in any order
+#if defined(_WIN32)
+static bool MapFile(const char *path, const bool sequential, JSON_FILE_MAPPING *mapping)
+{
+	mapping->file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+		sequential ? FILE_FLAG_SEQUENTIAL_SCAN : FILE_FLAG_RANDOM_ACCESS, NULL);
+	if (mapping->file == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(mapping->file, &size) || size.QuadPart <= 0 || (u64)size.QuadPart > (u64)SIZE_MAX)
+	{
+		CloseHandle(mapping->file);
+		return false;
+	}
+
+	mapping->mapping = CreateFileMappingA(mapping->file, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (mapping->mapping == NULL)
+	{
+		CloseHandle(mapping->file);
+		return false;
+	}
+
+	mapping->data = (const char*)MapViewOfFile(mapping->mapping, FILE_MAP_READ, 0, 0, 0);
+	if (mapping->data == NULL)
+	{
+		CloseHandle(mapping->mapping);
+		CloseHandle(mapping->file);
+		return false;
+	}
+	mapping->length = (size_t)size.QuadPart;
+	return true;
+}
+
+static void UnmapFile(JSON_FILE_MAPPING *mapping)
+{
+	UnmapViewOfFile(mapping->data);
+	CloseHandle(mapping->mapping);
+	CloseHandle(mapping->file);
+	mapping->data = NULL;
+	mapping->length = 0;
+}
+#else
+static bool MapFile(const char *path, const bool sequential, JSON_FILE_MAPPING *mapping)
+{
+	const int file = open(path, O_RDONLY);
+	if (file < 0)
+		return false;
+
+	struct stat info;
+	if (fstat(file, &info) != 0 || info.st_size <= 0 || (u64)info.st_size > (u64)SIZE_MAX)
+	{
+		close(file);
+		return false;
+	}
+
+	// The mapping keeps the file alive on its own
+	void *data = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+	close(file);
+	if (data == MAP_FAILED)
+		return false;
+	if (sequential)
+		posix_madvise(data, (size_t)info.st_size, POSIX_MADV_SEQUENTIAL);
+
+	mapping->data = (const char*)data;
+	mapping->length = (size_t)info.st_size;
+	return true;
+}
+
+static void UnmapFile(JSON_FILE_MAPPING *mapping)
+{
+	munmap((void*)mapping->data, mapping->length);
+	mapping->data = NULL;
+	mapping->length = 0;
+}
+#endif
+
+// NOTE: @Jon
+// Parses a JSON file, mapped for as long as the parse takes
+JSON *JSONLIB_ParseFile(const char *path, u32 flags)
+{
+	if (path == NULL)
+		return NULL;
+
+	JSON_FILE_MAPPING mapping;
+	if (!MapFile(path, true, &mapping))
+		return NULL;
+
+	// Nothing can borrow from the mapping since it's gone once the tree is built
+	JSON *json = ParseJSONInternal(mapping.data, mapping.length, flags & ~(JSON_PARSE_BORROW_STRINGS | JSON_PARSE_IN_SITU), NULL);
+	UnmapFile(&mapping);
+	return json;
+}
+
+// NOTE: @Jon
+// Tapes
+// A read only form of a document as one flat array of 64 bit words, built from parse events like a tree.
+// The top byte of a word is its JSON_TAPE_TYPE and the rest its payload. Containers hold the position of their
+// closing word (and their child count above it) so whole subtrees can be skipped in one step, numbers keep
+// their value in the word after, and keys and strings hold the offset of their length prefixed bytes in a
+// separate string buffer.
+
+static u64 TapeWord(const JSON_TAPE_TYPE type, const u64 payload)
+{
+	return ((u64)type << 56) | payload;
+}
+
+static JSON_TAPE_TYPE TapeType(const u64 word)
+{
+	return (JSON_TAPE_TYPE)(word >> 56);
+}
+
+static u64 TapePayload(const u64 word)
+{
+	return word & 0x00FFFFFFFFFFFFFFULL;
+}
+
+// NOTE: @Jon
+// Makes room for count more words on the tape
+// Positions on the tape are 32 bit, so a document that needs more words than that fails
+static bool ReserveTapeWords(JSONLIB_Tape *tape, const u32 count)
+{
+	const u64 needed = (u64)tape->wordCount + count;
+	if (needed <= tape->wordCapacity)
+		return true;
+	if (needed > JSON_MAX_TAPE_WORDS)
+		return false;
+
+	u64 capacity = tape->wordCapacity > 0 ? (u64)tape->wordCapacity * 2 : JSON_MIN_TAPE_WORDS;
+	while (capacity < needed)
+		capacity *= 2;
+	if (capacity > JSON_MAX_TAPE_WORDS)
+		capacity = JSON_MAX_TAPE_WORDS;
+	if (capacity > SIZE_MAX / sizeof(u64))
+		return false;
+
+	u64 *expanded = (u64*)ReallocateWith(&tape->allocator, tape->words, sizeof(u64) * tape->wordCapacity, sizeof(u64) * capacity);
+	if (expanded == NULL)
+		return false;
+	tape->words = expanded;
+	tape->wordCapacity = (u32)capacity;
+	return true;
+}
+
+static bool TapeAppend(JSON_TAPE_BUILDER *builder, const JSON_TAPE_TYPE type, const u64 payload)
+{
+	JSONLIB_Tape *tape = builder->tape;
+	if (!ReserveTapeWords(tape, 1))
+		return false;
+	tape->words[tape->wordCount++] = TapeWord(type, payload);
+	return true;
+}
+
+// NOTE: @Jon
+// Numbers take two words, the second being the raw 64 bits of the value
+static bool TapeAppendNumber(JSON_TAPE_BUILDER *builder, const JSON_TAPE_TYPE type, const u64 bits)
+{
+	JSONLIB_Tape *tape = builder->tape;
+	if (!ReserveTapeWords(tape, 2))
+		return false;
+	tape->words[tape->wordCount++] = TapeWord(type, 0);
+	tape->words[tape->wordCount++] = bits;
+	return true;
+}
+
+// NOTE: @Jon
+// Copies a key or string into the string buffer behind a 32 bit length, NUL terminated
+static bool TapeAppendString(JSON_TAPE_BUILDER *builder, const JSON_TAPE_TYPE type, const char *str, const u32 length)
+{
+	JSONLIB_Tape *tape = builder->tape;
+	const size_t needed = tape->stringsLength + sizeof(u32) + length + 1;
+	if (needed > tape->stringsCapacity)
+	{
+		size_t capacity = tape->stringsCapacity * 2;
+		while (capacity < needed)
+			capacity *= 2;
+
+		char *expanded = (char*)ReallocateWith(&tape->allocator, tape->strings, sizeof(char) * tape->stringsCapacity, sizeof(char) * capacity);
+		if (expanded == NULL)
+			return false;
+		tape->strings = expanded;
+		tape->stringsCapacity = capacity;
+	}
+
+	const size_t offset = tape->stringsLength;
+	memcpy(&tape->strings[offset], &length, sizeof(u32));
+	memcpy(&tape->strings[offset + sizeof(u32)], str, sizeof(char) * length);
+	tape->strings[offset + sizeof(u32) + length] = '\0';
+	tape->stringsLength = needed;
+	return TapeAppend(builder, type, offset);
+}
+
+static bool TapeStart(JSON_TAPE_BUILDER *builder, const JSON_TAPE_TYPE type)
+{
+	// The parser already holds documents to JSON_MAX_PARSE_DEPTH
+	builder->scopes[builder->depth++] = builder->tape->wordCount;
+	return TapeAppend(builder, type, 0);
+}
+
+// NOTE: @Jon
+// Closes a container, pointing its opening word at the closing one along with how many children it has
+static bool TapeEnd(JSON_TAPE_BUILDER *builder, const JSON_TAPE_TYPE type, const u32 count)
+{
+	const u32 start = builder->scopes[--builder->depth];
+	const u32 end = builder->tape->wordCount;
+	if (!TapeAppend(builder, type, start))
+		return false;
+
+	const u64 savedCount = count < JSON_TAPE_COUNT_MASK ? count : JSON_TAPE_COUNT_MASK;
+	builder->tape->words[start] |= (savedCount << 32) | end;
+	return true;
+}
+
+static bool TapeStartObject(void *user)
+{
+	return TapeStart((JSON_TAPE_BUILDER*)user, JSON_TAPE_OBJECT);
+}
+
+static bool TapeEndObject(void *user, u32 memberCount)
+{
+	return TapeEnd((JSON_TAPE_BUILDER*)user, JSON_TAPE_OBJECT_END, memberCount);
+}
+
+static bool TapeStartArray(void *user)
+{
+	return TapeStart((JSON_TAPE_BUILDER*)user, JSON_TAPE_ARRAY);
+}
+
+static bool TapeEndArray(void *user, u32 elementCount)
+{
+	return TapeEnd((JSON_TAPE_BUILDER*)user, JSON_TAPE_ARRAY_END, elementCount);
+}
+
+static bool TapeKey(void *user, const char *name, u32 nameLength)
+{
+	return TapeAppendString((JSON_TAPE_BUILDER*)user, JSON_TAPE_KEY, name, nameLength);
+}
+
+static bool TapeString(void *user, const char *string, u32 stringLength)
+{
+	return TapeAppendString((JSON_TAPE_BUILDER*)user, JSON_TAPE_STRING, string, stringLength);
+}
+
+static bool TapeInteger(void *user, i64 integer)
+{
+	return TapeAppendNumber((JSON_TAPE_BUILDER*)user, JSON_TAPE_INTEGER, (u64)integer);
+}
+
+static bool TapeUnsigned(void *user, u64 integer)
+{
+	return TapeAppendNumber((JSON_TAPE_BUILDER*)user, JSON_TAPE_UNSIGNED, integer);
+}
+
+static bool TapeDecimal(void *user, f64 decimal)
+{
+	u64 bits;
+	memcpy(&bits, &decimal, sizeof(bits));
+	return TapeAppendNumber((JSON_TAPE_BUILDER*)user, JSON_TAPE_DECIMAL, bits);
+}
+
+static bool TapeBoolean(void *user, bool boolean)
+{
+	return TapeAppend((JSON_TAPE_BUILDER*)user, boolean ? JSON_TAPE_TRUE : JSON_TAPE_FALSE, 0);
+}
+
+static bool TapeNull(void *user)
+{
+	return TapeAppend((JSON_TAPE_BUILDER*)user, JSON_TAPE_NULL, 0);
+}
+
+static const JSONLIB_Handler JSONtapeHandler =
+{
+	TapeStartObject, TapeEndObject, TapeStartArray, TapeEndArray, TapeKey, TapeString,
+	TapeInteger, TapeUnsigned, TapeDecimal, TapeBoolean, TapeNull
+};
+
+// NOTE: @Jon
+// Allocates an empty tape with room for the given number of words and string bytes, which grow as needed
+// Gives back false if any of it couldn't be allocated, the tape still has to be destroyed
+// The tape keeps a copy of the calling thread's allocator, which everything in it comes from
+static bool CreateTape(JSONLIB_Tape **created, const u32 wordCapacity, const size_t stringsCapacity)
+{
+	JSONLIB_Tape *tape = (JSONLIB_Tape*)JSON_Allocate(sizeof(JSONLIB_Tape));
+	*created = tape;
+	if (tape == NULL)
+		return false;
+
+	tape->allocator = *CurrentAllocator();
+	tape->wordCapacity = wordCapacity;
+	tape->wordCount = 0;
+	tape->words = (u64*)AllocateWith(&tape->allocator, sizeof(u64) * tape->wordCapacity);
+	tape->stringsCapacity = stringsCapacity;
+	tape->stringsLength = 0;
+	tape->strings = (char*)AllocateWith(&tape->allocator, sizeof(char) * tape->stringsCapacity);
+	tape->mapping.data = NULL;
+	tape->mapping.length = 0;
+	tape->mapped = false;
+	return tape->words != NULL && tape->strings != NULL;
+}
+
+// NOTE: @Jon
+// Parses a JSON string into a tape
+JSONLIB_Tape *JSONLIB_ParseTape(const char *jsonString, size_t stringLength, u32 flags)
+{
+	// Most documents have far fewer values than bytes, both buffers grow if the guesses are short
+	JSONLIB_Tape *tape = NULL;
+	bool parsed = CreateTape(&tape, (u32)(stringLength / 8 < 0x10000000 ? stringLength / 8 + 16 : 0x10000000), stringLength / 2 + 64);
+
+	JSON_TAPE_BUILDER builder;
+	builder.tape = tape;
+	builder.depth = 0;
+
+	// The first word is never a value, so a cursor's key position of 0 can mean it has none
+	parsed = parsed && TapeAppend(&builder, JSON_TAPE_ROOT, 0);
+	parsed = parsed && ParseSAXInternal(jsonString, stringLength, flags & JSON_PARSE_STRUCTURAL_INDEX, &JSONtapeHandler, &builder, 0, &tape->allocator);
+	if (!parsed)
+	{
+		JSONLIB_DestroyTape(tape);
+		return NULL;
+	}
+	return tape;
+}
+
+// NOTE: @Jon
+// Frees a tape, the words and the strings are one allocation each (or both part of a mapped snapshot)
+void JSONLIB_DestroyTape(JSONLIB_Tape *tape)
+{
+	if (tape == NULL)
+		return;
+
+	// The allocator is copied out first since it's freed along with the tape
+	const JSONLIB_Allocator allocator = tape->allocator;
+	if (tape->mapped)
+		UnmapFile(&tape->mapping);
+	else
+	{
+		if (tape->words != NULL)
+			DeallocateWith(&allocator, tape->words, sizeof(u64) * tape->wordCapacity);
+		if (tape->strings != NULL)
+			DeallocateWith(&allocator, tape->strings, sizeof(char) * tape->stringsCapacity);
+	}
+	DeallocateWith(&allocator, tape, sizeof(JSONLIB_Tape));
+}
+
+// NOTE: @Jon
+// Gets a cursor on the root value of a tape
+JSONLIB_Cursor JSONLIB_GetTapeRoot(const JSONLIB_Tape *tape)
+{
+	JSONLIB_Cursor cursor;
+	cursor.tape = tape;
+	cursor.position = 1;
+	cursor.key = 0;
+	return cursor;
+}
+
+// NOTE: @Jon
+// Gets the position just past a value, skipping the whole of a container
+static u32 TapeSkip(const JSONLIB_Tape *tape, const u32 position)
+{
+	const u64 word = tape->words[position];
+	switch (TapeType(word))
+	{
+	case JSON_TAPE_OBJECT:
+	case JSON_TAPE_ARRAY:
+		return (u32)(word & 0xFFFFFFFFu) + 1;
+	case JSON_TAPE_INTEGER:
+	case JSON_TAPE_UNSIGNED:
+	case JSON_TAPE_DECIMAL:
+		return position + 2;
+	default:
+		return position + 1;
+	}
+}
+
+// NOTE: @Jon
+// Points a cursor at the value starting at position, or its key if it's a member
+// Gives back false if position is where a container ends
+static bool TapeMoveTo(JSONLIB_Cursor *cursor, const u32 position)
+{
+	const JSONLIB_Tape *tape = cursor->tape;
+	const JSON_TAPE_TYPE type = TapeType(tape->words[position]);
+	if (type == JSON_TAPE_OBJECT_END || type == JSON_TAPE_ARRAY_END)
+		return false;
+
+	cursor->key = type == JSON_TAPE_KEY ? position : 0;
+	cursor->position = type == JSON_TAPE_KEY ? position + 1 : position;
+	return true;
+}
+
+// NOTE: @Jon
+// Moves a cursor down to the first value of an array or object
+bool JSONLIB_CursorChild(JSONLIB_Cursor *cursor)
+{
+	const JSON_TAPE_TYPE type = TapeType(cursor->tape->words[cursor->position]);
+	if (type != JSON_TAPE_OBJECT && type != JSON_TAPE_ARRAY)
+		return false;
+	return TapeMoveTo(cursor, cursor->position + 1);
+}
+
+// NOTE: @Jon
+// Moves a cursor along to the value after it in the same container
+bool JSONLIB_CursorNextSibling(JSONLIB_Cursor *cursor)
+{
+	if (cursor->position == 1)
+		return false;
+	return TapeMoveTo(cursor, TapeSkip(cursor->tape, cursor->position));
+}
+
+static const char *TapeStringAt(const JSONLIB_Tape *tape, const u64 word, u32 *length)
+{
+	const char *str = &tape->strings[TapePayload(word)];
+	memcpy(length, str, sizeof(u32));
+	return str + sizeof(u32);
+}
+
+// NOTE: @Jon
+// Moves a cursor on an object to the value of its first member with the name
+bool JSONLIB_CursorFindKey(JSONLIB_Cursor *cursor, const char *name, u32 nameLength)
+{
+	const JSONLIB_Tape *tape = cursor->tape;
+	const u64 word = tape->words[cursor->position];
+	if (TapeType(word) != JSON_TAPE_OBJECT)
+		return false;
+
+	const u32 end = (u32)(word & 0xFFFFFFFFu);
+	for (u32 position = cursor->position + 1; position < end; position = TapeSkip(tape, position + 1))
+	{
+		u32 keyLength = 0;
+		const char *key = TapeStringAt(tape, tape->words[position], &keyLength);
+		if (keyLength == nameLength && memcmp(key, name, nameLength) == 0)
+		{
+			cursor->key = position;
+			cursor->position = position + 1;
+			return true;
+		}
+	}
+	return false;
+}
+
+// NOTE: @Jon
+// Gets the JSON_*_TAG tags a tree node would have for the value under a cursor
+u16 JSONLIB_CursorGetTags(const JSONLIB_Cursor *cursor)
+{
+	const JSONLIB_Tape *tape = cursor->tape;
+	switch (TapeType(tape->words[cursor->position]))
+	{
+	case JSON_TAPE_OBJECT: return JSON_OBJECT_TAG;
+	case JSON_TAPE_ARRAY: return JSON_ARRAY_TAG;
+	case JSON_TAPE_STRING: return JSON_STRING_TAG;
+	case JSON_TAPE_TRUE:
+	case JSON_TAPE_FALSE: return JSON_BOOLEAN_TAG;
+	case JSON_TAPE_NULL: return JSON_NULL_TAG;
+	case JSON_TAPE_DECIMAL: return JSON_DECIMAL_TAG | JSON_DECIMAL64_TAG;
+	case JSON_TAPE_UNSIGNED: return JSON_UNSIGNED64_TAG;
+	case JSON_TAPE_INTEGER:
+	{
+		JSON number;
+		SetInteger64(&number, (i64)tape->words[cursor->position + 1]);
+		return number.tags;
+	}
+	default: return 0;
+	}
+}
+
+// NOTE: @Jon
+// Gets the name of the member under a cursor, or NULL if it isn't in an object
+const char *JSONLIB_CursorGetName(const JSONLIB_Cursor *cursor, u32 *nameLength)
+{
+	if (cursor->key == 0)
+		return NULL;
+
+	u32 length = 0;
+	const char *name = TapeStringAt(cursor->tape, cursor->tape->words[cursor->key], &length);
+	if (nameLength != NULL)
+		*nameLength = length;
+	return name;
+}
+
+// NOTE: @Jon
+// Gets how many values an array or object under a cursor has
+u32 JSONLIB_CursorGetCount(const JSONLIB_Cursor *cursor)
+{
+	const u64 word = cursor->tape->words[cursor->position];
+	const JSON_TAPE_TYPE type = TapeType(word);
+	if (type != JSON_TAPE_OBJECT && type != JSON_TAPE_ARRAY)
+		return 0;
+
+	const u64 count = (TapePayload(word) >> 32) & JSON_TAPE_COUNT_MASK;
+	if (count < JSON_TAPE_COUNT_MASK)
+		return (u32)count;
+
+	// Counts too big for the word are counted the long way
+	JSONLIB_Cursor child = *cursor;
+	u32 total = 0;
+	for (bool more = JSONLIB_CursorChild(&child); more; more = JSONLIB_CursorNextSibling(&child))
+		total++;
+	return total;
+}
+
+// NOTE: @Jon
+// Gets an integer under a cursor, giving back false if the value isn't one or doesn't fit
+bool JSONLIB_CursorGetInteger64(const JSONLIB_Cursor *cursor, i64 *integer)
+{
+	const JSONLIB_Tape *tape = cursor->tape;
+	if (TapeType(tape->words[cursor->position]) != JSON_TAPE_INTEGER)
+		return false;
+	*integer = (i64)tape->words[cursor->position + 1];
+	return true;
+}
+
+bool JSONLIB_CursorGetUnsigned64(const JSONLIB_Cursor *cursor, u64 *integer)
+{
+	const JSONLIB_Tape *tape = cursor->tape;
+	const JSON_TAPE_TYPE type = TapeType(tape->words[cursor->position]);
+	if (type != JSON_TAPE_UNSIGNED && (type != JSON_TAPE_INTEGER || (i64)tape->words[cursor->position + 1] < 0))
+		return false;
+	*integer = tape->words[cursor->position + 1];
+	return true;
+}
+
+// NOTE: @Jon
+// Gets a number under a cursor as a double, integers included
+bool JSONLIB_CursorGetDecimal64(const JSONLIB_Cursor *cursor, f64 *decimal)
+{
+	const JSONLIB_Tape *tape = cursor->tape;
+	const u64 *bits = &tape->words[cursor->position + 1];
+	switch (TapeType(tape->words[cursor->position]))
+	{
+	case JSON_TAPE_DECIMAL:
+		memcpy(decimal, bits, sizeof(f64));
+		return true;
+	case JSON_TAPE_INTEGER:
+		*decimal = (f64)(i64)*bits;
+		return true;
+	case JSON_TAPE_UNSIGNED:
+		*decimal = (f64)*bits;
+		return true;
+	default:
+		return false;
+	}
+}
+
+bool JSONLIB_CursorGetBoolean(const JSONLIB_Cursor *cursor, bool *boolean)
+{
+	const JSON_TAPE_TYPE type = TapeType(cursor->tape->words[cursor->position]);
+	if (type != JSON_TAPE_TRUE && type != JSON_TAPE_FALSE)
+		return false;
+	*boolean = type == JSON_TAPE_TRUE;
+	return true;
+}
+
+// NOTE: @Jon
+// Gets the string under a cursor (NUL terminated), or NULL if the value isn't a string
+const char *JSONLIB_CursorGetString(const JSONLIB_Cursor *cursor, u32 *stringLength)
+{
+	const u64 word = cursor->tape->words[cursor->position];
+	if (TapeType(word) != JSON_TAPE_STRING)
+		return NULL;
+
+	u32 length = 0;
+	const char *str = TapeStringAt(cursor->tape, word, &length);
+	if (stringLength != NULL)
+		*stringLength = length;
+	return str;
+}
+
+// NOTE: @Jon
+// Binary snapshots
+// A snapshot is a tape written straight to a file, since every position on a tape is relative to the start of
+// its words or strings it can be mapped back in read only and walked with a cursor as it is. Turning it back into
+// a tree replays the tape as parse events.
+
+static f64 WidenDecimal32(const f32 decimal);
+
+// NOTE: @Jon
+// Hands a tree to a handler as the parse events that would have built it
+// Values are written as the serializer would, from the widest member that holds them exactly
+static bool EmitJSON(const JSON *json, const JSONLIB_Handler *handler, void *user, const u32 depth)
+{
+	const bool object = HasTags(json, JSON_OBJECT_TAG);
+	if (object || HasTags(json, JSON_ARRAY_TAG))
+	{
+		if (depth >= JSON_MAX_PARSE_DEPTH)
+			return false;
+		if (!(object ? handler->startObject(user) : handler->startArray(user)))
+			return false;
+
+		u32 count = 0;
+		for (u32 i = 0; i < json->valueCount; ++i)
+		{
+			const JSON *value = json->values[i];
+			if (value == NULL)
+				continue;
+
+			// Members without a name are written with an empty one, as the serializer does
+			if (object && !handler->key(user, value->name != NULL ? value->name : "", value->name != NULL ? value->nameLength : 0))
+				return false;
+			if (!EmitJSON(value, handler, user, depth + 1))
+				return false;
+			count++;
+		}
+		return object ? handler->endObject(user, count) : handler->endArray(user, count);
+	}
+
+	if (HasTags(json, JSON_DECIMAL_TAG | JSON_DECIMAL64_TAG))
+		return handler->decimal(user, HasTags(json, JSON_DECIMAL64_TAG) ? json->decimal64 : WidenDecimal32(json->decimal));
+	if (HasTags(json, JSON_INTEGER64_TAG))
+		return handler->integer(user, json->integer64);
+	if (HasTags(json, JSON_UNSIGNED64_TAG))
+		return handler->unsignedInteger(user, json->unsigned64);
+	if (HasTags(json, JSON_INTEGER_TAG))
+		return handler->integer(user, json->integer);
+	if (HasTags(json, JSON_BOOLEAN_TAG))
+		return handler->boolean(user, json->boolean);
+	if (HasTags(json, JSON_NULL_TAG))
+		return handler->null(user);
+	if (HasTags(json, JSON_STRING_TAG))
+		return handler->string(user, json->string != NULL ? json->string : "", json->string != NULL ? json->stringLength : 0);
+
+	// A node with no value has nothing to write
+	return false;
+}
+
+// NOTE: @Jon
+// Hands everything on a tape to a handler as parse events
+// Counts are taken as the events go, since a container's word only has room for so big a count
+static bool ReplayTape(const JSONLIB_Tape *tape, const JSONLIB_Handler *handler, void *user)
+{
+	u32 counts[JSON_MAX_PARSE_DEPTH + 1];
+	u32 depth = 0;
+	counts[0] = 0;
+
+	u32 position = 1;
+	while (position < tape->wordCount)
+	{
+		const u64 word = tape->words[position];
+		const JSON_TAPE_TYPE type = TapeType(word);
+		bool handled = true;
+		switch (type)
+		{
+		case JSON_TAPE_OBJECT:
+		case JSON_TAPE_ARRAY:
+			if (depth >= JSON_MAX_PARSE_DEPTH)
+				return false;
+			counts[depth]++;
+			counts[++depth] = 0;
+			handled = type == JSON_TAPE_OBJECT ? handler->startObject(user) : handler->startArray(user);
+			break;
+		case JSON_TAPE_OBJECT_END:
+		case JSON_TAPE_ARRAY_END:
+			if (depth == 0)
+				return false;
+			depth--;
+			handled = type == JSON_TAPE_OBJECT_END ? handler->endObject(user, counts[depth + 1]) : handler->endArray(user, counts[depth + 1]);
+			break;
+		case JSON_TAPE_KEY:
+		{
+			u32 length = 0;
+			const char *name = TapeStringAt(tape, word, &length);
+			handled = handler->key(user, name, length);
+			break;
+		}
+		case JSON_TAPE_STRING:
+		{
+			u32 length = 0;
+			const char *str = TapeStringAt(tape, word, &length);
+			counts[depth]++;
+			handled = handler->string(user, str, length);
+			break;
+		}
+		case JSON_TAPE_INTEGER:
+			counts[depth]++;
+			handled = handler->integer(user, (i64)tape->words[position + 1]);
+			break;
+		case JSON_TAPE_UNSIGNED:
+			counts[depth]++;
+			handled = handler->unsignedInteger(user, tape->words[position + 1]);
+			break;
+		case JSON_TAPE_DECIMAL:
+		{
+			f64 decimal;
+			memcpy(&decimal, &tape->words[position + 1], sizeof(f64));
+			counts[depth]++;
+			handled = handler->decimal(user, decimal);
+			break;
+		}
+		case JSON_TAPE_TRUE:
+		case JSON_TAPE_FALSE:
+			counts[depth]++;
+			handled = handler->boolean(user, type == JSON_TAPE_TRUE);
+			break;
+		case JSON_TAPE_NULL:
+			counts[depth]++;
+			handled = handler->null(user);
+			break;
+		default:
+			return false;
+		}
+
+		if (!handled)
+			return false;
+		position += (type == JSON_TAPE_INTEGER || type == JSON_TAPE_UNSIGNED || type == JSON_TAPE_DECIMAL) ? 2 : 1;
+	}
+	return depth == 0 && counts[0] == 1;
+}
+
+// NOTE: @Jon
+// Writes a tree to a binary snapshot file, giving back false if the tree has a node without a value
+// or the file couldn't be written
+bool JSONLIB_SaveBinary(const JSON *json, const char *path)
+{
+	if (json == NULL || path == NULL)
+		return false;
+
+	JSONLIB_Tape *tape = NULL;
+	bool saved = CreateTape(&tape, JSON_MIN_TAPE_WORDS, JSON_MIN_TAPE_STRINGS);
+
+	JSON_TAPE_BUILDER builder;
+	builder.tape = tape;
+	builder.depth = 0;
+	saved = saved && TapeAppend(&builder, JSON_TAPE_ROOT, 0);
+	saved = saved && EmitJSON(json, &JSONtapeHandler, &builder, 0);
+
+	FILE *file = saved ? fopen(path, "wb") : NULL;
+	if (file != NULL)
+	{
+		JSON_BINARY_HEADER header;
+		memcpy(header.magic, "JLTP", 4);
+		header.version = JSON_BINARY_VERSION;
+		header.byteOrder = JSON_BINARY_BYTE_ORDER;
+		header.wordCount = tape->wordCount;
+		header.stringsLength = (u64)tape->stringsLength;
+
+		saved = fwrite(&header, sizeof(header), 1, file) == 1;
+		saved = saved && fwrite(tape->words, sizeof(u64), tape->wordCount, file) == tape->wordCount;
+		saved = saved && fwrite(tape->strings, sizeof(char), tape->stringsLength, file) == tape->stringsLength;
+		saved = (fclose(file) == 0) && saved;
+
+		// A half written snapshot is no use to anyone
+		if (!saved)
+			remove(path);
+	}
+	else
+		saved = false;
+
+	JSONLIB_DestroyTape(tape);
+	return saved;
+}
+
+// NOTE: @Jon
+// Checks that a key or string word's length prefixed bytes, and the NUL after them, are inside the string buffer
+static bool TapeStringInRange(const JSONLIB_Tape *tape, const u64 word)
+{
+	const u64 offset = TapePayload(word);
+	if (offset > tape->stringsLength || tape->stringsLength - offset < sizeof(u32) + 1)
+		return false;
+
+	u32 length = 0;
+	memcpy(&length, &tape->strings[offset], sizeof(u32));
+	return (u64)length <= tape->stringsLength - offset - sizeof(u32) - 1 && tape->strings[offset + sizeof(u32) + length] == '\0';
+}
+
+// NOTE: @Jon
+// Walks a tape that didn't come from the parser once, checking it's laid out the way the tape builder lays one out
+// Every container has to point at its own closing word with the right count, and every number and string has to
+// stay inside the tape, so a damaged snapshot can't send a cursor or a replay outside of it
+static bool ValidateTape(const JSONLIB_Tape *tape)
+{
+	u32 scopes[JSON_MAX_PARSE_DEPTH];
+	u32 counts[JSON_MAX_PARSE_DEPTH + 1];
+	u32 depth = 0;
+	counts[0] = 0;
+	bool afterKey = false;
+
+	if (tape->wordCount < 2 || TapeType(tape->words[0]) != JSON_TAPE_ROOT)
+		return false;
+
+	u32 position = 1;
+	while (position < tape->wordCount)
+	{
+		const u64 word = tape->words[position];
+		const JSON_TAPE_TYPE type = TapeType(word);
+		const bool inObject = depth > 0 && TapeType(tape->words[scopes[depth - 1]]) == JSON_TAPE_OBJECT;
+
+		// The root holds a single value, and an object's members are each a key followed by a value
+		bool valid = depth > 0 || counts[0] == 0;
+		if (type == JSON_TAPE_KEY)
+		{
+			valid = valid && inObject && !afterKey && TapeStringInRange(tape, word);
+			afterKey = true;
+		}
+		else if (type == JSON_TAPE_OBJECT_END || type == JSON_TAPE_ARRAY_END)
+		{
+			valid = valid && depth > 0 && !afterKey;
+			if (valid)
+			{
+				const u32 start = scopes[--depth];
+				const u64 opening = tape->words[start];
+				const u64 count = counts[depth + 1] < JSON_TAPE_COUNT_MASK ? counts[depth + 1] : JSON_TAPE_COUNT_MASK;
+				valid = TapePayload(word) == start && (opening & 0xFFFFFFFFu) == position &&
+					((opening >> 32) & JSON_TAPE_COUNT_MASK) == count &&
+					(type == JSON_TAPE_OBJECT_END) == (TapeType(opening) == JSON_TAPE_OBJECT);
+			}
+		}
+		else
+		{
+			valid = valid && (!inObject || afterKey);
+			afterKey = false;
+			counts[depth]++;
+			switch (type)
+			{
+			case JSON_TAPE_OBJECT:
+			case JSON_TAPE_ARRAY:
+				valid = valid && depth < JSON_MAX_PARSE_DEPTH &&
+					(word & 0xFFFFFFFFu) > position && (word & 0xFFFFFFFFu) < tape->wordCount;
+				if (valid)
+				{
+					scopes[depth] = position;
+					counts[++depth] = 0;
+				}
+				break;
+			case JSON_TAPE_STRING:
+				valid = valid && TapeStringInRange(tape, word);
+				break;
+			case JSON_TAPE_INTEGER:
+			case JSON_TAPE_UNSIGNED:
+			case JSON_TAPE_DECIMAL:
+				valid = valid && position + 1 < tape->wordCount;
+				break;
+			case JSON_TAPE_TRUE:
+			case JSON_TAPE_FALSE:
+			case JSON_TAPE_NULL:
+				break;
+			default:
+				valid = false;
+				break;
+			}
+		}
+
+		if (!valid)
+			return false;
+		position += (type == JSON_TAPE_INTEGER || type == JSON_TAPE_UNSIGNED || type == JSON_TAPE_DECIMAL) ? 2 : 1;
+	}
+	return depth == 0 && counts[0] == 1;
+}
+
+// NOTE: @Jon
+// Maps a binary snapshot file back in as a read only tape
+// The whole tape is checked before it's handed out, a file that isn't laid out like a saved one is turned away
+JSONLIB_Tape *JSONLIB_MapBinary(const char *path)
+{
+	if (path == NULL)
+		return NULL;
+
+	JSON_FILE_MAPPING mapping;
+	if (!MapFile(path, false, &mapping))
+		return NULL;
+
+	JSON_BINARY_HEADER header;
+	bool valid = mapping.length >= sizeof(header);
+	if (valid)
+	{
+		memcpy(&header, mapping.data, sizeof(header));
+		valid = memcmp(header.magic, "JLTP", 4) == 0 && header.version == JSON_BINARY_VERSION &&
+			header.byteOrder == JSON_BINARY_BYTE_ORDER && header.wordCount >= 2 &&
+			header.stringsLength == (u64)(mapping.length - sizeof(header)) - (u64)header.wordCount * sizeof(u64) &&
+			(u64)header.wordCount * sizeof(u64) <= (u64)(mapping.length - sizeof(header));
+	}
+
+	JSONLIB_Tape *tape = valid ? (JSONLIB_Tape*)JSON_Allocate(sizeof(JSONLIB_Tape)) : NULL;
+	if (tape == NULL)
+	{
+		UnmapFile(&mapping);
+		return NULL;
+	}
+
+	// The header keeps the words eight byte aligned, the tape never writes through these
+	tape->words = (u64*)(mapping.data + sizeof(header));
+	tape->wordCount = header.wordCount;
+	tape->wordCapacity = header.wordCount;
+	tape->strings = (char*)(mapping.data + sizeof(header) + (size_t)header.wordCount * sizeof(u64));
+	tape->stringsLength = (size_t)header.stringsLength;
+	tape->stringsCapacity = (size_t)header.stringsLength;
+	tape->mapping = mapping;
+	tape->mapped = true;
+	tape->allocator = *CurrentAllocator();
+
+	if (!ValidateTape(tape))
+	{
+		JSONLIB_DestroyTape(tape);
+		return NULL;
+	}
+	return tape;
+}
+
+// NOTE: @Jon
+// Builds a tree out of a tape, placing it in the arena if one is given
+// Names and strings are copied, so the tree doesn't depend on the tape
+JSON *JSONLIB_TapeToJSON(const JSONLIB_Tape *tape, JSONLIB_Arena *arena)
+{
+	if (tape == NULL)
+		return NULL;
+
+	JSON_DOM_BUILDER builder;
+	InitDOMBuilder(&builder, tape->strings, tape->stringsLength, 0, arena);
+	const bool built = ReplayTape(tape, &JSONdomHandler, &builder);
+	return FinishDOMBuilder(&builder, built);
+}
+
+// NOTE: @Jon
+// Lazy documents
+// Parsing a lazy document only builds the structural index and checks the tokens are in a valid order, matching
+// every opening bracket with its closing one on the way. Navigating hops between tokens, skipping whole containers
+// through their matches, and a scalar is only parsed when it's read. Scalars are checked as they're parsed, so
+// a document with a bad number or string somewhere is only found out when that value is read.
+
+// NOTE: @Jon
+// What a lazy document is expecting at the next token when checking its structure
+typedef enum JSON_LAZY_EXPECT
+{
+	JSON_LAZY_EXPECT_VALUE,
+	JSON_LAZY_EXPECT_VALUE_OR_CLOSE,
+	JSON_LAZY_EXPECT_KEY,
+	JSON_LAZY_EXPECT_KEY_OR_CLOSE,
+	JSON_LAZY_EXPECT_COLON,
+	JSON_LAZY_EXPECT_COMMA_OR_CLOSE
+} JSON_LAZY_EXPECT;
+
+// NOTE: @Jon
+// Checks the order of a lazy document's tokens and matches up its brackets
+static bool MatchLazyTokens(JSONLIB_LazyDocument *document)
+{
+	u32 scopes[JSON_MAX_PARSE_DEPTH];
+	u32 depth = 0;
+	JSON_LAZY_EXPECT expect = JSON_LAZY_EXPECT_VALUE;
+
+	for (u32 token = 0; token < document->tokenCount; ++token)
+	{
+		const char c = document->input[document->positions[token]];
+		const bool canClose = expect == JSON_LAZY_EXPECT_COMMA_OR_CLOSE ||
+			(c == '}' && expect == JSON_LAZY_EXPECT_KEY_OR_CLOSE) || (c == ']' && expect == JSON_LAZY_EXPECT_VALUE_OR_CLOSE);
+		if (canClose && (c == '}' || c == ']'))
+		{
+			// The closer has to be the right kind for the container it ends
+			if (depth == 0 || document->input[document->positions[scopes[depth - 1]]] != (c == '}' ? '{' : '['))
+				return false;
+			document->matches[scopes[--depth]] = token;
+			expect = JSON_LAZY_EXPECT_COMMA_OR_CLOSE;
+			continue;
+		}
+
+		switch (expect)
+		{
+		case JSON_LAZY_EXPECT_VALUE:
+		case JSON_LAZY_EXPECT_VALUE_OR_CLOSE:
+			if (c == '{' || c == '[')
+			{
+				if (depth >= JSON_MAX_PARSE_DEPTH)
+					return false;
+				scopes[depth++] = token;
+				expect = c == '{' ? JSON_LAZY_EXPECT_KEY_OR_CLOSE : JSON_LAZY_EXPECT_VALUE_OR_CLOSE;
+				break;
+			}
+			if (c == '}' || c == ']' || c == ',' || c == ':')
+				return false;
+
+			// A string's closing quote is the token after its opening one
+			if (c == '"')
+				token++;
+			expect = JSON_LAZY_EXPECT_COMMA_OR_CLOSE;
+			break;
+		case JSON_LAZY_EXPECT_KEY:
+		case JSON_LAZY_EXPECT_KEY_OR_CLOSE:
+			if (c != '"')
+				return false;
+			token++;
+			expect = JSON_LAZY_EXPECT_COLON;
+			break;
+		case JSON_LAZY_EXPECT_COLON:
+			if (c != ':')
+				return false;
+			expect = JSON_LAZY_EXPECT_VALUE;
+			break;
+		case JSON_LAZY_EXPECT_COMMA_OR_CLOSE:
+			if (depth == 0 || c != ',')
+				return false;
+			expect = document->input[document->positions[scopes[depth - 1]]] == '{' ? JSON_LAZY_EXPECT_KEY : JSON_LAZY_EXPECT_VALUE;
+			break;
+		}
+	}
+	return depth == 0 && expect == JSON_LAZY_EXPECT_COMMA_OR_CLOSE;
+}
+
+// NOTE: @Jon
+// Indexes a JSON string's structure without parsing any of its values
+JSONLIB_LazyDocument *JSONLIB_ParseLazy(const char *jsonString, size_t stringLength)
+{
+	// Tokens are found through the 32 bit structural index
+	if (stringLength > 0xFFFFFFFFu)
+		return NULL;
+
+	JSONLIB_LazyDocument *document = (JSONLIB_LazyDocument*)JSON_Allocate(sizeof(JSONLIB_LazyDocument));
+	if (document == NULL)
+		return NULL;
+	document->allocator = *CurrentAllocator();
+	document->input = jsonString;
+	document->inputLength = stringLength;
+	document->matches = NULL;
+	document->arena = NULL;
+
+	JSON_STRUCTURAL_INDEX index;
+	index.positions = NULL;
+	bool indexed = BuildStructuralIndex(jsonString, stringLength, &document->allocator, &index);
+	document->positions = index.positions;
+	document->positionCapacity = index.positionCapacity;
+	document->tokenCount = (u32)index.positionCount;
+	if (indexed)
+	{
+		document->matches = (u32*)AllocateWith(&document->allocator, sizeof(u32) * (document->tokenCount + 1));
+		indexed = document->matches != NULL && MatchLazyTokens(document);
+	}
+
+	if (!indexed)
+	{
+		JSONLIB_DestroyLazy(document);
+		return NULL;
+	}
+	return document;
+}
+
+// NOTE: @Jon
+// Frees a lazy document along with anything decoded from it
+void JSONLIB_DestroyLazy(JSONLIB_LazyDocument *document)
+{
+	if (document == NULL)
+		return;
+
+	// The allocator is copied out first since it's freed along with the document
+	const JSONLIB_Allocator allocator = document->allocator;
+	if (document->positions != NULL)
+		DeallocateWith(&allocator, document->positions, sizeof(u32) * document->positionCapacity);
+	if (document->matches != NULL)
+		DeallocateWith(&allocator, document->matches, sizeof(u32) * (document->tokenCount + 1));
+	if (document->arena != NULL)
+		JSONLIB_DestroyArena(document->arena);
+	DeallocateWith(&allocator, document, sizeof(JSONLIB_LazyDocument));
+}
+
+// NOTE: @Jon
+// Gets a lazy value for the root of a document
+JSONLIB_LazyValue JSONLIB_GetLazyRoot(JSONLIB_LazyDocument *document)
+{
+	JSONLIB_LazyValue value;
+	value.document = document;
+	value.token = 0;
+	value.key = 0;
+	return value;
+}
+
+static char LazyTokenChar(const JSONLIB_LazyDocument *document, const u32 token)
+{
+	return document->input[document->positions[token]];
+}
+
+// NOTE: @Jon
+// Gets the token just past a value, skipping the whole of a container
+static u32 LazySkip(const JSONLIB_LazyDocument *document, const u32 token)
+{
+	switch (LazyTokenChar(document, token))
+	{
+	case '{':
+	case '[':
+		return document->matches[token] + 1;
+	case '"':
+		return token + 2;
+	default:
+		return token + 1;
+	}
+}
+
+// NOTE: @Jon
+// Gets how many bytes of the input a value covers, a scalar runs up to the next token
+static size_t LazyLength(const JSONLIB_LazyDocument *document, const u32 token)
+{
+	const u32 end = LazySkip(document, token);
+	const char c = LazyTokenChar(document, token);
+	if (c == '{' || c == '[' || c == '"')
+		return document->positions[end - 1] + 1 - document->positions[token];
+	return (end < document->tokenCount ? document->positions[end] : document->inputLength) - document->positions[token];
+}
+
+static bool LazyScalarString(void *user, const char *string, u32 stringLength)
+{
+	JSON_LAZY_SCALAR *scalar = (JSON_LAZY_SCALAR*)user;
+	if (scalar->compareName != NULL)
+	{
+		scalar->matched = stringLength == scalar->compareLength && memcmp(string, scalar->compareName, stringLength) == 0;
+		return true;
+	}
+
+	// Strings without escapes are left where they are in the input, decoded ones are kept in the document's arena
+	const JSONLIB_LazyDocument *document = scalar->document;
+	if (string < document->input || string >= document->input + document->inputLength)
+	{
+		if (scalar->document->arena == NULL)
+			scalar->document->arena = JSONLIB_CreateArenaWith(0, &scalar->document->allocator);
+		char *copy = scalar->document->arena != NULL ? (char*)ArenaAllocate(scalar->document->arena, sizeof(char) * (stringLength + 1)) : NULL;
+		if (copy == NULL)
+			return false;
+		memcpy(copy, string, sizeof(char) * stringLength);
+		copy[stringLength] = '\0';
+		string = copy;
+	}
+	scalar->value.tags = JSON_STRING_TAG;
+	scalar->value.string = string;
+	scalar->value.stringLength = stringLength;
+	return true;
+}
+
+static bool LazyScalarInteger(void *user, i64 integer)
+{
+	SetInteger64(&((JSON_LAZY_SCALAR*)user)->value, integer);
+	return true;
+}
+
+static bool LazyScalarUnsigned(void *user, u64 integer)
+{
+	SetUnsigned64(&((JSON_LAZY_SCALAR*)user)->value, integer);
+	return true;
+}
+
+static bool LazyScalarDecimal(void *user, f64 decimal)
+{
+	SetDecimal64(&((JSON_LAZY_SCALAR*)user)->value, decimal);
+	return true;
+}
+
+static bool LazyScalarBoolean(void *user, bool boolean)
+{
+	JSON_LAZY_SCALAR *scalar = (JSON_LAZY_SCALAR*)user;
+	scalar->value.tags = JSON_BOOLEAN_TAG;
+	scalar->value.boolean = boolean;
+	return true;
+}
+
+static bool LazyScalarNull(void *user)
+{
+	((JSON_LAZY_SCALAR*)user)->value.tags = JSON_NULL_TAG;
+	return true;
+}
+
+// NOTE: @Jon
+// Only scalars are ever parsed on their own, so the container events are left out
+static const JSONLIB_Handler JSONlazyScalarHandler =
+{
+	NULL, NULL, NULL, NULL, NULL, LazyScalarString,
+	LazyScalarInteger, LazyScalarUnsigned, LazyScalarDecimal, LazyScalarBoolean, LazyScalarNull
+};
+
+// NOTE: @Jon
+// Parses the scalar (or key) at a token into a node, giving back false if it isn't valid JSON
+static bool ParseLazyScalar(JSONLIB_LazyDocument *document, const u32 token, JSON_LAZY_SCALAR *scalar)
+{
+	scalar->document = document;
+	scalar->value.tags = 0;
+	const char c = LazyTokenChar(document, token);
+	if (c == '{' || c == '[')
+		return false;
+	return ParseSAXInternal(&document->input[document->positions[token]], LazyLength(document, token), 0, &JSONlazyScalarHandler, scalar, 0, &document->allocator);
+}
+
+// NOTE: @Jon
+// Points a lazy value at the value starting at token, taking the key before it in an object
+// Gives back false if token is where a container ends
+static bool LazyMoveTo(JSONLIB_LazyValue *value, const u32 token, const bool member)
+{
+	const char c = LazyTokenChar(value->document, token);
+	if (c == '}' || c == ']')
+		return false;
+
+	// Members are the key's two quotes and a colon before the value
+	value->key = member ? token : 0;
+	value->token = member ? token + 3 : token;
+	return true;
+}
+
+// NOTE: @Jon
+// Moves a lazy value down to the first value of an array or object
+bool JSONLIB_LazyChild(JSONLIB_LazyValue *value)
+{
+	const char c = LazyTokenChar(value->document, value->token);
+	if (c != '{' && c != '[')
+		return false;
+	return LazyMoveTo(value, value->token + 1, c == '{');
+}
+
+// NOTE: @Jon
+// Moves a lazy value along to the value after it in the same container
+bool JSONLIB_LazyNextSibling(JSONLIB_LazyValue *value)
+{
+	const u32 end = LazySkip(value->document, value->token);
+	if (end >= value->document->tokenCount || LazyTokenChar(value->document, end) != ',')
+		return false;
+	return LazyMoveTo(value, end + 1, value->key != 0);
+}
+
+// NOTE: @Jon
+// Moves a lazy value on an object to the value of its first member with the name
+// Keys without escapes are compared straight from the input
+bool JSONLIB_LazyFindKey(JSONLIB_LazyValue *value, const char *name, u32 nameLength)
+{
+	JSONLIB_LazyDocument *document = value->document;
+	if (LazyTokenChar(document, value->token) != '{')
+		return false;
+
+	JSON_LAZY_SCALAR scalar;
+	scalar.compareName = name;
+	scalar.compareLength = nameLength;
+
+	JSONLIB_LazyValue member = *value;
+	for (bool more = JSONLIB_LazyChild(&member); more; more = JSONLIB_LazyNextSibling(&member))
+	{
+		const char *key = &document->input[document->positions[member.key] + 1];
+		const size_t keyLength = document->positions[member.key + 1] - document->positions[member.key] - 1;
+		bool matched = false;
+		if (memchr(key, '\\', keyLength) == NULL)
+			matched = keyLength == nameLength && memcmp(key, name, nameLength) == 0;
+		else
+			matched = ParseLazyScalar(document, member.key, &scalar) && scalar.matched;
+
+		if (matched)
+		{
+			*value = member;
+			return true;
+		}
+	}
+	return false;
+}
+
+// NOTE: @Jon
+// Follows a compiled path down from a lazy value, giving back false (leaving the value) if there's nothing there
+bool JSONLIB_LazyEvalPath(JSONLIB_LazyValue *value, const JSONLIB_Path *path)
+{
+	assert(path != NULL);
+	JSONLIB_LazyValue current = *value;
+	for (u32 i = 0; i < path->segmentCount; ++i)
+	{
+		const JSON_PATH_SEGMENT *segment = &path->segments[i];
+		const char c = LazyTokenChar(current.document, current.token);
+		if (c == '{')
+		{
+			if (!JSONLIB_LazyFindKey(&current, segment->key.name, segment->key.nameLength))
+				return false;
+		}
+		else if (c == '[' && segment->index != JSON_PATH_NO_INDEX)
+		{
+			bool more = JSONLIB_LazyChild(&current);
+			for (u32 j = 0; j < segment->index && more; ++j)
+				more = JSONLIB_LazyNextSibling(&current);
+			if (!more)
+				return false;
+		}
+		else
+			return false;
+	}
+	*value = current;
+	return true;
+}
+
+// NOTE: @Jon
+// Gets the JSON_*_TAG tags a tree node would have for a lazy value, 0 if it isn't valid JSON
+u16 JSONLIB_LazyGetTags(const JSONLIB_LazyValue *value)
+{
+	switch (LazyTokenChar(value->document, value->token))
+	{
+	case '{': return JSON_OBJECT_TAG;
+	case '[': return JSON_ARRAY_TAG;
+	default:
+	{
+		JSON_LAZY_SCALAR scalar;
+		scalar.compareName = NULL;
+		return ParseLazyScalar(value->document, value->token, &scalar) ? scalar.value.tags : 0;
+	}
+	}
+}
+
+// NOTE: @Jon
+// Gets the name of the member a lazy value is, or NULL if it isn't in an object (or the name isn't valid)
+const char *JSONLIB_LazyGetName(const JSONLIB_LazyValue *value, u32 *nameLength)
+{
+	JSON_LAZY_SCALAR scalar;
+	scalar.compareName = NULL;
+	if (value->key == 0 || !ParseLazyScalar(value->document, value->key, &scalar))
+		return NULL;
+	if (nameLength != NULL)
+		*nameLength = scalar.value.stringLength;
+	return scalar.value.string;
+}
+
+// NOTE: @Jon
+// Gets how many values an array or object holds, counting them by skipping from one to the next
+u32 JSONLIB_LazyGetCount(const JSONLIB_LazyValue *value)
+{
+	JSONLIB_LazyValue child = *value;
+	u32 count = 0;
+	for (bool more = JSONLIB_LazyChild(&child); more; more = JSONLIB_LazyNextSibling(&child))
+		count++;
+	return count;
+}
+
+// NOTE: @Jon
+// Parses a lazy value as a number, a boolean or a string, giving back false if it isn't that type
+bool JSONLIB_LazyGetInteger64(const JSONLIB_LazyValue *value, i64 *integer)
+{
+	JSON_LAZY_SCALAR scalar;
+	scalar.compareName = NULL;
+	if (!ParseLazyScalar(value->document, value->token, &scalar) || !HasTags(&scalar.value, JSON_INTEGER64_TAG))
+		return false;
+	*integer = scalar.value.integer64;
+	return true;
+}
+
+bool JSONLIB_LazyGetUnsigned64(const JSONLIB_LazyValue *value, u64 *integer)
+{
+	JSON_LAZY_SCALAR scalar;
+	scalar.compareName = NULL;
+	if (!ParseLazyScalar(value->document, value->token, &scalar) || !HasTags(&scalar.value, JSON_UNSIGNED64_TAG))
+		return false;
+	*integer = scalar.value.unsigned64;
+	return true;
+}
+
+bool JSONLIB_LazyGetDecimal64(const JSONLIB_LazyValue *value, f64 *decimal)
+{
+	JSON_LAZY_SCALAR scalar;
+	scalar.compareName = NULL;
+	if (!ParseLazyScalar(value->document, value->token, &scalar))
+		return false;
+
+	if (HasTags(&scalar.value, JSON_DECIMAL64_TAG))
+		*decimal = scalar.value.decimal64;
+	else if (HasTags(&scalar.value, JSON_INTEGER64_TAG))
+		*decimal = (f64)scalar.value.integer64;
+	else if (HasTags(&scalar.value, JSON_UNSIGNED64_TAG))
+		*decimal = (f64)scalar.value.unsigned64;
+	else
+		return false;
+	return true;
+}
+
+bool JSONLIB_LazyGetBoolean(const JSONLIB_LazyValue *value, bool *boolean)
+{
+	JSON_LAZY_SCALAR scalar;
+	scalar.compareName = NULL;
+	if (!ParseLazyScalar(value->document, value->token, &scalar) || !HasTags(&scalar.value, JSON_BOOLEAN_TAG))
+		return false;
+	*boolean = scalar.value.boolean;
+	return true;
+}
+
+const char *JSONLIB_LazyGetString(const JSONLIB_LazyValue *value, u32 *stringLength)
+{
+	JSON_LAZY_SCALAR scalar;
+	scalar.compareName = NULL;
+	if (!ParseLazyScalar(value->document, value->token, &scalar) || !HasTags(&scalar.value, JSON_STRING_TAG))
+		return NULL;
+	if (stringLength != NULL)
+		*stringLength = scalar.value.stringLength;
+	return scalar.value.string;
+}
+
+// NOTE: @Jon
+// Parses the whole of a lazy value into a tree, placing it in the arena if one is given
+JSON *JSONLIB_LazyToJSON(const JSONLIB_LazyValue *value, JSONLIB_Arena *arena)
+{
+	const JSONLIB_LazyDocument *document = value->document;
+	return ParseJSONInternal(&document->input[document->positions[value->token]], LazyLength(document, value->token), 0, arena);
+}
+
+// NOTE: @Jon
+// Projected parsing
+// A lazy document is walked with the paths that are wanted, building nodes only for the values they lead to and
+// the containers on the way there. Anything no path goes into is skipped whole without being parsed.
+
+// NOTE: @Jon
+// Lists of the paths still being followed, one list per depth, each with room for every path
+typedef struct JSON_PROJECTION
+{
+	const JSONLIB_Path *const *paths;
+	u32 pathCount;
+	u32 *active;
+} JSON_PROJECTION;
+
+// NOTE: @Jon
+// Adds a child to a projected container for every member or element that a path at depth goes through,
+// the whole value when a path ends there and only the paths' part of it when they carry on
+static bool ProjectChildren(JSON_PROJECTION *projection, const JSONLIB_LazyValue *value, JSON *json, const u32 activeCount, const u32 depth)
+{
+	const u32 *active = &projection->active[depth * projection->pathCount];
+	u32 *next = &projection->active[(depth + 1) * projection->pathCount];
+
+	// Elements past the last index any path wants don't need stepping over
+	u32 lastIndex = 0;
+	for (u32 i = 0; i < activeCount; ++i)
+	{
+		const u32 index = projection->paths[active[i]]->segments[depth].index;
+		if (index != JSON_PATH_NO_INDEX && index > lastIndex)
+			lastIndex = index;
+	}
+
+	JSONLIB_LazyValue child = *value;
+	u32 position = 0;
+	for (bool more = JSONLIB_LazyChild(&child); more; more = JSONLIB_LazyNextSibling(&child), ++position)
+	{
+		if (child.key == 0 && position > lastIndex)
+			break;
+
+		u32 nameLength = 0;
+		const char *name = child.key != 0 ? JSONLIB_LazyGetName(&child, &nameLength) : NULL;
+		if (child.key != 0 && name == NULL)
+			return false;
+
+		bool whole = false;
+		u32 nextCount = 0;
+		for (u32 i = 0; i < activeCount; ++i)
+		{
+			const JSONLIB_Path *path = projection->paths[active[i]];
+			const JSON_PATH_SEGMENT *segment = &path->segments[depth];
+			const bool matched = name != NULL ?
+				segment->key.nameLength == nameLength && memcmp(segment->key.name, name, nameLength) == 0 :
+				segment->index == position;
+			if (!matched)
+				continue;
+
+			if (depth + 1 == path->segmentCount)
+				whole = true;
+			else
+				next[nextCount++] = active[i];
+		}
+
+		// A path that carries on past a string or number leads nowhere
+		const char c = LazyTokenChar(child.document, child.token);
+		if (!whole && (nextCount == 0 || (c != '{' && c != '[')))
+			continue;
+
+		JSON *node = NULL;
+		if (whole)
+			node = JSONLIB_LazyToJSON(&child, NULL);
+		else
+		{
+			node = ParseAllocateNode(NULL, JSONnodePool, JSONthreadAllocator, NULL);
+			if (node == NULL)
+				return false;
+			node->tags = c == '{' ? JSON_OBJECT_TAG : JSON_ARRAY_TAG;
+			const bool projected = ProjectChildren(projection, &child, node, nextCount, depth + 1);
+			if (!projected || node->valueCount == 0)
+			{
+				// None of the paths through here went anywhere
+				JSONLIB_FreeJSON(node);
+				if (!projected)
+					return false;
+				continue;
+			}
+		}
+		if (node == NULL)
+			return false;
+
+		if (name != NULL)
+		{
+			char *copy = (char*)AllocateWith(NodeAllocator(node), sizeof(char) * (nameLength + 1));
+			if (copy == NULL)
+			{
+				JSONLIB_FreeJSON(node);
+				return false;
+			}
+			memcpy(copy, name, sizeof(char) * nameLength);
+			copy[nameLength] = '\0';
+			node->name = copy;
+			node->nameLength = nameLength;
+		}
+
+		if (!JSONLIB_AddValueJSON(json, node))
+		{
+			JSONLIB_FreeJSON(node);
+			return false;
+		}
+	}
+
+	// Big objects get an index just like parsed ones
+	if (HasTags(json, JSON_OBJECT_TAG) && json->valueCount >= JSON_MIN_INDEXED_MEMBER_COUNT)
+		IndexMembers(json, NULL);
+	return true;
+}
+
+// NOTE: @Jon
+// Parses only the parts of a JSON string that the paths lead to, along with the containers holding them
+JSON *JSONLIB_ParseJSONProjected(const char *jsonString, size_t stringLength, const JSONLIB_Path *const *paths, u32 pathCount)
+{
+	assert(paths != NULL || pathCount == 0);
+	JSONLIB_LazyDocument *document = JSONLIB_ParseLazy(jsonString, stringLength);
+	if (document == NULL)
+		return NULL;
+
+	JSONLIB_LazyValue root = JSONLIB_GetLazyRoot(document);
+	const char c = LazyTokenChar(document, root.token);
+
+	// An empty path wants the whole document, and a scalar document is all root
+	u32 longest = 0;
+	bool whole = c != '{' && c != '[';
+	for (u32 i = 0; i < pathCount; ++i)
+	{
+		whole = whole || paths[i]->segmentCount == 0;
+		longest = paths[i]->segmentCount > longest ? paths[i]->segmentCount : longest;
+	}
+
+	JSON *json = NULL;
+	if (whole)
+		json = JSONLIB_LazyToJSON(&root, NULL);
+	else
+	{
+		JSON_PROJECTION projection;
+		projection.paths = paths;
+		projection.pathCount = pathCount;
+		const size_t activeSize = sizeof(u32) * ((size_t)pathCount * (longest + 1) + 1);
+		projection.active = (u32*)JSON_Allocate(activeSize);
+		if (projection.active != NULL)
+		{
+			for (u32 i = 0; i < pathCount; ++i)
+				projection.active[i] = i;
+
+			json = ParseAllocateNode(NULL, JSONnodePool, JSONthreadAllocator, NULL);
+			if (json != NULL)
+			{
+				json->tags = c == '{' ? JSON_OBJECT_TAG : JSON_ARRAY_TAG;
+				if (!ProjectChildren(&projection, &root, json, pathCount, 0))
+				{
+					JSONLIB_FreeJSON(json);
+					json = NULL;
+				}
+			}
+			JSON_Deallocate(projection.active, activeSize);
+		}
+	}
+
+	JSONLIB_DestroyLazy(document);
+	return json;
+}
+
+// NOTE: @Jon
+// Push parsing
+// Structural characters drive a state machine over an explicit container stack, and every complete key or
+// scalar is handed to the same string, number and literal parsing as the recursive parser. Tokens that are
+// whole inside a chunk are parsed where they are, so only a token split across chunks is ever copied.
+
+static bool IsPushStructural(const char c)
+{
+	return c == '{' || c == '}' || c == '[' || c == ']' || c == ':' || c == ',';
+}
+
+// NOTE: @Jon
+// Finds where the token running up to iter ends, setting complete when it ends inside the chunk
+// Strings end after their closing quote, anything else at the next whitespace, structural character or quote
+static const char *FindPushTokenEnd(JSONLIB_PushParser *push, const bool string, const char *iter, const char *end, bool *complete)
+{
+	*complete = false;
+	if (!string)
+	{
+		while (iter < end && !IsWhitespace(*iter) && !IsPushStructural(*iter) && *iter != '"')
+			++iter;
+		*complete = iter < end;
+		return iter;
+	}
+
+	// An escape split across chunks still has its escaped character to skip
+	if (push->escapePending && iter < end)
+	{
+		push->escapePending = false;
+		++iter;
+	}
+
+	bool nonASCII = false;
+	while (iter < end)
+	{
+		iter = (const char*)push->kernels->scanString((const u8*)iter, (const u8*)end, &nonASCII);
+		if (iter >= end)
+			break;
+		if (*iter == '"')
+		{
+			*complete = true;
+			return iter + 1;
+		}
+		if (*iter == '\\')
+		{
+			if (end - iter < 2)
+			{
+				push->escapePending = true;
+				return end;
+			}
+			iter += 2;
+		}
+		else
+			++iter; // Control characters are rejected once the whole string is parsed
+	}
+	return end;
+}
+
+static bool CarryPushToken(JSONLIB_PushParser *push, const char *chars, const size_t length)
+{
+	if (push->carryLength + length > push->carryCapacity)
+	{
+		size_t capacity = push->carryCapacity > 0 ? push->carryCapacity * 2 : 64;
+		while (capacity < push->carryLength + length)
+			capacity *= 2;
+
+		char *expanded = (char*)ReallocateWith(&push->allocator, push->carry, sizeof(char) * push->carryCapacity, sizeof(char) * capacity);
+		if (expanded == NULL)
+			return false;
+		push->carry = expanded;
+		push->carryCapacity = capacity;
+	}
+	memcpy(&push->carry[push->carryLength], chars, sizeof(char) * length);
+	push->carryLength += length;
+	return true;
+}
+
+// NOTE: @Jon
+// Moves on after a complete value, a value at the top level finishes the document
+static void EndPushValue(JSONLIB_PushParser *push)
+{
+	push->state = push->depth > 0 ? JSON_PUSH_NEXT : JSON_PUSH_DONE;
+}
+
+// NOTE: @Jon
+// Parses the key or scalar at token, giving back where it ended or NULL if it didn't parse
+// Nothing changes when it fails, so a string that only failed for running off the chunk can be carried over
+static const char *PushToken(JSONLIB_PushParser *push, const char *token, const char *end)
+{
+	JSON_PARSER parser;
+	parser.input = token;
+	parser.cursor = token;
+	parser.end = end;
+	parser.index = NULL;
+	parser.indexPosition = 0;
+	parser.indexCount = 0;
+	parser.kernels = push->kernels;
+	parser.handler = push->handler;
+	parser.user = push->user;
+	parser.allocator = &push->allocator;
+	parser.scratch = push->scratch;
+	parser.scratchCapacity = push->scratchCapacity;
+	parser.flags = 0;
+	parser.depth = 0;
+
+	bool parsed = false;
+	if (push->state == JSON_PUSH_KEY || push->state == JSON_PUSH_FIRST_KEY)
+	{
+		u32 nameLength = 0;
+		const char *name = *token == '"' ? ParseString(&parser, &nameLength) : NULL;
+		parsed = name != NULL && (push->handler->key == NULL || push->handler->key(push->user, name, nameLength));
+		if (parsed)
+		{
+			push->scopeCounts[push->depth - 1]++;
+			push->state = JSON_PUSH_COLON;
+		}
+	}
+	else if (push->state == JSON_PUSH_VALUE || push->state == JSON_PUSH_FIRST_VALUE)
+	{
+		parsed = ParseValue(&parser);
+		if (parsed)
+		{
+			if (push->depth > 0 && push->scopes[push->depth - 1] == '[')
+				push->scopeCounts[push->depth - 1]++;
+			EndPushValue(push);
+		}
+	}
+
+	push->scratch = parser.scratch;
+	push->scratchCapacity = parser.scratchCapacity;
+	return parsed ? parser.cursor : NULL;
+}
+
+static bool PushStructural(JSONLIB_PushParser *push, const char c)
+{
+	const JSONLIB_Handler *handler = push->handler;
+	const char scope = push->depth > 0 ? push->scopes[push->depth - 1] : '\0';
+	switch (c)
+	{
+	case '{':
+	case '[':
+		if ((push->state != JSON_PUSH_VALUE && push->state != JSON_PUSH_FIRST_VALUE) || push->depth >= JSON_MAX_PARSE_DEPTH)
+			return false;
+		if (scope == '[')
+			push->scopeCounts[push->depth - 1]++;
+
+		push->scopes[push->depth] = c;
+		push->scopeCounts[push->depth] = 0;
+		push->depth++;
+		if (c == '{')
+		{
+			push->state = JSON_PUSH_FIRST_KEY;
+			return handler->startObject == NULL || handler->startObject(push->user);
+		}
+		push->state = JSON_PUSH_FIRST_VALUE;
+		return handler->startArray == NULL || handler->startArray(push->user);
+	case '}':
+	case ']':
+	{
+		const bool object = c == '}';
+		const JSON_PUSH_STATE empty = object ? JSON_PUSH_FIRST_KEY : JSON_PUSH_FIRST_VALUE;
+		if (scope != (object ? '{' : '[') || (push->state != JSON_PUSH_NEXT && push->state != empty))
+			return false;
+
+		const u32 count = push->scopeCounts[--push->depth];
+		EndPushValue(push);
+		if (object)
+			return handler->endObject == NULL || handler->endObject(push->user, count);
+		return handler->endArray == NULL || handler->endArray(push->user, count);
+	}
+	case ':':
+		if (push->state != JSON_PUSH_COLON)
+			return false;
+		push->state = JSON_PUSH_VALUE;
+		return true;
+	default:
+		if (push->state != JSON_PUSH_NEXT)
+			return false;
+		push->state = scope == '{' ? JSON_PUSH_KEY : JSON_PUSH_VALUE;
+		return true;
+	}
+}
+
+static JSONLIB_PushParser *CreatePushParserInternal(const JSONLIB_Handler *handler, void *user, JSON_DOM_BUILDER *builder)
+{
+	JSONLIB_PushParser *push = (JSONLIB_PushParser*)JSON_Allocate(sizeof(JSONLIB_PushParser));
+	if (push == NULL)
+		return NULL;
+
+	push->allocator = *CurrentAllocator();
+	push->kernels = SelectKernels();
+	push->handler = handler;
+	push->user = user;
+	push->builder = builder;
+	push->scratch = NULL;
+	push->scratchCapacity = 0;
+	push->carry = NULL;
+	push->carryLength = 0;
+	push->carryCapacity = 0;
+	push->escapePending = false;
+	push->failed = false;
+	push->state = JSON_PUSH_VALUE;
+	push->depth = 0;
+	return push;
+}
+
+// NOTE: @Jon
+// Creates a push parser that hands each token to the handler as the chunks come in
+JSONLIB_PushParser *JSONLIB_CreatePushParser(const JSONLIB_Handler *handler, void *user)
+{
+	assert(handler != NULL);
+	return CreatePushParserInternal(handler, user, NULL);
+}
+
+// NOTE: @Jon
+// Creates a push parser that builds a tree, into the arena if one is given
+JSONLIB_PushParser *JSONLIB_CreatePushParserJSON(JSONLIB_Arena *arena)
+{
+	JSON_DOM_BUILDER *builder = (JSON_DOM_BUILDER*)JSON_Allocate(sizeof(JSON_DOM_BUILDER));
+	if (builder == NULL)
+		return NULL;
+
+	// There's no input to borrow from so every name and string gets copied
+	InitDOMBuilder(builder, NULL, 0, 0, arena);
+	JSONLIB_PushParser *push = CreatePushParserInternal(&JSONdomHandler, builder, builder);
+	if (push == NULL)
+		JSON_Deallocate(builder, sizeof(JSON_DOM_BUILDER));
+	return push;
+}
+
+// NOTE: @Jon
+// Parses the next chunk of a document, the chunk can be reused as soon as this returns
+bool JSONLIB_FeedPushParser(JSONLIB_PushParser *push, const char *chunk, size_t chunkLength)
+{
+	if (push->failed)
+		return false;
+
+	const char *iter = chunk;
+	const char *end = chunk + chunkLength;
+
+	// Finish off a token the last chunk cut short
+	if (push->carryLength > 0)
+	{
+		bool complete = false;
+		const char *tokenEnd = FindPushTokenEnd(push, push->carry[0] == '"', iter, end, &complete);
+		push->failed = !CarryPushToken(push, iter, (size_t)(tokenEnd - iter));
+		if (push->failed || !complete)
+			return !push->failed;
+
+		const size_t tokenLength = push->carryLength;
+		push->carryLength = 0;
+		push->failed = PushToken(push, push->carry, push->carry + tokenLength) != push->carry + tokenLength;
+		iter = tokenEnd;
+	}
+
+	while (iter < end && !push->failed)
+	{
+		const char c = *iter;
+		if (IsWhitespace(c))
+			++iter;
+		else if (IsPushStructural(c))
+		{
+			push->failed = !PushStructural(push, c);
+			++iter;
+		}
+		else
+		{
+			// A string is parsed straight away since it can only succeed if it's whole,
+			// anything else needs its end found first so a number cut short isn't taken as finished
+			const bool string = c == '"';
+			const char *parsedEnd = string ? PushToken(push, iter, end) : NULL;
+			if (parsedEnd != NULL)
+			{
+				iter = parsedEnd;
+				continue;
+			}
+
+			bool complete = false;
+			const char *tokenEnd = FindPushTokenEnd(push, string, string ? iter + 1 : iter, end, &complete);
+			if (!complete)
+			{
+				push->failed = !CarryPushToken(push, iter, (size_t)(end - iter));
+				break;
+			}
+			push->failed = string || PushToken(push, iter, tokenEnd) != tokenEnd;
+			iter = tokenEnd;
+		}
+	}
+	return !push->failed;
+}
+
+// NOTE: @Jon
+// Ends the document, gives back false if it was malformed, incomplete or stopped by a handler
+bool JSONLIB_FinishPushParser(JSONLIB_PushParser *push)
+{
+	if (!push->failed && push->carryLength > 0)
+	{
+		// Only a number or literal can run up to the end of the document, a string is missing its closing quote
+		const size_t tokenLength = push->carryLength;
+		push->carryLength = 0;
+		push->failed = push->carry[0] == '"' || PushToken(push, push->carry, push->carry + tokenLength) != push->carry + tokenLength;
+	}
+	if (push->state != JSON_PUSH_DONE)
+		push->failed = true;
+	return !push->failed;
+}
+
+// NOTE: @Jon
+// Ends the document and hands over the tree, which can only be taken once
+JSON *JSONLIB_FinishPushParserJSON(JSONLIB_PushParser *push)
+{
+	assert(push->builder != NULL);
+	JSON *json = FinishDOMBuilder(push->builder, JSONLIB_FinishPushParser(push));
+	push->failed = true;
+	return json;
+}
+
+// NOTE: @Jon
+// Frees a push parser along with any tree it built that wasn't taken
+void JSONLIB_DestroyPushParser(JSONLIB_PushParser *push)
+{
+	if (push == NULL)
+		return;
+
+	// The allocator is copied out first since it's freed along with the parser
+	const JSONLIB_Allocator allocator = push->allocator;
+	if (push->builder != NULL)
+	{
+		FinishDOMBuilder(push->builder, false);
+		DeallocateWith(&allocator, push->builder, sizeof(JSON_DOM_BUILDER));
+	}
+	if (push->scratch != NULL)
+		DeallocateWith(&allocator, push->scratch, sizeof(char) * push->scratchCapacity);
+	if (push->carry != NULL)
+		DeallocateWith(&allocator, push->carry, sizeof(char) * push->carryCapacity);
+	DeallocateWith(&allocator, push, sizeof(JSONLIB_PushParser));
+}
+
+// NOTE: @Jon
+// Creates an arena for documents to be parsed into
+JSONLIB_Arena *JSONLIB_CreateArena(size_t blockSize)
+{
+	return JSONLIB_CreateArenaWith(blockSize, CurrentAllocator());
+}
+
+// NOTE: @Jon
+// Creates an arena that takes its blocks (and the arena itself) from the allocator
+JSONLIB_Arena *JSONLIB_CreateArenaWith(size_t blockSize, const JSONLIB_Allocator *allocator)
+{
+	assert(allocator != NULL);
+	JSONLIB_Arena *arena = (JSONLIB_Arena*)AllocateWith(allocator, sizeof(JSONLIB_Arena));
+	if (arena == NULL)
+		return NULL;
+
+	arena->first = NULL;
+	arena->current = NULL;
+	arena->blockSize = blockSize > 0 ? blockSize : JSON_DEFAULT_ARENA_BLOCK_SIZE;
+	arena->allocator = *allocator;
+	return arena;
+}
+
+// NOTE: @Jon
+// Rewinds the arena to its first block, every tree parsed into it is released
+void JSONLIB_ResetArena(JSONLIB_Arena *arena)
+{
+	arena->current = arena->first;
+	if (arena->first != NULL)
+		arena->first->used = 0;
+}
+
+// NOTE: @Jon
+// Frees every block held by the arena and the arena itself
+void JSONLIB_DestroyArena(JSONLIB_Arena *arena)
+{
+	if (arena == NULL)
+		return;
+
+	// The arena's allocator is copied out first since it's freed along with the arena
+	const JSONLIB_Allocator allocator = arena->allocator;
+	JSON_ARENA_BLOCK *block = arena->first;
+	while (block != NULL)
+	{
+		JSON_ARENA_BLOCK *next = block->next;
+		DeallocateWith(&allocator, block, sizeof(JSON_ARENA_BLOCK) + block->capacity);
+		block = next;
+	}
+	DeallocateWith(&allocator, arena, sizeof(JSONLIB_Arena));
+}
+
+// NOTE: @Jon
+// Parses a JSON string into an arena
+JSON *JSONLIB_ParseJSONArena(JSONLIB_Arena *arena, const char *jsonString, size_t stringLength)
+{
+	assert(arena != NULL);
+	return ParseJSONInternal(jsonString, stringLength, 0, arena);
+}
+
+// NOTE: @Jon
+// Threads
+// Thin wrappers over pthreads and the Win32 equivalents for the parsers that split work between threads
+
+#if defined(_WIN32)
+static DWORD WINAPI ThreadEntry(LPVOID task)
+{
+	((JSON_THREAD_TASK*)task)->work(((JSON_THREAD_TASK*)task)->context);
+	return 0;
+}
+
+static bool StartThread(JSON_THREAD *thread, JSON_THREAD_TASK *task)
+{
+	*thread = CreateThread(NULL, 0, ThreadEntry, task, 0, NULL);
+	return *thread != NULL;
+}
+
+static void JoinThread(JSON_THREAD thread)
+{
+	WaitForSingleObject(thread, INFINITE);
+	CloseHandle(thread);
+}
+
+static void InitMutex(JSON_MUTEX *mutex)
+{
+	InitializeSRWLock(mutex);
+}
+
+static void DestroyMutex(JSON_MUTEX *mutex)
+{
+	(void)mutex;
+}
+
+static void LockMutex(JSON_MUTEX *mutex)
+{
+	AcquireSRWLockExclusive(mutex);
+}
+
+static void UnlockMutex(JSON_MUTEX *mutex)
+{
+	ReleaseSRWLockExclusive(mutex);
+}
+
+static void InitCondition(JSON_CONDITION *condition)
+{
+	InitializeConditionVariable(condition);
+}
+
+static void DestroyCondition(JSON_CONDITION *condition)
+{
+	(void)condition;
+}
+
+static void WaitCondition(JSON_CONDITION *condition, JSON_MUTEX *mutex)
+{
+	SleepConditionVariableSRW(condition, mutex, INFINITE, 0);
+}
+
+static void WakeCondition(JSON_CONDITION *condition)
+{
+	WakeAllConditionVariable(condition);
+}
+
+static u32 ProcessorCount(void)
+{
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	return info.dwNumberOfProcessors > 0 ? (u32)info.dwNumberOfProcessors : 1;
+}
+#else
+static void *ThreadEntry(void *task)
+{
+	((JSON_THREAD_TASK*)task)->work(((JSON_THREAD_TASK*)task)->context);
+	return NULL;
+}
+
+static bool StartThread(JSON_THREAD *thread, JSON_THREAD_TASK *task)
+{
+	return pthread_create(thread, NULL, ThreadEntry, task) == 0;
+}
+
+static void JoinThread(JSON_THREAD thread)
+{
+	pthread_join(thread, NULL);
+}
+
+static void InitMutex(JSON_MUTEX *mutex)
+{
+	pthread_mutex_init(mutex, NULL);
+}
+
+static void DestroyMutex(JSON_MUTEX *mutex)
+{
+	pthread_mutex_destroy(mutex);
+}
+
+static void LockMutex(JSON_MUTEX *mutex)
+{
+	pthread_mutex_lock(mutex);
+}
+
+static void UnlockMutex(JSON_MUTEX *mutex)
+{
+	pthread_mutex_unlock(mutex);
+}
+
+static void InitCondition(JSON_CONDITION *condition)
+{
+	pthread_cond_init(condition, NULL);
+}
+
+static void DestroyCondition(JSON_CONDITION *condition)
+{
+	pthread_cond_destroy(condition);
+}
+
+static void WaitCondition(JSON_CONDITION *condition, JSON_MUTEX *mutex)
+{
+	pthread_cond_wait(condition, mutex);
+}
+
+static void WakeCondition(JSON_CONDITION *condition)
+{
+	pthread_cond_broadcast(condition);
+}
+
+static u32 ProcessorCount(void)
+{
+	const long count = sysconf(_SC_NPROCESSORS_ONLN);
+	return count > 0 ? (u32)count : 1;
+}
+#endif
+
+// NOTE: @Jon
+// Line delimited parsing
+// The buffer is cut into chunks of whole lines which a pool of worker threads parse, each chunk into its own
+// arena so the workers never share allocator state. Chunks are handed out and delivered in input order.
+// When streaming, only a window of chunks is in flight and their arenas are reused once delivered.
+
+// NOTE: @Jon
+// Parses every non-blank line of a chunk, a line that isn't valid JSON still gets a record (with a NULL tree)
+// Gives back false if the records couldn't grow
+static bool ParseLinesChunk(JSON_LINES_POOL *pool, JSON_LINES_CHUNK *chunk)
+{
+	const char *line = chunk->start;
+	while (line < chunk->end)
+	{
+		const char *newline = (const char*)memchr(line, '\n', (size_t)(chunk->end - line));
+		const char *first = line;
+		const char *last = newline != NULL ? newline : chunk->end;
+		line = newline != NULL ? newline + 1 : chunk->end;
+
+		// Carriage returns from CRLF files are trimmed along with any other whitespace
+		while (first < last && IsWhitespace(*first))
+			++first;
+		while (last > first && IsWhitespace(last[-1]))
+			--last;
+		if (first == last)
+			continue;
+
+		if (chunk->recordCount >= chunk->recordCapacity)
+		{
+			const u32 capacity = chunk->recordCapacity > 0 ? chunk->recordCapacity * 2 : 64;
+			JSON_LINES_RECORD *expanded = (JSON_LINES_RECORD*)ReallocateWith(&pool->allocator, chunk->records, sizeof(JSON_LINES_RECORD) * chunk->recordCapacity, sizeof(JSON_LINES_RECORD) * capacity);
+			if (expanded == NULL)
+				return false;
+			chunk->records = expanded;
+			chunk->recordCapacity = capacity;
+		}
+
+		JSON_LINES_RECORD *record = &chunk->records[chunk->recordCount++];
+		record->json = ParseJSONInternal(first, (size_t)(last - first), pool->flags, chunk->arena);
+		record->text = first;
+		record->length = (size_t)(last - first);
+	}
+	return true;
+}
+
+// NOTE: @Jon
+// Takes chunks in order until there are none left, staying within the window of the last chunk delivered
+// A chunk that fails stops any more being handed out
+static void LinesWorker(void *context)
+{
+	JSON_LINES_POOL *pool = (JSON_LINES_POOL*)context;
+	LockMutex(&pool->mutex);
+	for (;;)
+	{
+		while (!pool->stop && pool->nextChunk < pool->chunkCount && pool->window > 0 && pool->nextChunk >= pool->deliveredCount + pool->window)
+			WaitCondition(&pool->workReady, &pool->mutex);
+		if (pool->stop || pool->nextChunk >= pool->chunkCount)
+			break;
+
+		const u32 index = pool->nextChunk++;
+		UnlockMutex(&pool->mutex);
+
+		JSON_LINES_CHUNK *chunk = &pool->chunks[index];
+		chunk->arena = pool->window > 0 ? pool->slotArenas[index % pool->window] : JSONLIB_CreateArenaWith(0, &pool->allocator);
+		const bool parsed = chunk->arena != NULL && ParseLinesChunk(pool, chunk);
+
+		LockMutex(&pool->mutex);
+		chunk->done = true;
+		chunk->failed = !parsed;
+		if (!parsed)
+		{
+			pool->stop = true;
+			WakeCondition(&pool->workReady);
+		}
+		WakeCondition(&pool->chunkDone);
+	}
+	UnlockMutex(&pool->mutex);
+}
+
+// NOTE: @Jon
+// Cuts a buffer into chunks of whole lines, small buffers get smaller chunks so every thread has work
+static JSON_LINES_CHUNK *SplitLines(const JSONLIB_Allocator *allocator, const char *buffer, const size_t bufferLength, const u32 threadCount, u32 *chunkCount, size_t *chunkCapacity)
+{
+	size_t chunkSize = bufferLength / ((size_t)threadCount * 4);
+	if (chunkSize < JSON_MIN_LINES_CHUNK_SIZE)
+		chunkSize = JSON_MIN_LINES_CHUNK_SIZE;
+	if (chunkSize > JSON_MAX_LINES_CHUNK_SIZE)
+		chunkSize = JSON_MAX_LINES_CHUNK_SIZE;
+
+	// Every chunk but the last is at least chunkSize long
+	const size_t capacity = bufferLength / chunkSize + 1;
+	JSON_LINES_CHUNK *chunks = (JSON_LINES_CHUNK*)AllocateWith(allocator, sizeof(JSON_LINES_CHUNK) * capacity);
+	if (chunks == NULL)
+		return NULL;
+
+	u32 count = 0;
+	const char *start = buffer;
+	const char *end = buffer + bufferLength;
+	while (start < end)
+	{
+		const char *split = end;
+		if ((size_t)(end - start) > chunkSize)
+		{
+			const char *newline = (const char*)memchr(start + chunkSize, '\n', (size_t)(end - start - chunkSize));
+			if (newline != NULL)
+				split = newline + 1;
+		}
+
+		JSON_LINES_CHUNK *chunk = &chunks[count++];
+		chunk->start = start;
+		chunk->end = split;
+		chunk->arena = NULL;
+		chunk->records = NULL;
+		chunk->recordCount = 0;
+		chunk->recordCapacity = 0;
+		chunk->done = false;
+		chunk->failed = false;
+		start = split;
+	}
+
+	*chunkCount = count;
+	*chunkCapacity = capacity;
+	return chunks;
+}
+
+// NOTE: @Jon
+// Parses the chunks on threadCount workers, handing the records to the callback in order when there is one
+// Gives back false if the callback stopped it or a chunk ran out of memory
+static bool RunLinesPool(JSON_LINES_POOL *pool, u32 threadCount, JSON_RECORD record, void *context)
+{
+	InitMutex(&pool->mutex);
+	InitCondition(&pool->workReady);
+	InitCondition(&pool->chunkDone);
+
+	JSON_THREAD *threads = (JSON_THREAD*)JSON_Allocate(sizeof(JSON_THREAD) * threadCount);
+
+	JSON_THREAD_TASK task = { LinesWorker, pool };
+	u32 started = 0;
+	while (threads != NULL && started < threadCount && StartThread(&threads[started], &task))
+		++started;
+
+	// Without any threads (or room to keep track of them) everything is parsed up front on this one
+	if (started == 0)
+	{
+		pool->window = 0;
+		LinesWorker(pool);
+	}
+
+	bool succeeded = true;
+	for (u32 i = 0; record != NULL && i < pool->chunkCount && succeeded; ++i)
+	{
+		JSON_LINES_CHUNK *chunk = &pool->chunks[i];
+		LockMutex(&pool->mutex);
+		while (!chunk->done)
+			WaitCondition(&pool->chunkDone, &pool->mutex);
+		succeeded = !chunk->failed;
+		UnlockMutex(&pool->mutex);
+
+		for (u32 j = 0; j < chunk->recordCount && succeeded; ++j)
+			succeeded = record(context, chunk->records[j].json, chunk->records[j].text, chunk->records[j].length);
+
+		// The trees only last as long as the callback, after that their arena can take a later chunk
+		if (pool->window > 0)
+			JSONLIB_ResetArena(chunk->arena);
+
+		LockMutex(&pool->mutex);
+		pool->deliveredCount = i + 1;
+		pool->stop = pool->stop || !succeeded;
+		WakeCondition(&pool->workReady);
+		UnlockMutex(&pool->mutex);
+	}
+
+	for (u32 i = 0; i < started; ++i)
+		JoinThread(threads[i]);
+	if (threads != NULL)
+		JSON_Deallocate(threads, sizeof(JSON_THREAD) * threadCount);
+
+	DestroyCondition(&pool->chunkDone);
+	DestroyCondition(&pool->workReady);
+	DestroyMutex(&pool->mutex);
+
+	// With no callback stop is only ever set by a chunk that failed
+	return succeeded && !pool->stop;
+}
+
+// NOTE: @Jon
+// Frees every chunk's records and then the chunks, along with the chunks' arenas when each has its own
+static void FreeLinesChunks(const JSONLIB_Allocator *allocator, JSON_LINES_CHUNK *chunks, const u32 chunkCount, const size_t chunkCapacity, const bool ownArenas)
+{
+	for (u32 i = 0; i < chunkCount; ++i)
+	{
+		if (ownArenas)
+			JSONLIB_DestroyArena(chunks[i].arena);
+		if (chunks[i].records != NULL)
+			DeallocateWith(allocator, chunks[i].records, sizeof(JSON_LINES_RECORD) * chunks[i].recordCapacity);
+	}
+	DeallocateWith(allocator, chunks, sizeof(JSON_LINES_CHUNK) * chunkCapacity);
+}
+
+static bool InitLinesPool(JSON_LINES_POOL *pool, const char *buffer, const size_t bufferLength, const u32 threadCount, const u32 flags)
+{
+	pool->allocator = *CurrentAllocator();
+	pool->chunks = SplitLines(&pool->allocator, buffer, bufferLength, threadCount, &pool->chunkCount, &pool->chunkCapacity);
+	pool->nextChunk = 0;
+	pool->deliveredCount = 0;
+	pool->window = 0;
+	pool->slotArenas = NULL;
+	pool->flags = flags & ~JSON_PARSE_IN_SITU;
+	pool->stop = false;
+	return pool->chunks != NULL;
+}
+
+// NOTE: @Jon
+// Parses a newline delimited buffer on threadCount workers (0 uses one per processor)
+JSONLIB_Batch *JSONLIB_ParseNDJSON(const char *buffer, size_t bufferLength, u32 threadCount, u32 flags)
+{
+	if (threadCount == 0)
+		threadCount = ProcessorCount();
+
+	JSON_LINES_POOL pool;
+	if (!InitLinesPool(&pool, buffer, bufferLength, threadCount, flags))
+		return NULL;
+	const bool parsed = RunLinesPool(&pool, threadCount, NULL, NULL);
+
+	JSONLIB_Batch *batch = parsed ? (JSONLIB_Batch*)AllocateWith(&pool.allocator, sizeof(JSONLIB_Batch)) : NULL;
+	if (batch == NULL)
+	{
+		FreeLinesChunks(&pool.allocator, pool.chunks, pool.chunkCount, pool.chunkCapacity, true);
+		return NULL;
+	}
+	batch->allocator = pool.allocator;
+	batch->chunks = pool.chunks;
+	batch->chunkCount = pool.chunkCount;
+	batch->chunkCapacity = pool.chunkCapacity;
+	batch->rootCount = 0;
+	for (u32 i = 0; i < pool.chunkCount; ++i)
+		batch->rootCount += pool.chunks[i].recordCount;
+
+	// The roots are gathered into one array in input order
+	batch->roots = (JSON**)AllocateWith(&batch->allocator, sizeof(JSON*) * (batch->rootCount > 0 ? batch->rootCount : 1));
+	if (batch->roots == NULL)
+	{
+		JSONLIB_DestroyBatch(batch);
+		return NULL;
+	}
+	u32 root = 0;
+	for (u32 i = 0; i < pool.chunkCount; ++i)
+	{
+		for (u32 j = 0; j < pool.chunks[i].recordCount; ++j)
+			batch->roots[root++] = pool.chunks[i].records[j].json;
+	}
+	return batch;
+}
+
+u32 JSONLIB_GetBatchCount(const JSONLIB_Batch *batch)
+{
+	return batch->rootCount;
+}
+
+JSON *JSONLIB_GetBatchJSON(const JSONLIB_Batch *batch, u32 index)
+{
+	assert(index < batch->rootCount);
+	return batch->roots[index];
+}
+
+// NOTE: @Jon
+// Frees a batch, its arenas and every tree in it
+void JSONLIB_DestroyBatch(JSONLIB_Batch *batch)
+{
+	if (batch == NULL)
+		return;
+
+	// The allocator is copied out first since it's freed along with the batch
+	const JSONLIB_Allocator allocator = batch->allocator;
+	FreeLinesChunks(&allocator, batch->chunks, batch->chunkCount, batch->chunkCapacity, true);
+	if (batch->roots != NULL)
+		DeallocateWith(&allocator, batch->roots, sizeof(JSON*) * (batch->rootCount > 0 ? batch->rootCount : 1));
+	DeallocateWith(&allocator, batch, sizeof(JSONLIB_Batch));
+}
+
+// NOTE: @Jon
+// Parses a newline delimited buffer on threadCount workers, handing each record to the callback in input order
+bool JSONLIB_StreamNDJSON(const char *buffer, size_t bufferLength, u32 threadCount, u32 flags, JSON_RECORD record, void *context)
+{
+	if (threadCount == 0)
+		threadCount = ProcessorCount();
+
+	JSON_LINES_POOL pool;
+	if (!InitLinesPool(&pool, buffer, bufferLength, threadCount, flags))
+		return false;
+
+	// Enough chunks in flight to keep every worker busy while the callback catches up
+	const u32 slotCount = threadCount * 2;
+	pool.window = slotCount;
+	pool.slotArenas = (JSONLIB_Arena**)JSON_Allocate(sizeof(JSONLIB_Arena*) * slotCount);
+	bool created = pool.slotArenas != NULL;
+	for (u32 i = 0; created && i < slotCount; ++i)
+		pool.slotArenas[i] = NULL;
+	for (u32 i = 0; created && i < slotCount; ++i)
+	{
+		pool.slotArenas[i] = JSONLIB_CreateArenaWith(0, &pool.allocator);
+		created = pool.slotArenas[i] != NULL;
+	}
+
+	const bool succeeded = created && RunLinesPool(&pool, threadCount, record, context);
+
+	// When no worker could be started every chunk was parsed up front into an arena of its own
+	FreeLinesChunks(&pool.allocator, pool.chunks, pool.chunkCount, pool.chunkCapacity, pool.window == 0);
+	if (pool.slotArenas != NULL)
+	{
+		for (u32 i = 0; i < slotCount; ++i)
+			JSONLIB_DestroyArena(pool.slotArenas[i]);
+		JSON_Deallocate(pool.slotArenas, sizeof(JSONLIB_Arena*) * slotCount);
+	}
+	return succeeded;
+}
+
+// NOTE: @Jon
+// Streams a newline delimited file a block at a time, only whole lines go to the workers
+// and the partial line at the end of a block moves to the front of the next one
+bool JSONLIB_StreamNDJSONFile(const char *path, u32 threadCount, u32 flags, JSON_RECORD record, void *context)
+{
+	FILE *file = fopen(path, "rb");
+	if (file == NULL)
+		return false;
+
+	size_t capacity = JSON_LINES_FILE_BLOCK_SIZE;
+	char *block = (char*)JSON_Allocate(sizeof(char) * capacity);
+	if (block == NULL)
+	{
+		fclose(file);
+		return false;
+	}
+
+	size_t length = 0;
+	bool succeeded = true;
+	while (succeeded)
+	{
+		length += fread(block + length, sizeof(char), capacity - length, file);
+		const bool last = length < capacity;
+		if (last && ferror(file))
+		{
+			succeeded = false;
+			break;
+		}
+
+		size_t whole = length;
+		if (!last)
+		{
+			while (whole > 0 && block[whole - 1] != '\n')
+				--whole;
+
+			// A line longer than the block needs a bigger block
+			if (whole == 0)
+			{
+				char *expanded = (char*)JSON_Reallocate(block, sizeof(char) * capacity, sizeof(char) * capacity * 2);
+				if (expanded == NULL)
+				{
+					succeeded = false;
+					break;
+				}
+				block = expanded;
+				capacity *= 2;
+				continue;
+			}
+		}
+
+		succeeded = JSONLIB_StreamNDJSON(block, whole, threadCount, flags, record, context);
+		if (last)
+			break;
+
+		memmove(block, block + whole, sizeof(char) * (length - whole));
+		length -= whole;
+	}
+
+	JSON_Deallocate(block, sizeof(char) * capacity);
+	fclose(file);
+	return succeeded;
+}
+
+// NOTE: @Jon
+// Parallel parsing
+// A pre-scan over the document finds commas one level inside the root container (outside of strings), which cut
+// its members into slices that worker threads parse on their own. The subtrees are then put under the root in order.
+// Any slice that fails fails the whole parse, a slice only parses if it's a comma separated run of complete values
+// so the stitched document is always one a single threaded parse would have accepted.
+
+// NOTE: @Jon
+// Cuts the members between a root container's brackets into slices at depth one commas
+// open is the opening bracket and close the closing one, gives back the number of slices
+static u32 SplitContainer(const char *open, const char *close, const u32 sliceTarget, JSON_PARALLEL_SLICE *slices)
+{
+	const JSON_CLASSIFY_BLOCK classifyBlock = SelectKernels()->classifyBlock;
+	const size_t length = (size_t)(close - open);
+	const size_t sliceSize = length / sliceTarget;
+
+	u32 sliceCount = 0;
+	const char *sliceStart = open + 1;
+	u64 prevEscaped = 0;
+	u64 prevInString = 0;
+	i64 depth = 0;
+	for (size_t offset = 0; offset < length && sliceCount + 1 < sliceTarget; offset += 64)
+	{
+		const u8 *block = (const u8*)open + offset;
+		u8 padded[64];
+		if (length - offset < 64)
+		{
+			memset(padded, ' ', sizeof(padded));
+			memcpy(padded, block, length - offset);
+			block = padded;
+		}
+
+		JSON_BLOCK_MASKS masks;
+		classifyBlock(block, &masks);
+
+		const u64 quotes = masks.quote & ~FindEscaped(masks.backslash, &prevEscaped);
+		const u64 inString = PrefixXor(quotes) ^ prevInString;
+		prevInString = (u64)((i64)inString >> 63);
+
+		// Only brackets change the depth, colons and commas deeper down are skipped over
+		u64 ops = masks.op & ~(inString | quotes);
+		while (ops != 0)
+		{
+			const char *op = open + offset + CountTrailingZeros(ops);
+			ops &= ops - 1;
+
+			const char c = *op;
+			if (c == '[' || c == '{')
+			{
+				depth++;
+			}
+			else if (c == ']' || c == '}')
+			{
+				depth--;
+			}
+			else if (c == ',' && depth == 1 && (size_t)(op - sliceStart) >= sliceSize)
+			{
+				slices[sliceCount].start = sliceStart;
+				slices[sliceCount].end = op;
+				sliceCount++;
+				sliceStart = op + 1;
+				if (sliceCount + 1 == sliceTarget)
+					break;
+			}
+		}
+	}
+
+	slices[sliceCount].start = sliceStart;
+	slices[sliceCount].end = close;
+	return sliceCount + 1;
+}
+
+// NOTE: @Jon
+// Takes slices until there are none left, building each one's subtrees under the root
+// A slice whose values can't be kept counts as not parsed, the builder frees them
+static void ParallelWorker(void *context)
+{
+	JSON_PARALLEL_POOL *pool = (JSON_PARALLEL_POOL*)context;
+	JSONthreadAllocator = pool->allocator;
+	for (;;)
+	{
+		LockMutex(&pool->mutex);
+		const u32 index = pool->nextSlice++;
+		UnlockMutex(&pool->mutex);
+		if (index >= pool->sliceCount)
+			return;
+
+		JSON_PARALLEL_SLICE *slice = &pool->slices[index];
+		const size_t sliceLength = (size_t)(slice->end - slice->start);
+
+		JSON_DOM_BUILDER builder;
+		InitDOMBuilder(&builder, slice->start, sliceLength, pool->flags, slice->arena);
+		builder.current = pool->root;
+		slice->parsed = ParseSAXInternal(slice->start, sliceLength, pool->flags, &JSONdomHandler, &builder, pool->root->tags, builder.allocator);
+		if (slice->parsed)
+			slice->values = (JSON**)JSON_Allocate(sizeof(JSON*) * builder.stack.valueCount);
+		slice->parsed = slice->values != NULL;
+		if (slice->parsed)
+		{
+			// The values are taken off the stack so finishing the builder leaves them be
+			slice->valueCount = builder.stack.valueCount;
+			memcpy(slice->values, builder.stack.values, sizeof(JSON*) * slice->valueCount);
+			builder.stack.valueCount = 0;
+		}
+		FinishDOMBuilder(&builder, false);
+	}
+}
+
+// NOTE: @Jon
+// Parses a JSON string with threadCount threads (0 uses one per processor) when the root is a big array or object
+JSON *JSONLIB_ParseJSONParallel(const char *jsonString, size_t stringLength, u32 threadCount, u32 flags, JSONLIB_Arena *arena)
+{
+	flags &= ~JSON_PARSE_IN_SITU;
+	if (threadCount == 0)
+		threadCount = ProcessorCount();
+
+	const char *open = jsonString;
+	const char *close = jsonString + stringLength;
+	while (open < close && IsWhitespace(*open))
+		++open;
+	while (close > open && IsWhitespace(close[-1]))
+		--close;
+
+	// Anything small or without a container at the root isn't worth splitting
+	const bool array = close - open >= 2 && *open == '[' && close[-1] == ']';
+	const bool object = close - open >= 2 && *open == '{' && close[-1] == '}';
+	if (threadCount < 2 || stringLength < JSON_MIN_PARALLEL_PARSE_SIZE || (!array && !object))
+		return ParseJSONInternal(jsonString, stringLength, flags, arena);
+	--close;
+
+	u32 sliceTarget = threadCount * JSON_PARALLEL_SLICES_PER_THREAD;
+	if (stringLength / sliceTarget < JSON_MIN_PARALLEL_SLICE_SIZE)
+		sliceTarget = (u32)(stringLength / JSON_MIN_PARALLEL_SLICE_SIZE);
+
+	JSON_PARALLEL_POOL pool;
+	pool.slices = (JSON_PARALLEL_SLICE*)JSON_Allocate(sizeof(JSON_PARALLEL_SLICE) * sliceTarget);
+	if (pool.slices == NULL)
+		return NULL;
+	pool.sliceCount = SplitContainer(open, close, sliceTarget, pool.slices);
+	if (pool.sliceCount < 2)
+	{
+		JSON_Deallocate(pool.slices, sizeof(JSON_PARALLEL_SLICE) * sliceTarget);
+		return ParseJSONInternal(jsonString, stringLength, flags, arena);
+	}
+
+	pool.root = ParseAllocateNode(arena, JSONnodePool, JSONthreadAllocator, NULL);
+	bool created = pool.root != NULL;
+	pool.nextSlice = 0;
+	pool.flags = flags;
+	pool.allocator = JSONthreadAllocator;
+	for (u32 i = 0; i < pool.sliceCount; ++i)
+	{
+		// Arena slices are parsed into arenas of their own which are handed over to the caller's at the end,
+		// so they allocate the same way the caller's does
+		pool.slices[i].arena = NULL;
+		if (created && arena != NULL)
+		{
+			pool.slices[i].arena = JSONLIB_CreateArenaWith(arena->blockSize, &arena->allocator);
+			created = pool.slices[i].arena != NULL;
+		}
+		pool.slices[i].values = NULL;
+		pool.slices[i].valueCount = 0;
+		pool.slices[i].parsed = false;
+	}
+
+	if (!created)
+	{
+		for (u32 i = 0; i < pool.sliceCount; ++i)
+			JSONLIB_DestroyArena(pool.slices[i].arena);
+		JSON_Deallocate(pool.slices, sizeof(JSON_PARALLEL_SLICE) * sliceTarget);
+		if (pool.root != NULL)
+			JSONLIB_FreeJSON(pool.root);
+		return NULL;
+	}
+	pool.root->tags = array ? JSON_ARRAY_TAG : JSON_OBJECT_TAG;
+
+	// This thread takes slices along with the others, or all of them when there's no room to track any threads
+	InitMutex(&pool.mutex);
+	JSON_THREAD_TASK task = { ParallelWorker, &pool };
+	JSON_THREAD *threads = (JSON_THREAD*)JSON_Allocate(sizeof(JSON_THREAD) * (threadCount - 1));
+	u32 started = 0;
+	while (threads != NULL && started < threadCount - 1 && StartThread(&threads[started], &task))
+		++started;
+	ParallelWorker(&pool);
+	for (u32 i = 0; i < started; ++i)
+		JoinThread(threads[i]);
+	if (threads != NULL)
+		JSON_Deallocate(threads, sizeof(JSON_THREAD) * (threadCount - 1));
+	DestroyMutex(&pool.mutex);
+
+	bool parsed = true;
+	u32 valueCount = 0;
+	for (u32 i = 0; i < pool.sliceCount; ++i)
+	{
+		parsed = parsed && pool.slices[i].parsed;
+		valueCount += pool.slices[i].valueCount;
+	}
+
+	JSON *root = pool.root;
+	JSON **values = parsed ? (JSON**)ParseAllocate(arena, NodeAllocator(root), sizeof(JSON*) * valueCount) : NULL;
+	if (values != NULL)
+	{
+		root->values = values;
+		root->valueCount = valueCount;
+		root->valueCapacity = valueCount;
+	}
+
+	for (u32 i = 0; i < pool.sliceCount; ++i)
+	{
+		JSON_PARALLEL_SLICE *slice = &pool.slices[i];
+		for (u32 j = 0; j < slice->valueCount; ++j)
+		{
+			if (values != NULL)
+				*values++ = slice->values[j];
+			else
+				JSONLIB_FreeJSON(slice->values[j]);
+		}
+		if (slice->values != NULL)
+			JSON_Deallocate(slice->values, sizeof(JSON*) * slice->valueCount);
+
+		if (slice->arena != NULL && root->values != NULL)
+		{
+			// The slice's blocks go in front of the caller's current block, so later allocations never reuse them
+			JSON_ARENA_BLOCK *last = slice->arena->first;
+			while (last != NULL && last->next != NULL)
+				last = last->next;
+			if (last != NULL)
+			{
+				last->next = arena->first;
+				arena->first = slice->arena->first;
+				if (arena->current == NULL)
+					arena->current = last;
+				slice->arena->first = NULL;
+			}
+		}
+		JSONLIB_DestroyArena(slice->arena);
+	}
+	JSON_Deallocate(pool.slices, sizeof(JSON_PARALLEL_SLICE) * sliceTarget);
+
+	if (root->values == NULL)
+	{
+		JSONLIB_FreeJSON(root);
+		return NULL;
+	}
+
+	if (HasTags(root, JSON_OBJECT_TAG))
+		IndexMembers(root, arena);
+	return root;
+}
+
+// NOTE: @Jon
+// Number of decimal digits in an integer
+static u32 DigitCount(u64 value)
+{
+	u32 count = 1;
+	while (value >= 100)
+	{
+		value /= 100;
+		count += 2;
+	}
+	return count + (value >= 10);
+}
+
+// NOTE: @Jon
+// Writes the digits of an integer backwards from end, two at a time out of the digit pair table
+static void WriteDigits(char *end, u64 value)
+{
+	while (value >= 100)
+	{
+		const u32 pair = (u32)(value % 100) * 2;
+		value /= 100;
+		*--end = JSONdigitPairs[pair + 1];
+		*--end = JSONdigitPairs[pair];
+	}
+	if (value >= 10)
+	{
+		*--end = JSONdigitPairs[value * 2 + 1];
+		*--end = JSONdigitPairs[value * 2];
+	}
+	else
+		*--end = (char)('0' + value);
+}
+
+static u32 Pow5Bits(const i32 e)
+{
+	return (((u32)e * 1217359) >> 19) + 1;
+}
+
+static u32 Log10Pow2(const i32 e)
+{
+	return ((u32)e * 78913) >> 18;
+}
+
+static u32 Log10Pow5(const i32 e)
+{
+	return ((u32)e * 732923) >> 20;
+}
+
+static bool MultipleOfPowerOf5(u64 value, const u32 p)
+{
+	u32 count = 0;
+	while (value % 5 == 0)
+	{
+		value /= 5;
+		++count;
+	}
+	return count >= p;
+}
+
+static bool MultipleOfPowerOf2(const u64 value, const u32 p)
+{
+	return (value & ((1ULL << p) - 1)) == 0;
+}
+
+// NOTE: @Jon
+// (m * mul) >> j where mul is a 128 bit table entry, low word first
+static u64 MulShift64(const u64 m, const u64 *const mul, const i32 j)
+{
+	u64 high0, low0, high1, low1;
+	Multiply128(m, mul[0], &high0, &low0);
+	Multiply128(m, mul[1], &high1, &low1);
+	const u64 sumLow = low1 + high0;
+	const u64 sumHigh = high1 + (sumLow < high0);
+	const u32 shift = (u32)(j - 64);
+	return (sumHigh << (64 - shift)) | (sumLow >> shift);
+}
+
+static u32 MulShift32(const u32 m, const u64 factor, const i32 shift)
+{
+	const u64 low = (u64)m * (u32)factor;
+	const u64 high = (u64)m * (u32)(factor >> 32);
+	return (u32)(((low >> 32) + high) >> (shift - 32));
+}
+
+// NOTE: @Jon
+// Finds the shortest digits * 10^exponent that reads back as the double (Ryu)
+// Every decimal strictly between the halfway points to the neighbouring doubles reads back the same, so digits
+// are dropped from the scaled value and both bounds until the bounds would meet, then the last one is rounded
+static void ShortestDecimal64(const u64 ieeeMantissa, const u32 ieeeExponent, u64 *digits, i32 *exponent)
+{
+	i32 e2;
+	u64 m2;
+	if (ieeeExponent == 0)
+	{
+		e2 = 1 - 1023 - 52 - 2;
+		m2 = ieeeMantissa;
+	}
+	else
+	{
+		e2 = (i32)ieeeExponent - 1023 - 52 - 2;
+		m2 = (1ULL << 52) | ieeeMantissa;
+	}
+	const bool acceptBounds = (m2 & 1) == 0;
+
+	// The value and its bounds are 4 * m2 and 4 * m2 +- 2 (the lower gap halves at a power of two)
+	const u64 mv = 4 * m2;
+	const u32 mmShift = ieeeMantissa != 0 || ieeeExponent <= 1;
+
+	u64 vr, vp, vm;
+	i32 e10;
+	bool vmIsTrailingZeros = false;
+	bool vrIsTrailingZeros = false;
+	if (e2 >= 0)
+	{
+		const u32 q = Log10Pow2(e2) - (e2 > 3);
+		e10 = (i32)q;
+		const i32 k = JSON_POW5_INVERSE_BITCOUNT + (i32)Pow5Bits((i32)q) - 1;
+		const i32 i = -e2 + (i32)q + k;
+		vr = MulShift64(4 * m2, JSONpow5InverseSplit[q], i);
+		vp = MulShift64(4 * m2 + 2, JSONpow5InverseSplit[q], i);
+		vm = MulShift64(4 * m2 - 1 - mmShift, JSONpow5InverseSplit[q], i);
+		if (q <= 21)
+		{
+			// Only one of mv, mp and mm can be a multiple of 5
+			if (mv % 5 == 0)
+				vrIsTrailingZeros = MultipleOfPowerOf5(mv, q);
+			else if (acceptBounds)
+				vmIsTrailingZeros = MultipleOfPowerOf5(mv - 1 - mmShift, q);
+			else
+				vp -= MultipleOfPowerOf5(mv + 2, q);
+		}
+	}
+	else
+	{
+		const u32 q = Log10Pow5(-e2) - (-e2 > 1);
+		e10 = (i32)q + e2;
+		const i32 i = -e2 - (i32)q;
+		const i32 k = (i32)Pow5Bits(i) - JSON_POW5_BITCOUNT;
+		const i32 j = (i32)q - k;
+		vr = MulShift64(4 * m2, JSONpow5Split[i], j);
+		vp = MulShift64(4 * m2 + 2, JSONpow5Split[i], j);
+		vm = MulShift64(4 * m2 - 1 - mmShift, JSONpow5Split[i], j);
+		if (q <= 1)
+		{
+			// mv has at least q trailing zero bits so vr is exact
+			vrIsTrailingZeros = true;
+			if (acceptBounds)
+				vmIsTrailingZeros = mmShift == 1;
+			else
+				--vp;
+		}
+		else if (q < 63)
+			vrIsTrailingZeros = MultipleOfPowerOf2(mv, q);
+	}
+
+	i32 removed = 0;
+	u32 lastRemovedDigit = 0;
+	u64 output;
+	if (vmIsTrailingZeros || vrIsTrailingZeros)
+	{
+		// Rare case where the exact value of a bound or the scaled value matters for rounding
+		while (vp / 10 > vm / 10)
+		{
+			vmIsTrailingZeros &= vm % 10 == 0;
+			vrIsTrailingZeros &= lastRemovedDigit == 0;
+			lastRemovedDigit = (u32)(vr % 10);
+			vr /= 10;
+			vp /= 10;
+			vm /= 10;
+			++removed;
+		}
+		if (vmIsTrailingZeros)
+		{
+			while (vm % 10 == 0)
+			{
+				vrIsTrailingZeros &= lastRemovedDigit == 0;
+				lastRemovedDigit = (u32)(vr % 10);
+				vr /= 10;
+				vp /= 10;
+				vm /= 10;
+				++removed;
+			}
+		}
+		// Exactly halfway rounds to even
+		if (vrIsTrailingZeros && lastRemovedDigit == 5 && vr % 2 == 0)
+			lastRemovedDigit = 4;
+		output = vr + ((vr == vm && (!acceptBounds || !vmIsTrailingZeros)) || lastRemovedDigit >= 5);
+	}
+	else
+	{
+		bool roundUp = false;
+		if (vp / 100 > vm / 100)
+		{
+			roundUp = vr % 100 >= 50;
+			vr /= 100;
+			vp /= 100;
+			vm /= 100;
+			removed += 2;
+		}
+		while (vp / 10 > vm / 10)
+		{
+			roundUp = vr % 10 >= 5;
+			vr /= 10;
+			vp /= 10;
+			vm /= 10;
+			++removed;
+		}
+		output = vr + (vr == vm || roundUp);
+	}
+
+	*digits = output;
+	*exponent = e10 + removed;
+}
+
+// NOTE: @Jon
+// The same search for floats, 32 bits is enough for the scaled values
+static void ShortestDecimal32(const u32 ieeeMantissa, const u32 ieeeExponent, u32 *digits, i32 *exponent)
+{
+	i32 e2;
+	u32 m2;
+	if (ieeeExponent == 0)
+	{
+		e2 = 1 - 127 - 23 - 2;
+		m2 = ieeeMantissa;
+	}
+	else
+	{
+		e2 = (i32)ieeeExponent - 127 - 23 - 2;
+		m2 = (1u << 23) | ieeeMantissa;
+	}
+	const bool acceptBounds = (m2 & 1) == 0;
+
+	const u32 mv = 4 * m2;
+	const u32 mp = 4 * m2 + 2;
+	const u32 mmShift = ieeeMantissa != 0 || ieeeExponent <= 1;
+	const u32 mm = 4 * m2 - 1 - mmShift;
+
+	// The float shifts use the top word of the double tables
+	const i32 inverseBitcount = JSON_POW5_INVERSE_BITCOUNT - 64;
+	const i32 bitcount = JSON_POW5_BITCOUNT - 64;
+
+	u32 vr, vp, vm;
+	i32 e10;
+	bool vmIsTrailingZeros = false;
+	bool vrIsTrailingZeros = false;
+	u32 lastRemovedDigit = 0;
+	if (e2 >= 0)
+	{
+		const u32 q = Log10Pow2(e2);
+		e10 = (i32)q;
+		const i32 k = inverseBitcount + (i32)Pow5Bits((i32)q) - 1;
+		const i32 i = -e2 + (i32)q + k;
+		const u64 factor = JSONpow5InverseSplit[q][1] + 1;
+		vr = MulShift32(mv, factor, i);
+		vp = MulShift32(mp, factor, i);
+		vm = MulShift32(mm, factor, i);
+		if (q != 0 && (vp - 1) / 10 <= vm / 10)
+		{
+			// The loop below won't run but the digit it would have removed is still needed for rounding
+			const i32 l = inverseBitcount + (i32)Pow5Bits((i32)(q - 1)) - 1;
+			lastRemovedDigit = MulShift32(mv, JSONpow5InverseSplit[q - 1][1] + 1, -e2 + (i32)q - 1 + l) % 10;
+		}
+		if (q <= 9)
+		{
+			if (mv % 5 == 0)
+				vrIsTrailingZeros = MultipleOfPowerOf5(mv, q);
+			else if (acceptBounds)
+				vmIsTrailingZeros = MultipleOfPowerOf5(mm, q);
+			else
+				vp -= MultipleOfPowerOf5(mp, q);
+		}
+	}
+	else
+	{
+		const u32 q = Log10Pow5(-e2);
+		e10 = (i32)q + e2;
+		const i32 i = -e2 - (i32)q;
+		const i32 k = (i32)Pow5Bits(i) - bitcount;
+		i32 j = (i32)q - k;
+		vr = MulShift32(mv, JSONpow5Split[i][1], j);
+		vp = MulShift32(mp, JSONpow5Split[i][1], j);
+		vm = MulShift32(mm, JSONpow5Split[i][1], j);
+		if (q != 0 && (vp - 1) / 10 <= vm / 10)
+		{
+			j = (i32)q - 1 - ((i32)Pow5Bits(i + 1) - bitcount);
+			lastRemovedDigit = MulShift32(mv, JSONpow5Split[i + 1][1], j) % 10;
+		}
+		if (q <= 1)
+		{
+			vrIsTrailingZeros = true;
+			if (acceptBounds)
+				vmIsTrailingZeros = mmShift == 1;
+			else
+				--vp;
+		}
+		else if (q < 31)
+			vrIsTrailingZeros = MultipleOfPowerOf2(mv, q - 1);
+	}
+
+	i32 removed = 0;
+	u32 output;
+	if (vmIsTrailingZeros || vrIsTrailingZeros)
+	{
+		while (vp / 10 > vm / 10)
+		{
+			vmIsTrailingZeros &= vm % 10 == 0;
+			vrIsTrailingZeros &= lastRemovedDigit == 0;
+			lastRemovedDigit = vr % 10;
+			vr /= 10;
+			vp /= 10;
+			vm /= 10;
+			++removed;
+		}
+		if (vmIsTrailingZeros)
+		{
+			while (vm % 10 == 0)
 			{
-				JSONLIB_AddValueJSON(json, NULL);
-				JSON* newVal = (JSON*)JSON_Allocate(sizeof(JSON));
-				newVal->parent = json;
-				assert(json->values != NULL);
-				json->values[json->valueCount - 1] = newVal;
-				newVal->name = NULL;
-				newVal->valueCount = 0;
-				json = newVal;
+				vrIsTrailingZeros &= lastRemovedDigit == 0;
+				lastRemovedDigit = vr % 10;
+				vr /= 10;
+				vp /= 10;
+				vm /= 10;
+				++removed;
 			}
+		}
+		if (vrIsTrailingZeros && lastRemovedDigit == 5 && vr % 2 == 0)
+			lastRemovedDigit = 4;
+		output = vr + ((vr == vm && (!acceptBounds || !vmIsTrailingZeros)) || lastRemovedDigit >= 5);
+	}
+	else
+	{
+		while (vp / 10 > vm / 10)
+		{
+			lastRemovedDigit = vr % 10;
+			vr /= 10;
+			vp /= 10;
+			vm /= 10;
+			++removed;
+		}
+		output = vr + (vr == vm || lastRemovedDigit >= 5);
+	}
+
+	*digits = output;
+	*exponent = e10 + removed;
+}
+
+// NOTE: @Jon
+// Lays out digits * 10^exponent the way JavaScript does: plain notation for up to 21 integer digits or
+// down to 1e-7, scientific otherwise, and whole numbers keep a ".0" so they're still decimals when parsed again
+static char *WriteDecimalDigits(char *dest, u64 digits, const i32 exponent)
+{
+	char text[20];
+	i32 length = 0;
+	do
+	{
+		text[19 - length++] = (char)('0' + digits % 10);
+		digits /= 10;
+	} while (digits != 0);
+	const char *first = &text[20 - length];
+
+	const i32 point = length + exponent;
+	if (exponent >= 0 && point <= 21)
+	{
+		memcpy(dest, first, (size_t)length);
+		dest += length;
+		memset(dest, '0', (size_t)exponent);
+		dest += exponent;
+		*dest++ = '.';
+		*dest++ = '0';
+	}
+	else if (point > 0 && point <= 21)
+	{
+		memcpy(dest, first, (size_t)point);
+		dest += point;
+		*dest++ = '.';
+		memcpy(dest, first + point, (size_t)(length - point));
+		dest += length - point;
+	}
+	else if (point > -6 && point <= 0)
+	{
+		*dest++ = '0';
+		*dest++ = '.';
+		memset(dest, '0', (size_t)-point);
+		dest += -point;
+		memcpy(dest, first, (size_t)length);
+		dest += length;
+	}
+	else
+	{
+		*dest++ = first[0];
+		if (length > 1)
+		{
+			*dest++ = '.';
+			memcpy(dest, first + 1, (size_t)(length - 1));
+			dest += length - 1;
+		}
+		*dest++ = 'e';
+		i32 scientific = point - 1;
+		if (scientific < 0)
+		{
+			*dest++ = '-';
+			scientific = -scientific;
+		}
+		if (scientific >= 100)
+			*dest++ = (char)('0' + scientific / 100);
+		if (scientific >= 10)
+			*dest++ = (char)('0' + scientific / 10 % 10);
+		*dest++ = (char)('0' + scientific % 10);
+	}
+	return dest;
+}
+
+// NOTE: @Jon
+// Writes the shortest text that reads back as the same double, giving back the end of what was written
+// JSON has no infinities or NaNs so they're written as null
+static char *WriteDecimal64(char *dest, const f64 decimal)
+{
+	u64 bits;
+	memcpy(&bits, &decimal, sizeof(bits));
+	const u64 mantissa = bits & ((1ULL << 52) - 1);
+	const u32 exponent = (u32)(bits >> 52) & 0x7FF;
+	if (exponent == 0x7FF)
+	{
+		memcpy(dest, JSONnullStr, 4);
+		return dest + 4;
+	}
+
+	if (bits >> 63)
+		*dest++ = '-';
+	if (exponent == 0 && mantissa == 0)
+		return WriteDecimalDigits(dest, 0, 0);
+
+	u64 digits;
+	i32 decimalExponent;
+	ShortestDecimal64(mantissa, exponent, &digits, &decimalExponent);
+	return WriteDecimalDigits(dest, digits, decimalExponent);
+}
+
+static char *WriteDecimal32(char *dest, const f32 decimal)
+{
+	u32 bits;
+	memcpy(&bits, &decimal, sizeof(bits));
+	const u32 mantissa = bits & ((1u << 23) - 1);
+	const u32 exponent = (bits >> 23) & 0xFF;
+	if (exponent == 0xFF)
+	{
+		memcpy(dest, JSONnullStr, 4);
+		return dest + 4;
+	}
+
+	if (bits >> 31)
+		*dest++ = '-';
+	if (exponent == 0 && mantissa == 0)
+		return WriteDecimalDigits(dest, 0, 0);
+
+	u32 digits;
+	i32 decimalExponent;
+	ShortestDecimal32(mantissa, exponent, &digits, &decimalExponent);
+	return WriteDecimalDigits(dest, digits, decimalExponent);
+}
+
+// NOTE: @Jon
+// Gives back the double nearest to the shortest text of a float, so 0.1f widens to 0.1 rather than 0.10000000149011612
+static f64 WidenDecimal32(const f32 decimal)
+{
+	u32 bits;
+	memcpy(&bits, &decimal, sizeof(bits));
+	const u32 mantissa = bits & ((1u << 23) - 1);
+	const u32 exponent = (bits >> 23) & 0xFF;
+	if (exponent == 0xFF || (exponent == 0 && mantissa == 0))
+		return (f64)decimal;
+
+	u32 digits;
+	i32 decimalExponent;
+	ShortestDecimal32(mantissa, exponent, &digits, &decimalExponent);
+	const f64 widened = ComputeFloat64(digits, decimalExponent);
+	return (bits >> 31) ? -widened : widened;
+}
+
+// NOTE: @Jon
+// Gets the short escape sequence character for a character that has one
+static char ShortEscapeCharacter(const char c)
+{
+	switch (c)
+	{
+	case '"': return '"';
+	case '\\': return '\\';
+	case '\b': return 'b';
+	case '\f': return 'f';
+	case '\n': return 'n';
+	case '\r': return 'r';
+	case '\t': return 't';
+	default: return '\0';
+	}
+}
+
+// NOTE: @Jon
+// Gets the length of a string once quotes, backslashes and control characters are escaped
+static size_t EscapedStringLength(const char *str, const u32 strLen)
+{
+	size_t length = strLen;
+	for (u32 i = 0; i < strLen; ++i)
+	{
+		if (ShortEscapeCharacter(str[i]) != '\0')
+			length += 1;
+		else if ((u8)str[i] < 0x20)
+			length += 5;
+	}
+	return length;
+}
+
+// NOTE: @Jon
+// Writes a string out with its escape sequences, giving back the end of what was written
+static char *EscapeString(char *dest, const char *str, const u32 strLen)
+{
+	static const char hexDigits[] = "0123456789abcdef";
+	for (u32 i = 0; i < strLen; ++i)
+	{
+		const char escape = ShortEscapeCharacter(str[i]);
+		if (escape != '\0')
+		{
+			*dest++ = '\\';
+			*dest++ = escape;
+		}
+		else if ((u8)str[i] < 0x20)
+		{
+			*dest++ = '\\';
+			*dest++ = 'u';
+			*dest++ = '0';
+			*dest++ = '0';
+			*dest++ = hexDigits[(u8)str[i] >> 4];
+			*dest++ = hexDigits[(u8)str[i] & 0xF];
+		}
+		else
+			*dest++ = str[i];
+	}
+	return dest;
+}
+
+// NOTE: @Jon
+// Gives back where size bytes can be written, or NULL once the output doesn't fit (it's still counted)
+static char *ReserveString(JSON_STRING_STRUCT *str, const size_t size)
+{
+	char *dest = str->length + size <= str->capacity ? &str->raw[str->length] : NULL;
+	str->length += size;
+	return dest;
+}
+
+static void AppendCharToString(JSON_STRING_STRUCT *str, const char c)
+{
+	char *dest = ReserveString(str, 1);
+	if (dest != NULL)
+		*dest = c;
+}
+
+static void AppendStringToString(JSON_STRING_STRUCT *str, const char *chars, const u32 charsLen)
+{
+	char *dest = ReserveString(str, charsLen);
+	if (dest != NULL)
+		memcpy(dest, chars, sizeof(char) * charsLen);
+}
+
+static void AppendQuotedToString(JSON_STRING_STRUCT *str, const char *chars, const u32 charsLen)
+{
+	const size_t escapedLength = EscapedStringLength(chars, charsLen);
+	char *dest = ReserveString(str, escapedLength + 2);
+	if (dest == NULL)
+		return;
+
+	dest[0] = dest[escapedLength + 1] = '\"';
+	if (escapedLength == charsLen)
+		memcpy(&dest[1], chars, sizeof(char) * charsLen);
+	else
+		EscapeString(&dest[1], chars, charsLen);
+}
+
+static void AppendIntegerToString(JSON_STRING_STRUCT *str, const u64 magnitude, const bool negative)
+{
+	const u32 digits = DigitCount(magnitude);
+	char *dest = ReserveString(str, digits + negative);
+	if (dest == NULL)
+		return;
+
+	if (negative)
+		*dest++ = '-';
+	WriteDigits(dest + digits, magnitude);
+}
+
+// NOTE: @Jon
+// A decimal's length isn't known until it's written, so it goes through scratch space when it might not fit
+static void AppendDecimalToString(JSON_STRING_STRUCT *str, const JSON *json)
+{
+	// Sizing for an allocation only needs an upper bound, which saves formatting every decimal twice
+	if (str->boundDecimals)
+	{
+		str->length += JSON_MAX_DECIMAL_LENGTH;
+		return;
+	}
+
+	char scratch[JSON_MAX_DECIMAL_LENGTH];
+	const bool direct = str->length + JSON_MAX_DECIMAL_LENGTH <= str->capacity;
+	char *start = direct ? &str->raw[str->length] : scratch;
+	char *end = HasTags(json, JSON_DECIMAL64_TAG) ? WriteDecimal64(start, json->decimal64) : WriteDecimal32(start, json->decimal);
+
+	const u32 length = (u32)(end - start);
+	if (direct)
+		str->length += length;
+	else
+		AppendStringToString(str, scratch, length);
+}
+
+static void MakeValueString(JSON_STRING_STRUCT *str, const JSON *json)
+{
+	// The widest member holding the exact value is the one written out
+	if (HasTags(json, JSON_DECIMAL_TAG | JSON_DECIMAL64_TAG))
+		AppendDecimalToString(str, json);
+	else if (HasTags(json, JSON_INTEGER64_TAG))
+		AppendIntegerToString(str, json->integer64 < 0 ? 0 - (u64)json->integer64 : (u64)json->integer64, json->integer64 < 0);
+	else if (HasTags(json, JSON_UNSIGNED64_TAG))
+		AppendIntegerToString(str, json->unsigned64, false);
+	else if (HasTags(json, JSON_INTEGER_TAG))
+		AppendIntegerToString(str, json->integer < 0 ? 0 - (u64)(i64)json->integer : (u64)json->integer, json->integer < 0);
+	else if (HasTags(json, JSON_BOOLEAN_TAG))
+		AppendStringToString(str, json->boolean ? JSONtrueStr : JSONfalseStr, json->boolean ? 4 : 5);
+	else if (HasTags(json, JSON_NULL_TAG))
+		AppendStringToString(str, JSONnullStr, 4);
+	else if (HasTags(json, JSON_STRING_TAG))
+		AppendQuotedToString(str, json->string, json->stringLength);
+}
+
+static void MakeJSONInternal(JSON_STRING_STRUCT *str, const JSON *const json, const bool humanReadable)
+{
+	// Object members always get their name written, even when it's empty
+	if (json->name != NULL && (json->nameLength > 0 || (json->parent != NULL && HasTags(json->parent, JSON_OBJECT_TAG))))
+	{
+		AppendQuotedToString(str, json->name, json->nameLength);
+		AppendCharToString(str, ':');
+	}
+
+	if (HasTags(json, JSON_OBJECT_TAG))
+		AppendCharToString(str, '{');
+	else if (HasTags(json, JSON_ARRAY_TAG))
+		AppendCharToString(str, '[');
 
-			// Go one layer deeper to parse an object
-			ParseJSONInternal(&tokens[i], offset + 1, stack, JSON_OBJECT_TAG, json);
-			i += offset;
-			json->tags = 0; json->tags |= JSON_OBJECT_TAG;
-			json = json->parent;
-			break;
-		}
-		case LEFT_SQUARE_BRACKET:
+	if (json->valueCount > 0)
+	{
+		for (u32 i = 0; i < json->valueCount; ++i)
 		{
-			u32 offset = GetCloserOffset(&tokens[i], 0, tokenCount - i, stack, LEFT_SQUARE_BRACKET, RIGHT_SQUARE_BRACKET);
+			MakeJSONInternal(str, json->values[i], humanReadable);
 
-			if (offset == -1)
-			{
-				finished = false;
-				break;
-			}
-			assert(json != NULL);
+			if (i != json->valueCount - 1)
+				AppendCharToString(str, ',');
 
-			json->tags = 0; json->tags |= JSON_ARRAY_TAG;
-			// Go one layer deeper to parse an array
-			ParseJSONInternal(&tokens[i], offset + 1, stack, JSON_ARRAY_TAG, json);
-			i += offset;
-			json = json->parent;
-			break;
-		}
-		case RIGHT_BRACE:
-			break;
-		case IDENTIFIER:
-		{
-			// Allocate a node for this identifier
-			JSON *val = (JSON*)JSON_Allocate(sizeof(JSON));
-			JSONLIB_AddValueJSON (json, val);
-			assert(json->values != NULL);
-			json = val;
-
-			json->name = tokens[i].identifier;
-			json->values = NULL;
-			json->valueCount = 0;
-			json->tags = 0;
-			break;
-		}
-		case COLON:
-			// If we see a colon the next token *should* be a value
-			break;
-		case STRING:
-		{
-			if (HasTags(json, JSON_ARRAY_TAG))
-				AddValueToArray(&json);
-			// Add a string value to the node
-			AddStringValue(&json, tokens[i].identifier);
-			break;
-		}
-		case INTEGER:
-		{
-			if (HasTags(json, JSON_ARRAY_TAG))
-				AddValueToArray(&json);
-			// Add an integer value to the node
-			AddIntegerValue(&json, tokens[i].identifier);
-			break;
-		}
-		case FLOAT:
-		{
-			if (HasTags(json, JSON_ARRAY_TAG))
-				AddValueToArray(&json);
-			// Add a float value to the node
-			AddDecimalValue(&json, tokens[i].identifier);
-			break;
-		}
-		case JSON_TRUE:
-		case JSON_FALSE:
-		{
-			if (HasTags(json, JSON_ARRAY_TAG))
-				AddValueToArray(&json);
-			// Add a boolean value to the node
-			AddBooleanValue(&json, tokens[i].type == JSON_TRUE);
-			break;
-		}
-		case JSON_NULL:
-		{
-			if (HasTags(json, JSON_ARRAY_TAG))
-				AddValueToArray(&json);
-			// Add a null value to the node
-			AddNullValue(&json);
-			break;
-		}
-		default: break;
+			if (humanReadable)
+				AppendCharToString(str, '\n');
 		}
 	}
+	else
+		MakeValueString(str, json);
+
+	if (HasTags(json, JSON_OBJECT_TAG))
+		AppendCharToString(str, '}');
+	else if (HasTags(json, JSON_ARRAY_TAG))
+		AppendCharToString(str, ']');
+}
 
-	if (finished)
-		return json;
+// NOTE: @Jon
+// Makes a JSON string from a given tree input
+// The tree is sized first so the output is a single allocation, exact apart from any decimals
+const char * JSONLIB_MakeJSON(const JSON * const json, const bool humanReadable)
+{
+	JSON_STRING_STRUCT jsonString;
+	jsonString.raw = NULL;
+	jsonString.length = 0;
+	jsonString.capacity = 0;
+	jsonString.boundDecimals = true;
 
-	JSONLIB_FreeJSON(json);
-	return NULL;
+	MakeJSONInternal(&jsonString, json, humanReadable);
+
+	jsonString.capacity = jsonString.length + 1;
+	jsonString.raw = (char*)JSON_Allocate(sizeof(char) * jsonString.capacity);
+	assert(jsonString.raw != NULL);
+	jsonString.length = 0;
+	jsonString.boundDecimals = false;
+
+	MakeJSONInternal(&jsonString, json, humanReadable);
+
+	// Strings are freed by their length, so any room left by short decimals is given back
+	if (jsonString.length + 1 < jsonString.capacity)
+	{
+		jsonString.raw = (char*)JSON_Reallocate(jsonString.raw, sizeof(char) * jsonString.capacity, sizeof(char) * (jsonString.length + 1));
+		assert(jsonString.raw != NULL);
+	}
+	jsonString.raw[jsonString.length] = '\0';
+	return jsonString.raw;
 }
 
 // NOTE: @Jon
-// Sets the allocation functions for the library to use internally
-void JSONLIB_SetAllocator(JSON_ALLOC alloc, JSON_DEALLOC dealloc)
+// Gets the length of the string JSONLIB_MakeJSON would make, without the NUL terminator
+size_t JSONLIB_MeasureJSON(const JSON *const json, const u32 flags)
 {
-	JSON_Allocate = alloc;
-	JSON_Deallocate = dealloc;
+	JSON_STRING_STRUCT jsonString;
+	jsonString.raw = NULL;
+	jsonString.length = 0;
+	jsonString.capacity = 0;
+	jsonString.boundDecimals = false;
+
+	MakeJSONInternal(&jsonString, json, (flags & JSON_MAKE_HUMAN_READABLE) != 0);
+	return jsonString.length;
 }
 
 // NOTE: @Jon
-// Convenience function for freeing memory
-static void FreeTokenAndStackMemory(JSON_TOKENS *tokens, JSON_DIVIDER_STACK *stack)
+// Writes a tree into the given buffer without allocating
+size_t JSONLIB_MakeJSONInto(const JSON *const json, char *buffer, const size_t capacity, const u32 flags)
 {
-	for (u32 i = 0; i < tokens->tokenCount; ++i)
-	{
-		if (tokens->tokens[i].identifier != NULL)
-			JSON_Deallocate(tokens->tokens[i].identifier);
-	}
-	JSON_Deallocate(tokens->tokens);
-	JSON_Deallocate(tokens);
+	JSON_STRING_STRUCT jsonString;
+	jsonString.raw = buffer;
+	jsonString.length = 0;
+	jsonString.capacity = capacity;
+	jsonString.boundDecimals = false;
 
-	JSON_Deallocate(stack->dividerStack);
+	MakeJSONInternal(&jsonString, json, (flags & JSON_MAKE_HUMAN_READABLE) != 0);
+
+	// Like snprintf, a length that doesn't leave room for the terminator means the output was cut short
+	if (jsonString.length < capacity)
+		buffer[jsonString.length] = '\0';
+	return jsonString.length;
 }
 
 // NOTE: @Jon
-// Parses a JSON string
-JSON *JSONLIB_ParseJSON(const char *jsonString, u32 stringLength)
+// Streaming writer
+// Values go into a fixed buffer that's handed to the write callback whenever it fills up, so a document
+// never has to exist as a tree or as one string. Separators and newlines match JSONLIB_MakeJSON.
+
+// NOTE: @Jon
+// Hands everything buffered to the callback, a callback that fails stops all writing after it
+static void FlushWriterBuffer(JSONLIB_Writer *writer)
 {
-	JSON_DIVIDER_STACK stack;
-	stack.dividerStack = (char*)JSON_Allocate(sizeof(char) * JSON_DEFAULT_DIVIDER_STACK_SIZE);
-	stack.dividerCount = 0;
-	stack.dividerCapacity = JSON_DEFAULT_DIVIDER_STACK_SIZE;
+	if (writer->buffer.length > 0 && !writer->failed)
+		writer->failed = !writer->write(writer->context, writer->buffer.raw, (u32)writer->buffer.length);
+	writer->buffer.length = 0;
+}
 
-	JSON_TOKENS *tokens = Tokenise(jsonString, stringLength, &stack);
+// NOTE: @Jon
+// Makes room for size bytes in the buffer, size can't be more than the buffer holds
+static JSON_STRING_STRUCT *WriterSpace(JSONLIB_Writer *writer, const u32 size)
+{
+	if (writer->buffer.length + size > writer->buffer.capacity)
+		FlushWriterBuffer(writer);
+	return &writer->buffer;
+}
 
-	if (stack.dividerCount != 0)
+// NOTE: @Jon
+// Writes a separator ahead of a new value, a key and its value count as one
+static void BeginWriterValue(JSONLIB_Writer *writer)
+{
+	if (writer->afterKey)
 	{
-		FreeTokenAndStackMemory(tokens, &stack);
-		return NULL;
+		writer->afterKey = false;
+		return;
 	}
 
-	if (!CorrectTokens(tokens, &stack))
+	u32 *count = writer->depth > 0 ? &writer->scopeValueCounts[writer->depth - 1] : &writer->valueCount;
+	assert(writer->depth == 0 || writer->scopes[writer->depth - 1] == '[');
+
+	// Top level values are put on their own lines
+	if (*count > 0)
 	{
-		FreeTokenAndStackMemory(tokens, &stack);
-		return NULL;
+		if (writer->depth > 0)
+			AppendCharToString(WriterSpace(writer, 1), ',');
+		if (writer->humanReadable || writer->depth == 0)
+			AppendCharToString(WriterSpace(writer, 1), '\n');
 	}
+	++*count;
+}
 
-	JSON *json = ParseJSONInternal(tokens->tokens, tokens->tokenCount, &stack, JSON_OBJECT_TAG, NULL);
-
-	if (json == NULL)
+static void WriterAppendString(JSONLIB_Writer *writer, const char *chars, const u32 charsLen)
+{
+	// Long strings go out a piece at a time, escaping makes a piece up to six times bigger
+	const u32 pieceSize = (u32)(writer->buffer.capacity / 6);
+	for (u32 i = 0; i < charsLen; i += pieceSize)
 	{
-		FreeTokenAndStackMemory(tokens, &stack);
-		return NULL;
+		const u32 pieceLength = charsLen - i < pieceSize ? charsLen - i : pieceSize;
+		const u32 escapedLength = (u32)EscapedStringLength(&chars[i], pieceLength);
+		char *dest = ReserveString(WriterSpace(writer, escapedLength), escapedLength);
+		if (escapedLength == pieceLength)
+			memcpy(dest, &chars[i], sizeof(char) * pieceLength);
+		else
+			EscapeString(dest, &chars[i], pieceLength);
 	}
+}
 
-	JSON_Deallocate(tokens->tokens);
+static void WriterAppendQuoted(JSONLIB_Writer *writer, const char *chars, const u32 charsLen)
+{
+	AppendCharToString(WriterSpace(writer, 1), '\"');
+	WriterAppendString(writer, chars, charsLen);
+	AppendCharToString(WriterSpace(writer, 1), '\"');
+}
 
-	JSON_Deallocate(tokens);
+static void BeginWriterScope(JSONLIB_Writer *writer, const char open)
+{
+	BeginWriterValue(writer);
+	assert(writer->depth < JSON_MAX_WRITER_DEPTH);
+	writer->scopes[writer->depth] = open;
+	writer->scopeValueCounts[writer->depth] = 0;
+	++writer->depth;
+	AppendCharToString(WriterSpace(writer, 1), open);
+}
 
-	JSON_Deallocate(stack.dividerStack);
+static void EndWriterScope(JSONLIB_Writer *writer, const char open, const char close)
+{
+	assert(writer->depth > 0 && writer->scopes[writer->depth - 1] == open && !writer->afterKey);
+	--writer->depth;
+	if (writer->humanReadable && writer->scopeValueCounts[writer->depth] > 0)
+		AppendCharToString(WriterSpace(writer, 1), '\n');
+	AppendCharToString(WriterSpace(writer, 1), close);
+}
 
-	return json;
+// NOTE: @Jon
+// Creates a writer that hands its output to write in chunks of up to bufferSize bytes (0 uses the default)
+JSONLIB_Writer *JSONLIB_CreateWriter(JSON_WRITE write, void *context, u32 bufferSize, const u32 flags)
+{
+	return JSONLIB_CreateWriterWith(write, context, bufferSize, flags, CurrentAllocator());
 }
 
-static const char *DecimalValueToString(char *dest, const f32 decimal, const u32 stringSize)
+// NOTE: @Jon
+// Creates a writer whose buffer (and the writer itself) come from a copy of the given allocator
+JSONLIB_Writer *JSONLIB_CreateWriterWith(JSON_WRITE write, void *context, u32 bufferSize, const u32 flags, const JSONLIB_Allocator *allocator)
 {
-	snprintf(dest, sizeof(char) * stringSize, "%f", decimal);
-	return dest;
+	assert(write != NULL);
+	if (bufferSize == 0)
+		bufferSize = JSON_DEFAULT_WRITER_BUFFER_SIZE;
+	// Numbers are written whole so the buffer has to hold the longest one
+	if (bufferSize < JSON_MAX_DECIMAL_LENGTH * 2)
+		bufferSize = JSON_MAX_DECIMAL_LENGTH * 2;
+
+	JSONLIB_Writer *writer = (JSONLIB_Writer*)AllocateWith(allocator, sizeof(JSONLIB_Writer));
+	if (writer == NULL)
+		return NULL;
+
+	writer->buffer.raw = (char*)AllocateWith(allocator, sizeof(char) * bufferSize);
+	if (writer->buffer.raw == NULL)
+	{
+		DeallocateWith(allocator, writer, sizeof(JSONLIB_Writer));
+		return NULL;
+	}
+	writer->allocator = *allocator;
+	writer->buffer.length = 0;
+	writer->buffer.capacity = bufferSize;
+	writer->buffer.boundDecimals = false;
+	writer->write = write;
+	writer->context = context;
+	writer->depth = 0;
+	writer->valueCount = 0;
+	writer->humanReadable = (flags & JSON_MAKE_HUMAN_READABLE) != 0;
+	writer->afterKey = false;
+	writer->failed = false;
+	return writer;
 }
 
-static const char *IntegerValueToString(char *dest, const i32 integer, const u32 stringSize)
+// NOTE: @Jon
+// Writes out whatever is buffered, gives back false if any write so far has failed
+bool JSONLIB_FlushWriter(JSONLIB_Writer *writer)
 {
-	snprintf(dest, sizeof(char) * stringSize, "%d", integer);
-	return dest;
+	FlushWriterBuffer(writer);
+	return !writer->failed;
 }
 
-static const char* BooleanValueToString(char* dest, const bool boolean)
+// NOTE: @Jon
+// Flushes and frees a writer, gives back false if any write failed
+bool JSONLIB_DestroyWriter(JSONLIB_Writer *writer)
 {
-	const char* copy = boolean ? JSONtrueStr : JSONfalseStr;
-	u32 len = boolean ? 5 : 6;
-	memcpy(dest, copy, sizeof(char) * len);
-	return dest;
+	if (writer == NULL)
+		return false;
+
+	// The allocator is copied out first since it's freed along with the writer
+	const bool succeeded = JSONLIB_FlushWriter(writer);
+	const JSONLIB_Allocator allocator = writer->allocator;
+	DeallocateWith(&allocator, writer->buffer.raw, sizeof(char) * writer->buffer.capacity);
+	DeallocateWith(&allocator, writer, sizeof(JSONLIB_Writer));
+	return succeeded;
 }
 
-static const char* NullValueToString(char* dest)
+void JSONLIB_BeginObject(JSONLIB_Writer *writer)
 {
-	memcpy(dest, JSONnullStr, sizeof(char) * 5);
-	return dest;
+	BeginWriterScope(writer, '{');
+}
+
+void JSONLIB_EndObject(JSONLIB_Writer *writer)
+{
+	EndWriterScope(writer, '{', '}');
 }
 
-static char *MakeStringValueString(const char *str, const u32 strLen)
+void JSONLIB_BeginArray(JSONLIB_Writer *writer)
 {
-	char *memberNameString = (char*)JSON_Allocate(sizeof(char) * strLen + 3);
-	memberNameString[0] = memberNameString[strLen + 1] = '\"';
-	memberNameString[strLen + 2] = '\0';
-	memcpy(&memberNameString[1], str, sizeof(char) * strLen);
-	return memberNameString;
+	BeginWriterScope(writer, '[');
 }
 
-static char *MakeValueString(const JSON *json, const u32 stringSize, JSON_DIVIDER_STACK *stack)
+void JSONLIB_EndArray(JSONLIB_Writer *writer)
 {
-	char *valueString = NULL;
+	EndWriterScope(writer, '[', ']');
+}
 
-	if (HasTags(json, JSON_DECIMAL_TAG | JSON_INTEGER_TAG | JSON_BOOLEAN_TAG | JSON_NULL_TAG))
-		valueString = (char*)JSON_Allocate(sizeof(char) * stringSize);
+// NOTE: @Jon
+// Writes the name of the next object member, its value has to be written next
+void JSONLIB_WriteKey(JSONLIB_Writer *writer, const char *name, const u32 nameLength)
+{
+	assert(writer->depth > 0 && writer->scopes[writer->depth - 1] == '{' && !writer->afterKey);
 
-	if (HasTags(json, JSON_DECIMAL_TAG))
-		DecimalValueToString(valueString, json->decimal, stringSize);
-	else if (HasTags(json, JSON_INTEGER_TAG))
-		IntegerValueToString(valueString, json->integer, stringSize);
-	else if (HasTags(json, JSON_BOOLEAN_TAG))
-		BooleanValueToString(valueString, json->boolean);
-	else if (HasTags(json, JSON_NULL_TAG))
-		NullValueToString(valueString);
-	else if (HasTags(json, JSON_STRING_TAG))
+	u32 *count = &writer->scopeValueCounts[writer->depth - 1];
+	if (*count > 0)
 	{
-		const u32 valueStrLen = (u32)strlen(json->string);
-		valueString = MakeStringValueString(json->string, valueStrLen);
+		AppendCharToString(WriterSpace(writer, 1), ',');
+		if (writer->humanReadable)
+			AppendCharToString(WriterSpace(writer, 1), '\n');
 	}
-	
-	return valueString;
+	++*count;
+
+	WriterAppendQuoted(writer, name, nameLength);
+	AppendCharToString(WriterSpace(writer, 1), ':');
+	writer->afterKey = true;
 }
 
-static bool StringCapacityHelper(JSON_STRING_STRUCT *str, u32 potentialAllocation)
+void JSONLIB_WriteInteger(JSONLIB_Writer *writer, const i64 integer)
 {
-	if (str->length >= str->capacity || str->length + potentialAllocation >= str->capacity)
-	{
-		char *doubled = (char*)JSON_Allocate(sizeof(char) * str->capacity * 2);
-		if (doubled == NULL)
-			return false;
-		memcpy(doubled, str->raw, sizeof(char) * str->length);
-		JSON_Deallocate(str->raw);
-		str->raw = doubled;
-		str->capacity *= 2;
-	}
-	return true;
+	BeginWriterValue(writer);
+	AppendIntegerToString(WriterSpace(writer, JSON_MAX_DECIMAL_LENGTH), integer < 0 ? 0 - (u64)integer : (u64)integer, integer < 0);
 }
 
-static bool AppendCharToString(JSON_STRING_STRUCT *str, const char alloc)
+void JSONLIB_WriteUnsigned(JSONLIB_Writer *writer, const u64 integer)
 {
-	if (!StringCapacityHelper(str, 1))
-		return false;
-	str->raw[str->length++] = alloc;
-	return true;
+	BeginWriterValue(writer);
+	AppendIntegerToString(WriterSpace(writer, JSON_MAX_DECIMAL_LENGTH), integer, false);
 }
 
-static bool AppendStringToString(JSON_STRING_STRUCT *str, const char* chars, const u32 charsLen)
+void JSONLIB_WriteDouble(JSONLIB_Writer *writer, const f64 decimal)
 {
-	if (!StringCapacityHelper(str, charsLen))
-		return false;
-	memcpy(&str->raw[str->length], chars, sizeof(char) * charsLen);
-	str->length += charsLen;
-	return true;
+	BeginWriterValue(writer);
+	JSON_STRING_STRUCT *buffer = WriterSpace(writer, JSON_MAX_DECIMAL_LENGTH);
+	char *dest = &buffer->raw[buffer->length];
+	buffer->length += (u32)(WriteDecimal64(dest, decimal) - dest);
 }
 
-static JSON_STRING_STRUCT *MakeJSONPrettyNewline(JSON_STRING_STRUCT *str)
+void JSONLIB_WriteString(JSONLIB_Writer *writer, const char *string, const u32 stringLength)
 {
-	StringCapacityHelper(str, 1);
-	str->raw[str->length++] = '\n';
-	return str;
+	BeginWriterValue(writer);
+	WriterAppendQuoted(writer, string, stringLength);
 }
 
-static JSON_STRING_STRUCT *MakeJSONInternal(JSON_STRING_STRUCT *str, JSON_DIVIDER_STACK *stack, const JSON *const json, const bool humanReadable)
+void JSONLIB_WriteBoolean(JSONLIB_Writer *writer, const bool boolean)
 {
-	if (json->name != NULL)
-	{
-		const u32 nameLen = (u32)strlen(json->name);
-		if (nameLen > 0)
-		{
-			char* name = MakeStringValueString(json->name, nameLen);
-			u32 valueStrLen = (u32)strlen(name);
-			AppendStringToString(str, name, valueStrLen);
-			AppendCharToString(str, ':');
-			JSON_Deallocate(name);
-		}
-	}
+	BeginWriterValue(writer);
+	AppendStringToString(WriterSpace(writer, 5), boolean ? JSONtrueStr : JSONfalseStr, boolean ? 4 : 5);
+}
 
-	if (HasTags(json, JSON_OBJECT_TAG))
+void JSONLIB_WriteNull(JSONLIB_Writer *writer)
+{
+	BeginWriterValue(writer);
+	AppendStringToString(WriterSpace(writer, 4), JSONnullStr, 4);
+}
+
+// NOTE: @Jon
+// Writes a whole tree as the next value, or as the next member when it's named and the writer is in an object
+void JSONLIB_WriteJSON(JSONLIB_Writer *writer, const JSON *json)
+{
+	if (writer->depth > 0 && writer->scopes[writer->depth - 1] == '{' && !writer->afterKey)
+		JSONLIB_WriteKey(writer, json->name != NULL ? json->name : "", json->nameLength);
+
+	if (HasTags(json, JSON_OBJECT_TAG | JSON_ARRAY_TAG))
 	{
-		DividerStackPush(stack, '{');
-		AppendCharToString(str, '{');
+		const bool object = HasTags(json, JSON_OBJECT_TAG);
+		if (object)
+			JSONLIB_BeginObject(writer);
+		else
+			JSONLIB_BeginArray(writer);
+
+		for (u32 i = 0; i < json->valueCount; ++i)
+			JSONLIB_WriteJSON(writer, json->values[i]);
+
+		if (object)
+			JSONLIB_EndObject(writer);
+		else
+			JSONLIB_EndArray(writer);
 	}
-	else if (HasTags(json, JSON_ARRAY_TAG))
+	else if (HasTags(json, JSON_DECIMAL_TAG | JSON_DECIMAL64_TAG))
 	{
-		DividerStackPush(stack, '[');
-		AppendCharToString(str, '[');
+		BeginWriterValue(writer);
+		AppendDecimalToString(WriterSpace(writer, JSON_MAX_DECIMAL_LENGTH), json);
 	}
+	else if (HasTags(json, JSON_INTEGER64_TAG))
+		JSONLIB_WriteInteger(writer, json->integer64);
+	else if (HasTags(json, JSON_UNSIGNED64_TAG))
+		JSONLIB_WriteUnsigned(writer, json->unsigned64);
+	else if (HasTags(json, JSON_INTEGER_TAG))
+		JSONLIB_WriteInteger(writer, json->integer);
+	else if (HasTags(json, JSON_BOOLEAN_TAG))
+		JSONLIB_WriteBoolean(writer, json->boolean);
+	else if (HasTags(json, JSON_STRING_TAG))
+		JSONLIB_WriteString(writer, json->string, json->stringLength);
+	else
+		JSONLIB_WriteNull(writer);
+}
 
-	if (json->valueCount > 0)
-	{
-		for (u32 i = 0; i < json->valueCount; ++i)
-		{
-			MakeJSONInternal(str, stack, json->values[i], humanReadable);
+// NOTE: @Jon
+// Gets a node from a given tree
+JSON *JSONLIB_GetValueJSON(const char *name, u32 nameLength, JSON *json)
+{
+	assert(json != NULL);
 
-			if (i != json->valueCount - 1)
-			{
-				AppendCharToString(str, ',');
-			}
+	// Without an index there's no need to hash the name
+	const bool indexed = HasTags(json, JSON_OBJECT_TAG) && json->index != NULL;
+	return FindMember(json, name, nameLength, indexed ? HashName(name, nameLength) : 0);
+}
 
-			if (humanReadable)
-				MakeJSONPrettyNewline(str);
-		}
-	}
-	else
-	{
-		// TODO: @Jon
-		// Shouldn't hardcode the value string size!
-		char* valString = MakeValueString(json, 64, stack);
+// NOTE: @Jon
+// Makes a key for looking up the same name again and again
+JSONLIB_Key JSONLIB_MakeKey(const char *name, u32 nameLength)
+{
+	JSONLIB_Key key;
+	key.name = name;
+	key.nameLength = nameLength;
+	key.hash = HashName(name, nameLength);
+	return key;
+}
 
-		if (valString != NULL)
-		{
-			const u32 valStrLen = (u32)strlen(valString);
-			AppendStringToString(str, valString, valStrLen);
-			JSON_Deallocate(valString);
-		}
-	}
+// NOTE: @Jon
+// Gets a node from a given tree by a key made with JSONLIB_MakeKey
+JSON *JSONLIB_GetValueByKeyJSON(const JSONLIB_Key *key, JSON *json)
+{
+	assert(json != NULL);
+	return FindMember(json, key->name, key->nameLength, key->hash);
+}
 
-	if (HasTags(json, JSON_OBJECT_TAG))
+// NOTE: @Jon
+// Builds the member index for an object whatever its size
+bool JSONLIB_IndexJSON(JSON *json, JSONLIB_Arena *arena)
+{
+	assert(json != NULL);
+	assert(!(json->flags & JSON_ARENA_FLAG) || arena != NULL);
+	if (!HasTags(json, JSON_OBJECT_TAG))
+		return false;
+	return IndexMembers(json, (json->flags & JSON_ARENA_FLAG) ? arena : NULL);
+}
+
+// NOTE: @Jon
+// Gets the array index a reference token stands for, "0" or digits not starting with 0
+static u32 PathIndex(const char *token, const u32 length)
+{
+	if (length == 0 || length > 10 || (token[0] == '0' && length > 1))
+		return JSON_PATH_NO_INDEX;
+
+	u64 index = 0;
+	for (u32 i = 0; i < length; ++i)
 	{
-		DividerStackPop(stack);
-		AppendCharToString(str, '}');
+		if (token[i] < '0' || token[i] > '9')
+			return JSON_PATH_NO_INDEX;
+		index = index * 10 + (u64)(token[i] - '0');
 	}
-	else if (HasTags(json, JSON_ARRAY_TAG))
+	return index < JSON_PATH_NO_INDEX ? (u32)index : JSON_PATH_NO_INDEX;
+}
+
+// NOTE: @Jon
+// Compiles a JSON Pointer (RFC 6901), splitting it into reference tokens with ~0 and ~1 decoded
+// Gives back NULL if the pointer isn't valid
+JSONLIB_Path *JSONLIB_CompilePath(const char *pointer)
+{
+	assert(pointer != NULL);
+	if (pointer[0] != '\0' && pointer[0] != '/')
+		return NULL;
+
+	// Every token starts with a slash which its NUL takes the place of, and decoding never makes one longer
+	u32 segmentCount = 0;
+	size_t length = 0;
+	for (; pointer[length] != '\0'; ++length)
+		segmentCount += pointer[length] == '/';
+
+	const size_t size = sizeof(JSONLIB_Path) + sizeof(JSON_PATH_SEGMENT) * segmentCount + length;
+	JSONLIB_Path *path = (JSONLIB_Path*)JSON_Allocate(size);
+	if (path == NULL)
+		return NULL;
+	path->allocator = *CurrentAllocator();
+	path->size = size;
+	path->segmentCount = segmentCount;
+
+	char *names = (char*)&path->segments[segmentCount];
+	const char *iter = pointer;
+	for (u32 i = 0; i < segmentCount; ++i)
 	{
-		DividerStackPop(stack);
-		AppendCharToString(str, ']');
-	}
+		char *name = names;
+		for (++iter; *iter != '\0' && *iter != '/'; ++iter)
+		{
+			if (*iter != '~')
+				*names++ = *iter;
+			else if (iter[1] == '0' || iter[1] == '1')
+				*names++ = *++iter == '0' ? '~' : '/';
+			else
+			{
+				JSON_Deallocate(path, size);
+				return NULL;
+			}
+		}
 
-	return str;
+		const u32 nameLength = (u32)(names - name);
+		*names++ = '\0';
+		path->segments[i].key = JSONLIB_MakeKey(name, nameLength);
+		path->segments[i].index = PathIndex(name, nameLength);
+	}
+	return path;
 }
 
 // NOTE: @Jon
-// Makes a JSON string from a given tree input
-const char * JSONLIB_MakeJSON(const JSON * const json, const bool humanReadable)
+// Frees a compiled path
+void JSONLIB_DestroyPath(JSONLIB_Path *path)
 {
-	JSON_STRING_STRUCT jsonString;
-	jsonString.capacity = 64;
-	jsonString.length = 0;
-	jsonString.raw = (char*)JSON_Allocate(sizeof(char) * 1024);
+	if (path == NULL)
+		return;
 
-	JSON_DIVIDER_STACK stack;
-	stack.dividerStack = (char*)JSON_Allocate(sizeof(char) * JSON_DEFAULT_DIVIDER_STACK_SIZE);
-	stack.dividerCount = 0;
-	stack.dividerCapacity = JSON_DEFAULT_DIVIDER_STACK_SIZE;
+	// The allocator is copied out first since it's freed along with the path
+	const JSONLIB_Allocator allocator = path->allocator;
+	DeallocateWith(&allocator, path, path->size);
+}
 
-	MakeJSONInternal(&jsonString, &stack, json, humanReadable);
+// NOTE: @Jon
+// Follows a compiled path down from a node, objects are searched by key and arrays by index
+JSON *JSONLIB_EvalPath(const JSONLIB_Path *path, JSON *root)
+{
+	assert(path != NULL);
+	JSON *json = root;
+	for (u32 i = 0; i < path->segmentCount && json != NULL; ++i)
+	{
+		const JSON_PATH_SEGMENT *segment = &path->segments[i];
+		if (HasTags(json, JSON_OBJECT_TAG))
+			json = FindMember(json, segment->key.name, segment->key.nameLength, segment->key.hash);
+		else if (HasTags(json, JSON_ARRAY_TAG) && segment->index < json->valueCount)
+			json = json->values[segment->index];
+		else
+			json = NULL;
+	}
+	return json;
+}
 
-	AppendCharToString(&jsonString, '\0');
+// NOTE: @Jon
+// Gets the name of a node and its length
+const char *JSONLIB_GetNameJSON(const JSON *json, u32 *nameLength)
+{
+	if (nameLength != NULL)
+		*nameLength = json->nameLength;
+	return json->name;
+}
 
-	JSON_Deallocate(stack.dividerStack);
+// NOTE: @Jon
+// Gets the string value of a node and its length
+const char *JSONLIB_GetStringJSON(const JSON *json, u32 *stringLength)
+{
+	if (!HasTags(json, JSON_STRING_TAG))
+		return NULL;
 
-	return jsonString.raw;
+	if (stringLength != NULL)
+		*stringLength = json->stringLength;
+	return json->string;
 }
 
 // NOTE: @Jon
-// Gets a node from a given tree
-JSON *JSONLIB_GetValueJSON(const char *name, u32 nameLength, JSON *json)
+// Frees a node and its children, the parent's value array is left alone
+static void FreeJSONInternal(JSON *json)
 {
-	assert(json != NULL);
+	if (json == NULL)
+		return;
+
 	for (u32 i = 0; i < json->valueCount; ++i)
 	{
-		if (strcmp((*json->values[i]).name, name) == 0)
-			return json->values[i];
+		FreeJSONInternal(json->values[i]);
 	}
-	return NULL;
+
+	// Every part of a node goes back to the allocator the node came from
+	const JSONLIB_Allocator *allocator = NodeAllocator(json);
+	if (json->name && !(json->flags & JSON_BORROWED_NAME_FLAG))
+		DeallocateWith(allocator, (void*)json->name, sizeof(char) * (json->nameLength + 1));
+
+	if (HasTags(json, JSON_STRING_TAG) && !(json->flags & JSON_BORROWED_STRING_FLAG))
+		DeallocateWith(allocator, (void*)json->string, sizeof(char) * (json->stringLength + 1));
+
+	if (json->valueCapacity > 0)
+		DeallocateWith(allocator, json->values, sizeof(JSON*) * json->valueCapacity);
+
+	if (HasTags(json, JSON_OBJECT_TAG) && json->index != NULL)
+		DeallocateWith(allocator, json->index, MemberIndexSize(json->index->capacity));
+
+	DeallocateNode(json);
 }
 
 // NOTE: @Jon
@@ -968,6 +7182,11 @@ void JSONLIB_FreeJSON(JSON *json)
 	if (json == NULL)
 		return;
 
+	// Arena trees are released all at once with the arena
+	if (json->flags & JSON_ARENA_FLAG)
+		return;
+
+	// Only the node being freed needs unlinking, its children go along with it
 	if (json->parent != NULL)
 	{
 		for (u32 i = 0; i < json->parent->valueCount; ++i)
@@ -978,27 +7197,18 @@ void JSONLIB_FreeJSON(JSON *json)
 				break;
 			}
 		}
-	}
 
-	for (u32 i = 0; i < json->valueCount; ++i)
-	{
-		JSONLIB_FreeJSON(json->values[i]);
+		// The index only refers to members by position so refilling it in place drops the freed one
+		if (HasTags(json->parent, JSON_OBJECT_TAG) && json->parent->index != NULL)
+			FillMemberIndex(json->parent->index, json->parent);
 	}
 
-	if (json->name)
-		JSON_Deallocate((void*)json->name);
-
-	if (HasTags(json, JSON_STRING_TAG))
-		JSON_Deallocate((void*)json->string);
-
-	if (json->valueCount > 0)
-		JSON_Deallocate(json->values);
-
-	JSON_Deallocate(json);
+	FreeJSONInternal(json);
 }
 
 void JSONLIB_ClearJSON(const char *str)
 {
-	JSON_Deallocate((void*)str);
+	if (str != NULL)
+		JSON_Deallocate((void*)str, sizeof(char) * (strlen(str) + 1));
 	str = NULL;
 }
@@ -0,0 +1,293 @@
+#include <include/jsonlib/json.h>
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "json_test_allocator.h"
+
+// NOTE: @Jon
+// Keeps the size of every block in front of it so frees and resizes can be checked against it
+typedef struct SIZED_CONTEXT
+{
+	size_t outstanding;
+	u32 blocks;
+	u32 reallocations;
+} SIZED_CONTEXT;
+
+#define SIZED_HEADER 16
+
+void* SizedAllocate(void* context, size_t numBytes, size_t alignment)
+{
+	SIZED_CONTEXT* sized = (SIZED_CONTEXT*)context;
+	assert(alignment > 0 && alignment <= SIZED_HEADER);
+
+	char* block = (char*)malloc(SIZED_HEADER + numBytes);
+	assert(block != NULL);
+	memcpy(block, &numBytes, sizeof(size_t));
+	sized->outstanding += numBytes;
+	sized->blocks++;
+
+	assert((uintptr_t)(block + SIZED_HEADER) % alignment == 0);
+	return block + SIZED_HEADER;
+}
+
+void SizedDeallocate(void* context, void* bytes, size_t numBytes)
+{
+	SIZED_CONTEXT* sized = (SIZED_CONTEXT*)context;
+	char* block = (char*)bytes - SIZED_HEADER;
+
+	size_t allocated = 0;
+	memcpy(&allocated, block, sizeof(size_t));
+	assert(allocated == numBytes);
+	sized->outstanding -= numBytes;
+	sized->blocks--;
+	free(block);
+}
+
+void* SizedReallocate(void* context, void* bytes, size_t oldNumBytes, size_t newNumBytes)
+{
+	SIZED_CONTEXT* sized = (SIZED_CONTEXT*)context;
+	sized->reallocations++;
+	if (bytes == NULL)
+	{
+		assert(oldNumBytes == 0);
+		return SizedAllocate(context, newNumBytes, SIZED_HEADER);
+	}
+
+	void* resized = SizedAllocate(context, newNumBytes, SIZED_HEADER);
+	memcpy(resized, bytes, oldNumBytes < newNumBytes ? oldNumBytes : newNumBytes);
+	SizedDeallocate(context, bytes, oldNumBytes);
+	return resized;
+}
+
+char* CopyName(const JSONLIB_Allocator* allocator, const char* name)
+{
+	char* copy = (char*)allocator->allocate(allocator->context, strlen(name) + 1, 1);
+	strcpy(copy, name);
+	return copy;
+}
+
+char* MakeDocument(size_t* length)
+{
+	// NOTE: @Jon
+	// Enough members to be indexed, enough elements to outgrow the value stack and strings with escapes
+	static char str[16384];
+	size_t used = (size_t)sprintf(str, "{\"esc\\u0061ped\":\"tab\\there\",\"array\":[");
+	for (u32 i = 0; i < 300; ++i)
+		used += (size_t)sprintf(&str[used], "%s%u.5", i > 0 ? "," : "", i);
+	used += (size_t)sprintf(&str[used], "]");
+	for (u32 i = 0; i < 40; ++i)
+		used += (size_t)sprintf(&str[used], ",\"member%u\":\"value\\n%u\"", i, i);
+	used += (size_t)sprintf(&str[used], "}");
+	*length = used;
+	return str;
+}
+
+bool WriteNothing(void* context, const char* chars, u32 length)
+{
+	(void)context;
+	(void)chars;
+	(void)length;
+	return true;
+}
+
+int main()
+{
+	size_t length = 0;
+	const char* str = MakeDocument(&length);
+
+	SIZED_CONTEXT context = { 0, 0, 0 };
+	const JSONLIB_Allocator allocator = { &context, SizedAllocate, SizedReallocate, SizedDeallocate };
+
+	JSONLIB_SetAllocatorEx(&allocator);
+
+	// NOTE: @Jon
+	// Every block the library frees is freed with the size it was allocated with
+	JSON* json = JSONLIB_ParseJSONEx(str, length, JSON_PARSE_STRUCTURAL_INDEX, NULL);
+
+	assert(json != NULL);
+	assert(!strcmp(JSONLIB_GetValueJSON("escaped", 7, json)->string, "tab\there"));
+
+	const char* jsonStr = JSONLIB_MakeJSON(json, true);
+
+	JSONLIB_ClearJSON(jsonStr);
+
+	jsonStr = JSONLIB_MakeJSON(json, false);
+	JSON* copy = JSONLIB_ParseJSON(jsonStr, strlen(jsonStr));
+
+	assert(copy != NULL && copy->valueCount == json->valueCount);
+
+	JSONLIB_ClearJSON(jsonStr);
+	JSONLIB_FreeJSON(JSONLIB_GetValueJSON("member3", 7, copy));
+	JSONLIB_FreeJSON(copy);
+
+	JSONLIB_Tape* tape = JSONLIB_ParseTape(str, length, 0);
+
+	assert(tape != NULL);
+
+	JSONLIB_DestroyTape(tape);
+
+	JSONLIB_Path* path = JSONLIB_CompilePath("/array/299");
+	JSONLIB_LazyDocument* document = JSONLIB_ParseLazy(str, length);
+	JSONLIB_LazyValue value = JSONLIB_GetLazyRoot(document);
+
+	assert(JSONLIB_LazyEvalPath(&value, path));
+	assert(JSONLIB_LazyGetString(&value, NULL) == NULL);
+
+	JSON* projected = JSONLIB_ParseJSONProjected(str, length, (const JSONLIB_Path* const*)&path, 1);
+
+	assert(projected != NULL && projected->values[0]->values[0]->decimal64 == 299.5);
+
+	JSONLIB_FreeJSON(projected);
+	JSONLIB_DestroyLazy(document);
+	JSONLIB_DestroyPath(path);
+
+	path = JSONLIB_CompilePath("/member~1s");
+
+	assert(path != NULL);
+	assert(JSONLIB_CompilePath("/member~2") == NULL);
+
+	JSONLIB_DestroyPath(path);
+
+	JSONLIB_PushParser* push = JSONLIB_CreatePushParserJSON(NULL);
+	for (size_t i = 0; i < length; i += 7)
+		assert(JSONLIB_FeedPushParser(push, &str[i], length - i < 7 ? length - i : 7));
+	copy = JSONLIB_FinishPushParserJSON(push);
+
+	assert(copy != NULL);
+
+	JSONLIB_FreeJSON(copy);
+	JSONLIB_DestroyPushParser(push);
+
+	JSONLIB_Writer* writer = JSONLIB_CreateWriter(WriteNothing, NULL, 0, 0);
+	JSONLIB_WriteJSON(writer, json);
+
+	assert(JSONLIB_DestroyWriter(writer));
+
+	JSONLIB_Batch* batch = JSONLIB_ParseNDJSON("{\"a\":1}\n[2]\nnope\n", 17, 1, 0);
+
+	assert(batch != NULL && JSONLIB_GetBatchCount(batch) == 3);
+
+	JSONLIB_DestroyBatch(batch);
+	JSONLIB_FreeJSON(json);
+
+	// NOTE: @Jon
+	// Builder names and strings belong to the tree once they're handed over
+	json = JSONLIB_AllocateJSON(NULL, NULL);
+	for (u32 i = 0; i < 100; ++i)
+		JSONLIB_AllocateStringJSON(CopyName(&allocator, "name"), json, CopyName(&allocator, "string"));
+	JSONLIB_FreeJSON(json);
+
+	assert(context.outstanding == 0 && context.blocks == 0);
+	assert(context.reallocations > 0);
+
+	// NOTE: @Jon
+	// An arena made with its own allocator takes everything for its parses from it, not from the library's
+	SIZED_CONTEXT arenaContext = { 0, 0, 0 };
+	const JSONLIB_Allocator arenaAllocator = { &arenaContext, SizedAllocate, SizedReallocate, SizedDeallocate };
+	JSONLIB_Arena* arena = JSONLIB_CreateArenaWith(0, &arenaAllocator);
+
+	json = JSONLIB_ParseJSONEx(str, length, JSON_PARSE_STRUCTURAL_INDEX, arena);
+
+	assert(json != NULL);
+	assert(context.blocks == 0 && context.reallocations > 0);
+	assert(arenaContext.blocks > 0 && arenaContext.reallocations > 0);
+
+	JSONLIB_DestroyArena(arena);
+
+	assert(arenaContext.outstanding == 0 && arenaContext.blocks == 0);
+
+	// NOTE: @Jon
+	// A thread's own allocator is used for everything made on it, and each thing is freed with the allocator it
+	// came from whatever the thread is using by then
+	SIZED_CONTEXT threadContext = { 0, 0, 0 };
+	const JSONLIB_Allocator threadAllocator = { &threadContext, SizedAllocate, SizedReallocate, SizedDeallocate };
+	JSONLIB_UseAllocator(&threadAllocator);
+
+	json = JSONLIB_ParseJSONEx(str, length, JSON_PARSE_STRUCTURAL_INDEX, NULL);
+	tape = JSONLIB_ParseTape(str, length, 0);
+	path = JSONLIB_CompilePath("/array/7");
+	document = JSONLIB_ParseLazy(str, length);
+	value = JSONLIB_GetLazyRoot(document);
+	JSONLIB_NameTable* names = JSONLIB_CreateNameTable();
+	copy = JSONLIB_ParseJSONInterned(str, length, 0, NULL, names);
+	push = JSONLIB_CreatePushParserJSON(NULL);
+	writer = JSONLIB_CreateWriter(WriteNothing, NULL, 0, 0);
+	batch = JSONLIB_ParseNDJSON("{\"a\":1}\n[2]\n", 12, 1, 0);
+	jsonStr = JSONLIB_MakeJSON(json, false);
+
+	assert(json != NULL && tape != NULL && path != NULL && document != NULL && copy != NULL && push != NULL);
+	assert(writer != NULL && batch != NULL && jsonStr != NULL);
+	assert(JSONLIB_LazyEvalPath(&value, path));
+	assert(JSONLIB_FeedPushParser(push, "[\"a\\tb\", {\"c\"", 14));
+	assert(threadContext.blocks > 0 && context.blocks == 0);
+
+	JSONLIB_ClearJSON(jsonStr);
+	JSONLIB_UseAllocator(NULL);
+
+	// A node from the library's allocator can go into a tree from the thread's
+	JSONLIB_AddValueJSON(json, JSONLIB_AllocateStringJSON(CopyName(&allocator, "added"), NULL, CopyName(&allocator, "node")));
+
+	assert(context.blocks == 3);
+
+	JSONLIB_FreeJSON(json);
+	JSONLIB_FreeJSON(copy);
+	JSONLIB_DestroyNameTable(names);
+	JSONLIB_DestroyTape(tape);
+	JSONLIB_DestroyLazy(document);
+	JSONLIB_DestroyPath(path);
+	JSONLIB_DestroyPushParser(push);
+	JSONLIB_WriteNull(writer);
+
+	assert(JSONLIB_DestroyWriter(writer));
+
+	JSONLIB_DestroyBatch(batch);
+
+	assert(threadContext.outstanding == 0 && threadContext.blocks == 0);
+	assert(context.outstanding == 0 && context.blocks == 0);
+
+	// NOTE: @Jon
+	// Node pools and writers can be given an allocator of their own
+	JSONLIB_NodePool* pool = JSONLIB_CreateNodePoolWith(0, &threadAllocator);
+	JSONLIB_UseNodePool(pool);
+
+	json = JSONLIB_ParseJSON(str, length);
+
+	assert(json != NULL && context.blocks == 0);
+
+	JSONLIB_UseNodePool(NULL);
+	JSONLIB_FreeJSON(json);
+	JSONLIB_DestroyNodePool(pool);
+
+	writer = JSONLIB_CreateWriterWith(WriteNothing, NULL, 0, 0, &threadAllocator);
+
+	assert(writer != NULL && threadContext.blocks == 2 && context.blocks == 0);
+	assert(JSONLIB_DestroyWriter(writer));
+	assert(threadContext.outstanding == 0 && threadContext.blocks == 0);
+
+	// NOTE: @Jon
+	// Going back to malloc and free, or to the old style functions
+	JSONLIB_SetAllocatorEx(NULL);
+
+	json = JSONLIB_ParseJSON(str, length);
+
+	assert(json != NULL);
+
+	JSONLIB_FreeJSON(json);
+
+	InitTESTAllocatorContext();
+	JSONLIB_SetAllocator(TESTAllocate, TESTDeallocate);
+
+	json = JSONLIB_ParseJSON(str, length);
+
+	assert(json != NULL && allocations > 0);
+
+	JSONLIB_FreeJSON(json);
+
+	assert(context.blocks == 0);
+	assert(allocations == 0);
+
+	return 0;
+}
@@ -0,0 +1,58 @@
+#include <include/jsonlib/json.h>
+
+#include <assert.h>
+#include <string.h>
+
+#include "json_test_allocator.h"
+
+int main()
+{
+	const char* str = "{\"object\":{\"value\":12},\"array\":[\"bananas\",7,{}],\"boolean\":true}";
+
+	InitTESTAllocatorContext();
+	JSONLIB_SetAllocator(TESTAllocate, TESTDeallocate);
+
+	JSONLIB_Arena* arena = JSONLIB_CreateArena(0);
+
+	assert(arena != NULL);
+
+	JSON* json = JSONLIB_ParseJSONArena(arena, str, (u32)strlen(str));
+
+	assert(json != NULL);
+
+	// NOTE: @Jon
+	// The whole tree should live in the arena's single block
+	assert(allocations == 2);
+
+	assert(json->valueCount == 3);
+
+	assert(json->values[0]->values[0]->integer == 12);
+
+	assert(!strcmp(json->values[1]->values[0]->string, "bananas"));
+
+	const char* jsonStr = JSONLIB_MakeJSON(json, false);
+
+	assert(!strcmp(str, jsonStr));
+
+	JSONLIB_ClearJSON((void*)jsonStr);
+
+	// NOTE: @Jon
+	// Freeing an arena tree is a no-op, the arena owns it
+	JSONLIB_FreeJSON(json);
+
+	assert(allocations == 2);
+
+	JSONLIB_ResetArena(arena);
+
+	json = JSONLIB_ParseJSONArena(arena, str, (u32)strlen(str));
+
+	assert(json != NULL);
+
+	assert(allocations == 2);
+
+	JSONLIB_DestroyArena(arena);
+
+	assert(allocations == 0);
+
+	return 0;
+}
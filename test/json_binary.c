@@ -0,0 +1,174 @@
+#include <include/jsonlib/json.h>
+
+#include <assert.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "json_test_allocator.h"
+
+// NOTE: @Jon
+// The snapshot goes in the temp directory and is removed however the test ends, failed asserts included
+char path[4096];
+
+void RemoveSnapshot(void)
+{
+	remove(path);
+}
+
+void RemoveSnapshotOnAbort(int signal)
+{
+	(void)signal;
+	remove(path);
+}
+
+int main()
+{
+	const char* str = "{\"name\":\"caf\\u00e9\",\"values\":[1,-2,18446744073709551615,0.5,true,false,null,\"\"],"
+		"\"empty\":{},\"nested\":{\"a\":[[],{\"b\":\"c\\n\"}]},\"big\":12345678901234}";
+	const char* directory = getenv("TMPDIR") != NULL ? getenv("TMPDIR") : getenv("TEMP");
+	snprintf(path, sizeof(path), "%s/json_binary_test.bin", directory != NULL ? directory : "/tmp");
+	atexit(RemoveSnapshot);
+	signal(SIGABRT, RemoveSnapshotOnAbort);
+
+	InitTESTAllocatorContext();
+	JSONLIB_SetAllocator(TESTAllocate, TESTDeallocate);
+
+	JSON* json = JSONLIB_ParseJSON(str, (u32)strlen(str));
+
+	assert(json != NULL);
+	assert(JSONLIB_SaveBinary(json, path));
+
+	// NOTE: @Jon
+	// The mapped snapshot is walked where it lies, only the tape itself is allocated
+	const u32 treeAllocations = allocations;
+	JSONLIB_Tape* tape = JSONLIB_MapBinary(path);
+
+	assert(tape != NULL);
+	assert(allocations == treeAllocations + 1);
+
+	JSONLIB_Cursor cursor = JSONLIB_GetTapeRoot(tape);
+	i64 integer = 0;
+	u64 unsigned64 = 0;
+
+	assert(JSONLIB_CursorGetTags(&cursor) == JSON_OBJECT_TAG);
+	assert(JSONLIB_CursorGetCount(&cursor) == 5);
+	assert(JSONLIB_CursorFindKey(&cursor, "big", 3));
+	assert(JSONLIB_CursorGetInteger64(&cursor, &integer) && integer == 12345678901234);
+
+	cursor = JSONLIB_GetTapeRoot(tape);
+
+	assert(JSONLIB_CursorFindKey(&cursor, "values", 6));
+	assert(JSONLIB_CursorGetCount(&cursor) == 8);
+	assert(JSONLIB_CursorChild(&cursor) && JSONLIB_CursorNextSibling(&cursor) && JSONLIB_CursorNextSibling(&cursor));
+	assert(JSONLIB_CursorGetUnsigned64(&cursor, &unsigned64) && unsigned64 == 18446744073709551615ULL);
+
+	cursor = JSONLIB_GetTapeRoot(tape);
+
+	assert(JSONLIB_CursorFindKey(&cursor, "name", 4));
+	assert(!strcmp(JSONLIB_CursorGetString(&cursor, NULL), "caf\xc3\xa9"));
+
+	// NOTE: @Jon
+	// Turning the snapshot back into a tree gives the same document
+	JSON* copy = JSONLIB_TapeToJSON(tape, NULL);
+
+	assert(copy != NULL);
+
+	const char* jsonStr = JSONLIB_MakeJSON(json, false);
+	const char* copyStr = JSONLIB_MakeJSON(copy, false);
+
+	assert(!strcmp(jsonStr, copyStr));
+	assert(JSONLIB_GetValueJSON("big", 3, copy)->integer64 == 12345678901234);
+
+	JSONLIB_ClearJSON((void*)jsonStr);
+	JSONLIB_ClearJSON((void*)copyStr);
+	JSONLIB_FreeJSON(copy);
+	JSONLIB_DestroyTape(tape);
+	JSONLIB_FreeJSON(json);
+
+	// NOTE: @Jon
+	// Built trees save too, including 32 bit decimals and a scalar root
+	json = JSONLIB_AllocateJSON(NULL, NULL);
+	json->tags = JSON_ARRAY_TAG;
+	JSONLIB_AddValueJSON(json, JSONLIB_AllocateDecimalJSON(NULL, NULL, 0.25f));
+	JSONLIB_AddValueJSON(json, JSONLIB_AllocateInteger64JSON(NULL, NULL, -5000000000));
+	JSONLIB_AddValueJSON(json, JSONLIB_AllocateDecimalJSON(NULL, NULL, 0.1f));
+
+	assert(JSONLIB_SaveBinary(json, path));
+
+	tape = JSONLIB_MapBinary(path);
+	copy = JSONLIB_TapeToJSON(tape, NULL);
+
+	assert(copy != NULL && copy->valueCount == 3);
+	assert(copy->values[0]->decimal64 == 0.25);
+	assert(copy->values[1]->integer64 == -5000000000);
+
+	// NOTE: @Jon
+	// A float comes back as the double of its shortest text, so it writes out the same
+	jsonStr = JSONLIB_MakeJSON(json, false);
+	copyStr = JSONLIB_MakeJSON(copy, false);
+
+	assert(!strcmp(jsonStr, "[0.25,-5000000000,0.1]"));
+	assert(!strcmp(jsonStr, copyStr));
+
+	JSONLIB_ClearJSON((void*)jsonStr);
+	JSONLIB_ClearJSON((void*)copyStr);
+	JSONLIB_FreeJSON(copy);
+	JSONLIB_DestroyTape(tape);
+
+	assert(JSONLIB_SaveBinary(json->values[1], path));
+
+	tape = JSONLIB_MapBinary(path);
+	cursor = JSONLIB_GetTapeRoot(tape);
+
+	assert(JSONLIB_CursorGetInteger64(&cursor, &integer) && integer == -5000000000);
+
+	JSONLIB_DestroyTape(tape);
+	JSONLIB_FreeJSON(json);
+
+	// NOTE: @Jon
+	// A snapshot with any one bit flipped either maps to a tape that replays safely or is turned away
+	json = JSONLIB_ParseJSON(str, (u32)strlen(str));
+
+	assert(JSONLIB_SaveBinary(json, path));
+
+	JSONLIB_FreeJSON(json);
+
+	char saved[1024];
+	FILE* file = fopen(path, "rb");
+	const size_t savedLength = fread(saved, 1, sizeof(saved), file);
+	fclose(file);
+
+	assert(savedLength > 0 && savedLength < sizeof(saved));
+
+	for (size_t bit = 0; bit < savedLength * 8; ++bit)
+	{
+		saved[bit / 8] ^= (char)(1 << (bit % 8));
+		file = fopen(path, "wb");
+		fwrite(saved, 1, savedLength, file);
+		fclose(file);
+		saved[bit / 8] ^= (char)(1 << (bit % 8));
+
+		tape = JSONLIB_MapBinary(path);
+		copy = JSONLIB_TapeToJSON(tape, NULL);
+		JSONLIB_FreeJSON(copy);
+		JSONLIB_DestroyTape(tape);
+	}
+
+	// NOTE: @Jon
+	// Missing and mangled files are turned away
+	file = fopen(path, "wb");
+	fwrite("JLTP not a snapshot", 1, 19, file);
+	fclose(file);
+
+	assert(JSONLIB_MapBinary(path) == NULL);
+
+	remove(path);
+
+	assert(JSONLIB_MapBinary(path) == NULL);
+
+	assert(allocations == 0);
+
+	return 0;
+}
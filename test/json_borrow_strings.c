@@ -0,0 +1,59 @@
+#include <include/jsonlib/json.h>
+
+#include <assert.h>
+#include <string.h>
+
+#include "json_test_allocator.h"
+
+int main()
+{
+	const char* str = "{\"string\":\"bananas\",\"array\":[\"concert\",\"hmm\"],\"\":12}";
+
+	InitTESTAllocatorContext();
+	JSONLIB_SetAllocator(TESTAllocate, TESTDeallocate);
+
+	JSON* json = JSONLIB_ParseJSONEx(str, (u32)strlen(str), JSON_PARSE_BORROW_STRINGS, NULL);
+
+	assert(json != NULL);
+
+	// NOTE: @Jon
+	// Only the nodes and the two value arrays should have been allocated
+	assert(allocations == 6 + 2);
+
+	assert(json->valueCount == 3);
+
+	u32 length = 0;
+	const char* name = JSONLIB_GetNameJSON(json->values[0], &length);
+
+	assert(name == str + 2);
+	assert(length == 6);
+
+	const char* string = JSONLIB_GetStringJSON(json->values[0], &length);
+
+	assert(string >= str && string < str + strlen(str));
+	assert(length == 7 && !memcmp(string, "bananas", length));
+
+	JSON* array = JSONLIB_GetValueJSON("array", 5, json);
+
+	assert(array != NULL && array->valueCount == 2);
+
+	string = JSONLIB_GetStringJSON(array->values[1], &length);
+
+	assert(length == 3 && !memcmp(string, "hmm", length));
+
+	JSON* empty = JSONLIB_GetValueJSON("", 0, json);
+
+	assert(empty != NULL && empty->integer == 12);
+
+	const char* jsonStr = JSONLIB_MakeJSON(json, false);
+
+	assert(!strcmp(str, jsonStr));
+
+	JSONLIB_ClearJSON((void*)jsonStr);
+
+	JSONLIB_FreeJSON(json);
+
+	assert(allocations == 0);
+
+	return 0;
+}
@@ -0,0 +1,114 @@
+#include <include/jsonlib/json.h>
+
+#include <assert.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "json_test_allocator.h"
+
+#define VALUE_COUNT 1000
+
+// NOTE: @Jon
+// How many more allocations succeed before they start failing, -1 never fails
+i32 allocationsLeft = -1;
+
+void* FailingAllocate(size_t size)
+{
+	if (allocationsLeft == 0)
+		return NULL;
+	if (allocationsLeft > 0)
+		allocationsLeft--;
+	return TESTAllocate(size);
+}
+
+int main()
+{
+	InitTESTAllocatorContext();
+	JSONLIB_SetAllocator(TESTAllocate, TESTDeallocate);
+
+	// NOTE: @Jon
+	// Appending without reserving should only grow the value array logarithmically
+	JSON* array = JSONLIB_AllocateJSON(NULL, NULL);
+	array->tags = JSON_ARRAY_TAG;
+
+	for (u32 i = 0; i < VALUE_COUNT; ++i)
+		JSONLIB_AllocateIntegerJSON(NULL, array, (i32)i);
+
+	assert(array->valueCount == VALUE_COUNT);
+	assert(array->valueCapacity >= VALUE_COUNT);
+	assert(totalAllocations < 1 + VALUE_COUNT + 16);
+	assert(array->values[VALUE_COUNT - 1]->integer == VALUE_COUNT - 1);
+
+	const char* jsonStr = JSONLIB_MakeJSON(array, false);
+
+	assert(!strncmp(jsonStr, "[0,1,2,3,", 9));
+
+	JSONLIB_ClearJSON((void*)jsonStr);
+
+	JSONLIB_FreeJSON(array);
+
+	assert(allocations == 0);
+
+	// NOTE: @Jon
+	// Reserving up front means the value array is allocated exactly once
+	InitTESTAllocatorContext();
+
+	array = JSONLIB_AllocateJSON(NULL, NULL);
+	array->tags = JSON_ARRAY_TAG;
+	JSONLIB_ReserveValuesJSON(array, VALUE_COUNT);
+
+	for (u32 i = 0; i < VALUE_COUNT; ++i)
+		JSONLIB_AllocateIntegerJSON(NULL, array, (i32)i);
+
+	assert(array->valueCapacity == VALUE_COUNT);
+	assert(totalAllocations == 2 + VALUE_COUNT);
+
+	JSONLIB_FreeJSON(array);
+
+	assert(allocations == 0);
+
+	// NOTE: @Jon
+	// Values that can't grow leave the node as it was, and the builders give back NULL
+	JSONLIB_SetAllocator(FailingAllocate, TESTDeallocate);
+
+	array = JSONLIB_AllocateJSON(NULL, NULL);
+	array->tags = JSON_ARRAY_TAG;
+	JSON* value = JSONLIB_AllocateIntegerJSON(NULL, NULL, 7);
+	allocationsLeft = 0;
+
+	assert(!JSONLIB_ReserveValuesJSON(array, VALUE_COUNT));
+	assert(!JSONLIB_AddValueJSON(array, value));
+	assert(array->valueCount == 0 && array->valueCapacity == 0 && value->parent == NULL);
+
+	allocationsLeft = -1;
+
+	assert(JSONLIB_AddValueJSON(array, value));
+
+	while (array->valueCount < array->valueCapacity)
+		JSONLIB_AllocateIntegerJSON(NULL, array, (i32)array->valueCount);
+
+	// The node is allocated but the full array can't grow to take it
+	const u32 builtAllocations = allocations;
+	allocationsLeft = 1;
+
+	assert(JSONLIB_AllocateIntegerJSON(NULL, array, 4) == NULL);
+	assert(array->valueCount == array->valueCapacity && allocations == builtAllocations);
+
+	// NOTE: @Jon
+	// Once the count is as high as it goes nothing more can be added
+	const u32 capacity = array->valueCapacity;
+	array->valueCount = UINT32_MAX;
+	array->valueCapacity = UINT32_MAX;
+
+	assert(!JSONLIB_AddValueJSON(array, NULL));
+
+	array->valueCount = capacity;
+	array->valueCapacity = capacity;
+	allocationsLeft = -1;
+
+	JSONLIB_FreeJSON(array);
+
+	assert(allocations == 0);
+
+	return 0;
+}
@@ -0,0 +1,48 @@
+#include <include/jsonlib/json.h>
+
+#include <assert.h>
+#include <string.h>
+
+#include "json_test_allocator.h"
+
+int main()
+{
+	const char* str = "[0.1,1e-7,0.000001,5e-324,1.7976931348623157E+308,-0.0,1e21,100.0,2.5e-3,123456789012345678901]";
+
+	InitTESTAllocatorContext();
+	JSONLIB_SetAllocator(TESTAllocate, TESTDeallocate);
+
+	JSON* json = JSONLIB_ParseJSON(str, (u32)strlen(str));
+
+	assert(json != NULL);
+
+	// NOTE: @Jon
+	// Shortest digits that read back the same, laid out like JavaScript with a ".0" on whole numbers
+	const char* jsonStr = JSONLIB_MakeJSON(json, false);
+
+	assert(!strcmp(jsonStr, "[0.1,1e-7,0.000001,5e-324,1.7976931348623157e308,-0.0,1e21,100.0,0.0025,123456789012345680000.0]"));
+
+	JSONLIB_ClearJSON((void*)jsonStr);
+	JSONLIB_FreeJSON(json);
+
+	// NOTE: @Jon
+	// Floats get their own shortest digits rather than the digits of the widened double
+	JSON* built = JSONLIB_AllocateJSON(NULL, NULL);
+	built->tags = JSON_ARRAY_TAG;
+
+	JSONLIB_AllocateDecimalJSON(NULL, built, 0.14f);
+	JSONLIB_AllocateDecimalJSON(NULL, built, 3.4028235e38f);
+	JSONLIB_AllocateDecimalJSON(NULL, built, 16777216.0f);
+	JSONLIB_AllocateDecimal64JSON(NULL, built, 0.1 + 0.2);
+
+	jsonStr = JSONLIB_MakeJSON(built, false);
+
+	assert(!strcmp(jsonStr, "[0.14,3.4028235e38,16777216.0,0.30000000000000004]"));
+
+	JSONLIB_ClearJSON((void*)jsonStr);
+	JSONLIB_FreeJSON(built);
+
+	assert(allocations == 0);
+
+	return 0;
+}
@@ -0,0 +1,75 @@
+#include <include/jsonlib/json.h>
+
+#include <assert.h>
+#include <string.h>
+
+#include "json_test_allocator.h"
+
+int main()
+{
+	const char* str = "{\"key \\\"quoted\\\"\":\"line\\nbreak \\u00e9 \\ud83d\\ude00\",\"array\":[\"back\\\\slash\",\"plain\"]}";
+
+	char buffer[256];
+	memcpy(buffer, str, strlen(str) + 1);
+
+	InitTESTAllocatorContext();
+	JSONLIB_SetAllocator(TESTAllocate, TESTDeallocate);
+
+	JSON* json = JSONLIB_ParseJSONInSitu(buffer, strlen(buffer));
+
+	assert(json != NULL);
+
+	// NOTE: @Jon
+	// Strings live in the buffer so only the nodes and the two value arrays are allocated
+	assert(allocations == 5 + 2);
+
+	assert(json->valueCount == 2);
+
+	JSON* value = json->values[0];
+
+	assert(value->name >= buffer && value->name < buffer + sizeof(buffer));
+	assert(!strcmp(value->name, "key \"quoted\""));
+	assert(value->nameLength == 12);
+
+	assert(value->string >= buffer && value->string < buffer + sizeof(buffer));
+	assert(!strcmp(value->string, "line\nbreak \xC3\xA9 \xF0\x9F\x98\x80"));
+	assert(value->stringLength == strlen(value->string));
+
+	JSON* array = json->values[1];
+
+	assert(!strcmp(array->values[0]->string, "back\\slash"));
+	assert(!strcmp(array->values[1]->string, "plain"));
+
+	// NOTE: @Jon
+	// Writing the tree back out escapes the strings again
+	const char* jsonStr = JSONLIB_MakeJSON(json, false);
+
+	JSON* reparsed = JSONLIB_ParseJSON(jsonStr, (u32)strlen(jsonStr));
+
+	assert(reparsed != NULL);
+	assert(!strcmp(reparsed->values[0]->name, "key \"quoted\""));
+	assert(!strcmp(reparsed->values[0]->string, value->string));
+	assert(!strcmp(reparsed->values[1]->values[0]->string, "back\\slash"));
+
+	JSONLIB_FreeJSON(reparsed);
+
+	JSONLIB_ClearJSON((void*)jsonStr);
+
+	JSONLIB_FreeJSON(json);
+
+	assert(allocations == 0);
+
+	// NOTE: @Jon
+	// Bad escape sequences and unpaired surrogates fail to parse
+	char bad[] = "{\"a\":\"\\ud83d\"}";
+
+	assert(JSONLIB_ParseJSONInSitu(bad, strlen(bad)) == NULL);
+
+	char badEscape[] = "[\"\\q\"]";
+
+	assert(JSONLIB_ParseJSONInSitu(badEscape, strlen(badEscape)) == NULL);
+
+	assert(allocations == 0);
+
+	return 0;
+}
@@ -0,0 +1,89 @@
+#include <include/jsonlib/json.h>
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "json_test_allocator.h"
+
+int main()
+{
+	InitTESTAllocatorContext();
+	JSONLIB_SetAllocator(TESTAllocate, TESTDeallocate);
+
+	const char* first = "[{\"timestamp\":1,\"level\":\"info\"},{\"timestamp\":2,\"level\":\"warn\",\"extra\":{\"timestamp\":3}}]";
+	const char* second = "{\"timestamp\":4,\"level\":\"error\"}";
+
+	JSONLIB_NameTable* names = JSONLIB_CreateNameTable();
+	JSON* json = JSONLIB_ParseJSONInterned(first, strlen(first), 0, NULL, names);
+	JSON* other = JSONLIB_ParseJSONInterned(second, strlen(second), 0, NULL, names);
+
+	assert(json != NULL && other != NULL);
+
+	// NOTE: @Jon
+	// Every occurrence of a name shares one copy, within a document and across them
+	const char* timestamp = JSONLIB_InternName(names, "timestamp", 9);
+
+	assert(json->values[0]->values[0]->name == timestamp);
+	assert(json->values[1]->values[0]->name == timestamp);
+	assert(json->values[1]->values[2]->values[0]->name == timestamp);
+	assert(other->values[0]->name == timestamp);
+	assert(other->values[1]->name == json->values[0]->values[1]->name);
+
+	JSONLIB_Key key = JSONLIB_MakeKey(timestamp, 9);
+
+	assert(JSONLIB_GetValueByKeyJSON(&key, other)->integer == 4);
+	assert(JSONLIB_GetValueJSON("level", 5, json->values[1])->stringLength == 4);
+
+	// NOTE: @Jon
+	// Freeing a tree leaves the names to the table
+	JSONLIB_FreeJSON(json);
+
+	assert(!strcmp(JSONLIB_GetNameJSON(other->values[1], NULL), "level"));
+
+	JSONLIB_FreeJSON(other);
+
+	assert(JSONLIB_ParseJSONInterned("{\"level\":1,\"new\":[}", 19, 0, NULL, names) == NULL);
+
+	// NOTE: @Jon
+	// Enough names to grow the table, parsed into an arena with an index
+	char str[4096];
+	u32 length = (u32)sprintf(str, "{");
+	for (u32 i = 0; i < 200; ++i)
+		length += (u32)sprintf(&str[length], "%s\"name%u\":%u", i > 0 ? "," : "", i, i);
+	str[length++] = '}';
+
+	JSONLIB_Arena* arena = JSONLIB_CreateArena(0);
+	json = JSONLIB_ParseJSONInterned(str, length, JSON_PARSE_BORROW_STRINGS, arena, names);
+
+	assert(json != NULL && json->valueCount == 200);
+
+	for (u32 i = 0; i < 200; ++i)
+	{
+		char name[16];
+		const u32 nameLength = (u32)sprintf(name, "name%u", i);
+		const char* interned = JSONLIB_InternName(names, name, nameLength);
+
+		assert(json->values[i]->name == interned);
+		assert(JSONLIB_GetValueJSON(interned, nameLength, json)->integer == (i32)i);
+	}
+
+	assert(JSONLIB_InternName(names, "timestamp", 9) == timestamp);
+
+	// NOTE: @Jon
+	// A lookup with a prefix of an interned name finds the shorter member, not the one sharing the pointer
+	const char* prefixed = "{\"abc\":1,\"ab\":2}";
+	json = JSONLIB_ParseJSONInterned(prefixed, strlen(prefixed), 0, arena, names);
+	const char* abc = JSONLIB_InternName(names, "abc", 3);
+
+	assert(json != NULL);
+	assert(JSONLIB_GetValueJSON(abc, 2, json)->integer == 2);
+	assert(JSONLIB_GetValueJSON(abc, 3, json)->integer == 1);
+
+	JSONLIB_DestroyArena(arena);
+	JSONLIB_DestroyNameTable(names);
+
+	assert(allocations == 0);
+
+	return 0;
+}
@@ -0,0 +1,155 @@
+#include <include/jsonlib/json.h>
+
+#include <assert.h>
+#include <string.h>
+
+#include "json_test_allocator.h"
+
+// NOTE: @Jon
+// Walks a lazy document alongside the tree parsed from the same string
+void CheckLazy(JSONLIB_LazyValue value, JSON* json)
+{
+	assert(JSONLIB_LazyGetTags(&value) == json->tags);
+
+	u32 nameLength = 0;
+	const char* name = JSONLIB_LazyGetName(&value, &nameLength);
+	if (json->name != NULL)
+	{
+		assert(name != NULL && nameLength == json->nameLength && !memcmp(name, json->name, nameLength));
+	}
+	else
+	{
+		assert(name == NULL);
+	}
+
+	i64 integer = 0;
+	u64 unsigned64 = 0;
+	f64 decimal = 0;
+	bool boolean = false;
+	if (json->tags & JSON_INTEGER64_TAG)
+	{
+		assert(JSONLIB_LazyGetInteger64(&value, &integer) && integer == json->integer64);
+	}
+	if (json->tags & JSON_UNSIGNED64_TAG)
+	{
+		assert(JSONLIB_LazyGetUnsigned64(&value, &unsigned64) && unsigned64 == json->unsigned64);
+	}
+	if (json->tags & JSON_DECIMAL64_TAG)
+	{
+		assert(JSONLIB_LazyGetDecimal64(&value, &decimal) && decimal == json->decimal64);
+	}
+	if (json->tags & JSON_BOOLEAN_TAG)
+	{
+		assert(JSONLIB_LazyGetBoolean(&value, &boolean) && boolean == json->boolean);
+	}
+	if (json->tags & JSON_STRING_TAG)
+	{
+		u32 stringLength = 0;
+		const char* string = JSONLIB_LazyGetString(&value, &stringLength);
+		assert(string != NULL && stringLength == json->stringLength && !memcmp(string, json->string, stringLength));
+	}
+
+	if (json->tags & (JSON_OBJECT_TAG | JSON_ARRAY_TAG))
+	{
+		assert(JSONLIB_LazyGetCount(&value) == json->valueCount);
+
+		JSONLIB_LazyValue child = value;
+		bool more = JSONLIB_LazyChild(&child);
+		for (u32 i = 0; i < json->valueCount; ++i)
+		{
+			assert(more);
+			CheckLazy(child, json->values[i]);
+			more = JSONLIB_LazyNextSibling(&child);
+		}
+		assert(!more);
+	}
+	else
+	{
+		assert(!JSONLIB_LazyChild(&value));
+	}
+}
+
+int main()
+{
+	const char* str = "{\"name\":\"caf\\u00e9\",\"values\":[1,-2,18446744073709551615,0.5,true,false,null,\"\"],"
+		"\"empty\":{},\"nested\":{\"a\":[[],{\"b\":\"c\\n\"}]},\"big\":12345678901234,\"k\\u0065y\":7}";
+
+	InitTESTAllocatorContext();
+	JSONLIB_SetAllocator(TESTAllocate, TESTDeallocate);
+
+	JSON* json = JSONLIB_ParseJSON(str, strlen(str));
+	JSONLIB_LazyDocument* document = JSONLIB_ParseLazy(str, strlen(str));
+
+	assert(json != NULL && document != NULL);
+
+	JSONLIB_LazyValue root = JSONLIB_GetLazyRoot(document);
+	CheckLazy(root, json);
+
+	// NOTE: @Jon
+	// Keys are found whether or not they have escapes, and paths skip what they don't go into
+	JSONLIB_LazyValue value = root;
+	i64 integer = 0;
+
+	assert(JSONLIB_LazyFindKey(&value, "key", 3));
+	assert(JSONLIB_LazyGetInteger64(&value, &integer) && integer == 7);
+	assert(!JSONLIB_LazyFindKey(&value, "key", 3));
+
+	JSONLIB_Path* path = JSONLIB_CompilePath("/nested/a/1/b");
+	value = root;
+
+	assert(JSONLIB_LazyEvalPath(&value, path));
+	assert(!strcmp(JSONLIB_LazyGetString(&value, NULL), "c\n"));
+
+	JSONLIB_DestroyPath(path);
+
+	path = JSONLIB_CompilePath("/values/8");
+	value = root;
+
+	assert(!JSONLIB_LazyEvalPath(&value, path));
+	assert(value.token == root.token);
+
+	JSONLIB_DestroyPath(path);
+
+	// NOTE: @Jon
+	// Any part of the document can be turned into a tree
+	value = root;
+
+	assert(JSONLIB_LazyFindKey(&value, "nested", 6));
+
+	JSON* nested = JSONLIB_LazyToJSON(&value, NULL);
+	const char* nestedStr = JSONLIB_MakeJSON(nested, false);
+
+	assert(!strcmp(nestedStr, "{\"a\":[[],{\"b\":\"c\\n\"}]}"));
+
+	JSONLIB_ClearJSON((void*)nestedStr);
+	JSONLIB_FreeJSON(nested);
+	JSONLIB_DestroyLazy(document);
+	JSONLIB_FreeJSON(json);
+
+	// NOTE: @Jon
+	// Values that aren't read aren't checked, only the structure is
+	const char* bad = "{\"ok\":1,\"bad\":01x,\"worse\":\"\\q\"}";
+	document = JSONLIB_ParseLazy(bad, strlen(bad));
+	root = JSONLIB_GetLazyRoot(document);
+	value = root;
+
+	assert(document != NULL);
+	assert(JSONLIB_LazyFindKey(&value, "ok", 2) && JSONLIB_LazyGetInteger64(&value, &integer) && integer == 1);
+	assert(JSONLIB_LazyFindKey(&root, "bad", 3) && !JSONLIB_LazyGetInteger64(&root, &integer));
+	assert(JSONLIB_LazyGetTags(&root) == 0);
+	assert(JSONLIB_LazyNextSibling(&root) && JSONLIB_LazyGetString(&root, NULL) == NULL);
+
+	JSONLIB_DestroyLazy(document);
+
+	assert(JSONLIB_ParseLazy("{\"a\" 1}", 7) == NULL);
+	assert(JSONLIB_ParseLazy("[1,2}", 5) == NULL);
+	assert(JSONLIB_ParseLazy("[1,]", 4) == NULL);
+	assert(JSONLIB_ParseLazy("{\"a\":1,}", 8) == NULL);
+	assert(JSONLIB_ParseLazy("1 2", 3) == NULL);
+	assert(JSONLIB_ParseLazy("\"abc", 4) == NULL);
+	assert(JSONLIB_ParseLazy("", 0) == NULL);
+
+	assert(allocations == 0);
+
+	return 0;
+}
@@ -0,0 +1,55 @@
+#include <include/jsonlib/json.h>
+
+#include <assert.h>
+#include <string.h>
+
+#include "json_test_allocator.h"
+
+int main()
+{
+	const char* str = "{\"id\":-9223372036854775808,\"n\":[0,7,42,-100,4294967295,18446744073709551615],\"ok\":true,\"no\":false,"
+		"\"nothing\":null,\"pi\":3.14159,\"s\":\"tab\\there \\\"quoted\\\"\"}";
+	const char* expected = "{\"id\":-9223372036854775808,\"n\":[0,7,42,-100,4294967295,18446744073709551615],\"ok\":true,\"no\":false,"
+		"\"nothing\":null,\"pi\":3.14159,\"s\":\"tab\\there \\\"quoted\\\"\"}";
+
+	InitTESTAllocatorContext();
+	JSONLIB_SetAllocator(TESTAllocate, TESTDeallocate);
+
+	JSON* json = JSONLIB_ParseJSON(str, (u32)strlen(str));
+
+	assert(json != NULL);
+
+	const size_t length = JSONLIB_MeasureJSON(json, 0);
+
+	assert(length == strlen(expected));
+
+	// NOTE: @Jon
+	// Measuring and writing into a caller buffer never touch the allocator
+	const u32 allocationsBefore = totalAllocations;
+	char buffer[256];
+
+	assert(JSONLIB_MakeJSONInto(json, buffer, sizeof(buffer), 0) == length);
+	assert(!strcmp(buffer, expected));
+	assert(totalAllocations == allocationsBefore);
+
+	// NOTE: @Jon
+	// A buffer without room for the terminator gives back the length it needed
+	char small[16];
+
+	assert(JSONLIB_MakeJSONInto(json, small, sizeof(small), 0) == length);
+	assert(JSONLIB_MakeJSONInto(json, buffer, length, 0) == length);
+
+	const size_t prettyLength = JSONLIB_MeasureJSON(json, JSON_MAKE_HUMAN_READABLE);
+	const char* pretty = JSONLIB_MakeJSON(json, true);
+
+	assert(prettyLength == strlen(pretty));
+	assert(JSONLIB_MakeJSONInto(json, buffer, sizeof(buffer), JSON_MAKE_HUMAN_READABLE) == prettyLength);
+	assert(!strcmp(buffer, pretty));
+
+	JSONLIB_ClearJSON(pretty);
+	JSONLIB_FreeJSON(json);
+
+	assert(allocations == 0);
+
+	return 0;
+}
@@ -0,0 +1,106 @@
+#include <include/jsonlib/json.h>
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "json_test_allocator.h"
+
+// NOTE: @Jon
+// Names given to the builders are freed with the tree so they come from the allocator too
+char* MakeName(const char* format, u32 i)
+{
+	char buffer[32];
+	const int length = sprintf(buffer, format, i);
+	char* name = (char*)TESTAllocate(length + 1);
+	memcpy(name, buffer, length + 1);
+	return name;
+}
+
+int main()
+{
+	InitTESTAllocatorContext();
+	JSONLIB_SetAllocator(TESTAllocate, TESTDeallocate);
+
+	char str[4096];
+	u32 length = (u32)sprintf(str, "{\"k5\":\"first\"");
+	for (u32 i = 0; i < 100; ++i)
+		length += (u32)sprintf(&str[length], ",\"k%u\":%u", i, i);
+	length += (u32)sprintf(&str[length], ",\"a long name that spans a few words\":true,\"\":null}");
+
+	// NOTE: @Jon
+	// A duplicate name finds its first member, the same as without an index
+	JSON* json = JSONLIB_ParseJSON(str, length);
+
+	assert(json != NULL && json->index != NULL);
+	assert(JSONLIB_GetValueJSON("k5", 2, json)->tags == JSON_STRING_TAG);
+	assert(JSONLIB_GetValueJSON("k99", 3, json)->integer == 99);
+	assert(JSONLIB_GetValueJSON("k9", 2, json)->integer == 9);
+	assert(JSONLIB_GetValueJSON("a long name that spans a few words", 34, json)->boolean);
+	assert(JSONLIB_GetValueJSON("", 0, json)->tags == JSON_NULL_TAG);
+	assert(JSONLIB_GetValueJSON("k100", 4, json) == NULL);
+	assert(JSONLIB_GetValueJSON("k9", 1, json) == NULL);
+
+	JSONLIB_Key key = JSONLIB_MakeKey("k42", 3);
+
+	assert(JSONLIB_GetValueByKeyJSON(&key, json)->integer == 42);
+
+	// NOTE: @Jon
+	// Freeing a member takes it out of the index
+	JSONLIB_FreeJSON(JSONLIB_GetValueJSON("k42", 3, json));
+
+	assert(JSONLIB_GetValueByKeyJSON(&key, json) == NULL);
+	assert(JSONLIB_GetValueJSON("k43", 3, json)->integer == 43);
+
+	JSONLIB_FreeJSON(json);
+
+	// NOTE: @Jon
+	// Small objects aren't indexed but keys still work on them
+	json = JSONLIB_ParseJSON("{\"k42\":1,\"x\":[]}", 16);
+
+	assert(json != NULL && json->index == NULL);
+	assert(JSONLIB_GetValueByKeyJSON(&key, json)->integer == 1);
+	assert(!JSONLIB_IndexJSON(JSONLIB_GetValueJSON("x", 1, json), NULL));
+	assert(JSONLIB_IndexJSON(json, NULL));
+	assert(JSONLIB_GetValueByKeyJSON(&key, json)->integer == 1);
+
+	JSONLIB_FreeJSON(json);
+
+	// NOTE: @Jon
+	// Adding members keeps the index up to date as it grows
+	JSON* root = JSONLIB_AllocateJSON(NULL, NULL);
+	JSONLIB_AllocateIntegerJSON(MakeName("m%u", 0), root, 0);
+
+	assert(JSONLIB_IndexJSON(root, NULL));
+
+	for (u32 i = 1; i < 200; ++i)
+		JSONLIB_AllocateIntegerJSON(MakeName("m%u", i), root, (i32)i);
+
+	for (u32 i = 0; i < 200; ++i)
+	{
+		char name[16];
+		const u32 nameLength = (u32)sprintf(name, "m%u", i);
+		assert(JSONLIB_GetValueJSON(name, nameLength, root)->integer == (i32)i);
+	}
+
+	JSONLIB_FreeJSON(root);
+
+	// NOTE: @Jon
+	// Arena trees keep their index in the arena
+	JSONLIB_Arena* arena = JSONLIB_CreateArena(0);
+	json = JSONLIB_ParseJSONArena(arena, str, length);
+
+	assert(json != NULL && json->index != NULL);
+	assert(JSONLIB_GetValueByKeyJSON(&key, json)->integer == 42);
+
+	json = JSONLIB_ParseJSONArena(arena, "{\"a\":1,\"b\":2}", 13);
+
+	assert(JSONLIB_IndexJSON(json, arena));
+	assert(JSONLIB_GetValueJSON("b", 1, json)->integer == 2);
+
+	JSONLIB_DestroyArena(arena);
+
+	assert(allocations == 0);
+
+	return 0;
+}
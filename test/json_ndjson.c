@@ -0,0 +1,184 @@
+#include <include/jsonlib/json.h>
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "json_test_allocator.h"
+
+#define RECORD_COUNT 20000
+
+typedef struct RECORDS
+{
+	u32 count;
+	u32 stopAt;
+	bool inOrder;
+} RECORDS;
+
+// NOTE: @Jon
+// How many more allocations succeed before they start failing, -1 never fails
+i32 allocationsLeft = -1;
+
+void* FailingAllocate(size_t size)
+{
+	if (allocationsLeft == 0)
+		return NULL;
+	if (allocationsLeft > 0)
+		allocationsLeft--;
+	return TESTAllocate(size);
+}
+
+// NOTE: @Jon
+// Every 97th record is cut short, every 50th is followed by a blank line and odd ones end in CRLF
+char* MakeLines(size_t* length)
+{
+	char* buffer = (char*)malloc(RECORD_COUNT * 64);
+	size_t offset = 0;
+	for (u32 i = 0; i < RECORD_COUNT; ++i)
+	{
+		if (i % 97 == 0)
+			offset += sprintf(&buffer[offset], "{\"id\":%u,\"v\":[", i);
+		else
+			offset += sprintf(&buffer[offset], "{\"id\":%u,\"v\":[%u,\"x\",true]}", i, i * 3);
+		offset += sprintf(&buffer[offset], i % 2 ? "\r\n" : "\n");
+		if (i % 50 == 0)
+			offset += sprintf(&buffer[offset], "  \n");
+	}
+	*length = offset;
+	return buffer;
+}
+
+// NOTE: @Jon
+// Checks a record is the one expected next in input order
+bool CheckRecord(void* context, JSON* json, const char* record, size_t recordLength)
+{
+	RECORDS* records = (RECORDS*)context;
+	const u32 index = records->count++;
+	if (index % 97 == 0)
+	{
+		records->inOrder &= json == NULL;
+	}
+	else
+	{
+		JSON* id = json != NULL ? JSONLIB_GetValueJSON("id", 2, json) : NULL;
+		records->inOrder &= id != NULL && id->integer == (i32)index;
+	}
+	records->inOrder &= record[0] == '{' && record[recordLength - 1] != '\r';
+	return records->count != records->stopAt;
+}
+
+int main()
+{
+	size_t length;
+	char* buffer = MakeLines(&length);
+
+	// NOTE: @Jon
+	// However many threads parse it, the records come back in input order
+	for (u32 threadCount = 0; threadCount <= 4; ++threadCount)
+	{
+		JSONLIB_Batch* batch = JSONLIB_ParseNDJSON(buffer, length, threadCount, 0);
+
+		assert(JSONLIB_GetBatchCount(batch) == RECORD_COUNT);
+
+		for (u32 i = 0; i < RECORD_COUNT; ++i)
+		{
+			JSON* json = JSONLIB_GetBatchJSON(batch, i);
+			if (i % 97 == 0)
+			{
+				assert(json == NULL);
+			}
+			else
+			{
+				assert(json != NULL && JSONLIB_GetValueJSON("id", 2, json)->integer == (i32)i);
+				assert(json->values[1]->values[0]->integer == (i32)(i * 3));
+			}
+		}
+
+		JSONLIB_DestroyBatch(batch);
+	}
+
+	RECORDS records = { 0, 0, true };
+
+	assert(JSONLIB_StreamNDJSON(buffer, length, 4, JSON_PARSE_BORROW_STRINGS, CheckRecord, &records));
+	assert(records.count == RECORD_COUNT && records.inOrder);
+
+	// NOTE: @Jon
+	// The callback can stop it early
+	records.count = 0;
+	records.stopAt = 1234;
+
+	assert(!JSONLIB_StreamNDJSON(buffer, length, 3, 0, CheckRecord, &records));
+	assert(records.count == 1234 && records.inOrder);
+
+	// NOTE: @Jon
+	// Files are read a block at a time
+	FILE* file = fopen("json_ndjson_test.ndjson", "wb");
+	assert(file != NULL);
+	fwrite(buffer, 1, length, file);
+	fclose(file);
+
+	records.count = 0;
+	records.stopAt = 0;
+
+	assert(JSONLIB_StreamNDJSONFile("json_ndjson_test.ndjson", 2, 0, CheckRecord, &records));
+	assert(records.count == RECORD_COUNT && records.inOrder);
+
+	remove("json_ndjson_test.ndjson");
+
+	assert(!JSONLIB_StreamNDJSONFile("json_ndjson_missing.ndjson", 2, 0, CheckRecord, &records));
+
+	// NOTE: @Jon
+	// Only a single worker so the test allocator's counts aren't shared between threads
+	InitTESTAllocatorContext();
+	JSONLIB_SetAllocator(TESTAllocate, TESTDeallocate);
+
+	JSONLIB_Batch* batch = JSONLIB_ParseNDJSON(buffer, length, 1, 0);
+
+	assert(JSONLIB_GetBatchCount(batch) == RECORD_COUNT);
+
+	JSONLIB_DestroyBatch(batch);
+
+	batch = JSONLIB_ParseNDJSON("", 0, 1, 0);
+
+	assert(JSONLIB_GetBatchCount(batch) == 0);
+
+	JSONLIB_DestroyBatch(batch);
+
+	assert(allocations == 0);
+
+	// NOTE: @Jon
+	// Running out of memory anywhere gives back failure with nothing left allocated
+	JSONLIB_SetAllocator(FailingAllocate, TESTDeallocate);
+
+	for (i32 i = 0; i < 8; ++i)
+	{
+		allocationsLeft = i;
+		batch = JSONLIB_ParseNDJSON(buffer, length, 1, 0);
+		allocationsLeft = -1;
+
+		assert(batch == NULL || JSONLIB_GetBatchCount(batch) == RECORD_COUNT);
+
+		JSONLIB_DestroyBatch(batch);
+
+		records.count = 0;
+		allocationsLeft = i;
+		const bool streamed = JSONLIB_StreamNDJSON(buffer, length, 1, 0, CheckRecord, &records);
+		allocationsLeft = -1;
+
+		assert(!streamed || records.count == RECORD_COUNT);
+		assert(allocations == 0);
+	}
+
+	allocationsLeft = 0;
+
+	assert(JSONLIB_ParseNDJSON(buffer, length, 1, 0) == NULL);
+	assert(!JSONLIB_StreamNDJSON(buffer, length, 1, 0, CheckRecord, &records));
+
+	allocationsLeft = -1;
+	JSONLIB_SetAllocator(TESTAllocate, TESTDeallocate);
+
+	free(buffer);
+
+	return 0;
+}
@@ -0,0 +1,128 @@
+#include <include/jsonlib/json.h>
+
+#include <assert.h>
+#include <string.h>
+
+#include "json_test_allocator.h"
+
+int main()
+{
+	const char* str = "{\"object\":{\"value\":12},\"array\":[\"bananas\",7,{},null,true],\"boolean\":true}";
+
+	InitTESTAllocatorContext();
+	JSONLIB_SetAllocator(TESTAllocate, TESTDeallocate);
+
+	JSONLIB_NodePool* pool = JSONLIB_CreateNodePool(4);
+
+	assert(pool != NULL);
+
+	JSONLIB_UseNodePool(pool);
+
+	JSON* json = JSONLIB_ParseJSON(str, strlen(str));
+
+	assert(json != NULL);
+
+	const u32 parseAllocations = allocations;
+	const char* jsonStr = JSONLIB_MakeJSON(json, false);
+
+	assert(!strcmp(str, jsonStr));
+
+	JSONLIB_ClearJSON(jsonStr);
+
+	// NOTE: @Jon
+	// Ten nodes take three slabs of four, which stay with the pool once the tree is freed
+	JSONLIB_FreeJSON(json);
+
+	assert(allocations == 4);
+
+	// NOTE: @Jon
+	// Parsing again reuses the freed nodes instead of allocating more slabs
+	json = JSONLIB_ParseJSON(str, strlen(str));
+
+	assert(json != NULL && allocations == parseAllocations);
+
+	JSONLIB_FreeJSON(JSONLIB_GetValueJSON("array", 5, json));
+
+	assert(json->values[1] == NULL);
+
+	JSONLIB_FreeJSON(json);
+
+	// NOTE: @Jon
+	// Built trees come from the pool too, and nodes from before the pool went back to the allocator
+	JSONLIB_UseNodePool(NULL);
+	json = JSONLIB_AllocateJSON(NULL, NULL);
+	json->tags = JSON_ARRAY_TAG;
+	JSONLIB_UseNodePool(pool);
+
+	for (i32 i = 0; i < 20; ++i)
+		JSONLIB_AllocateIntegerJSON(NULL, json, i);
+
+	assert(json->valueCount == 20 && json->values[19]->integer == 19);
+
+	JSONLIB_FreeJSON(json);
+
+	const u32 pooledAllocations = allocations;
+	json = JSONLIB_AllocateJSON(NULL, NULL);
+
+	assert(allocations == pooledAllocations);
+
+	JSONLIB_FreeJSON(json);
+
+	// NOTE: @Jon
+	// Pooled nodes go back to the pool they came from, even with no pool or another pool in use
+	JSONLIB_NodePool* other = JSONLIB_CreateNodePool(4);
+	json = JSONLIB_ParseJSON(str, strlen(str));
+	JSON* second = JSONLIB_ParseJSON(str, strlen(str));
+
+	assert(json != NULL && second != NULL);
+
+	JSONLIB_UseNodePool(NULL);
+	JSONLIB_FreeJSON(json);
+	JSONLIB_UseNodePool(other);
+	JSONLIB_FreeJSON(second);
+
+	const u32 otherAllocations = allocations;
+	json = JSONLIB_AllocateJSON(NULL, NULL);
+
+	assert(allocations == otherAllocations + 1);
+
+	JSONLIB_FreeJSON(json);
+	JSONLIB_DestroyNodePool(other);
+	JSONLIB_UseNodePool(pool);
+
+	const u32 reusedAllocations = allocations;
+	json = JSONLIB_ParseJSON(str, strlen(str));
+	second = JSONLIB_ParseJSON(str, strlen(str));
+
+	assert(json != NULL && second != NULL);
+
+	JSONLIB_FreeJSON(json);
+	JSONLIB_FreeJSON(second);
+
+	assert(allocations == reusedAllocations);
+
+	// NOTE: @Jon
+	// Arena trees are left to their arena
+	JSONLIB_Arena* arena = JSONLIB_CreateArena(0);
+	json = JSONLIB_ParseJSONArena(arena, str, strlen(str));
+
+	assert(json != NULL && allocations == pooledAllocations + 2);
+
+	JSONLIB_DestroyArena(arena);
+
+	// NOTE: @Jon
+	// Destroying the pool stops the thread using it
+	JSONLIB_DestroyNodePool(pool);
+
+	assert(allocations == 0);
+
+	json = JSONLIB_ParseJSON(str, strlen(str));
+
+	assert(json != NULL);
+
+	JSONLIB_FreeJSON(json);
+
+	assert(allocations == 0);
+
+	return 0;
+}
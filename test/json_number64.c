@@ -0,0 +1,103 @@
+#include <include/jsonlib/json.h>
+
+#include <assert.h>
+#include <string.h>
+
+#include "json_test_allocator.h"
+
+int main()
+{
+	const char* str = "{\"id\":9007199254740993,\"max\":18446744073709551615,\"min\":-9223372036854775808,\"small\":-7,"
+		"\"pi\":3.141592653589793,\"tiny\":5e-324,\"long\":0.1000000000000000055511151231257827021181583404541015625}";
+
+	InitTESTAllocatorContext();
+	JSONLIB_SetAllocator(TESTAllocate, TESTDeallocate);
+
+	JSON* json = JSONLIB_ParseJSON(str, (u32)strlen(str));
+
+	assert(json != NULL);
+	assert(json->valueCount == 7);
+
+	JSON* id = JSONLIB_GetValueJSON("id", 2, json);
+
+	assert(id->tags == (JSON_INTEGER64_TAG | JSON_UNSIGNED64_TAG));
+	assert(id->integer64 == 9007199254740993LL);
+
+	JSON* max = JSONLIB_GetValueJSON("max", 3, json);
+
+	assert(max->tags == JSON_UNSIGNED64_TAG);
+	assert(max->unsigned64 == 18446744073709551615ULL);
+
+	JSON* min = JSONLIB_GetValueJSON("min", 3, json);
+
+	assert(min->tags == JSON_INTEGER64_TAG);
+	assert(min->integer64 == -9223372036854775807LL - 1);
+
+	// NOTE: @Jon
+	// Small integers still fill in the 32 bit member
+	JSON* small = JSONLIB_GetValueJSON("small", 5, json);
+
+	assert(small->tags == (JSON_INTEGER_TAG | JSON_INTEGER64_TAG));
+	assert(small->integer == -7 && small->integer64 == -7);
+
+	JSON* pi = JSONLIB_GetValueJSON("pi", 2, json);
+
+	assert(pi->tags == (JSON_DECIMAL_TAG | JSON_DECIMAL64_TAG));
+	assert(pi->decimal64 == 3.141592653589793);
+	assert(pi->decimal == 3.141592653589793f);
+
+	assert(JSONLIB_GetValueJSON("tiny", 4, json)->decimal64 == 5e-324);
+	assert(JSONLIB_GetValueJSON("long", 4, json)->decimal64 == 0.1);
+
+	const char* jsonStr = JSONLIB_MakeJSON(json, false);
+
+	assert(strstr(jsonStr, "\"id\":9007199254740993,\"max\":18446744073709551615,\"min\":-9223372036854775808,\"small\":-7,\"pi\":3.141592653589793,") != NULL);
+
+	JSONLIB_ClearJSON((void*)jsonStr);
+	JSONLIB_FreeJSON(json);
+
+	// NOTE: @Jon
+	// Long numbers that land exactly halfway between two doubles round to the even one, any digit past that settles it
+	const char* halfway = "[1.00000000000000011102230246251565404236316680908203125,"
+		"1.00000000000000011102230246251565404236316680908203125000000000000000000001,"
+		"1.00000000000000011102230246251565404236316680908203124999999999999999999999]";
+	json = JSONLIB_ParseJSON(halfway, strlen(halfway));
+
+	assert(json != NULL);
+	assert(json->values[0]->decimal64 == 1.0);
+	assert(json->values[1]->decimal64 == 1.0000000000000002);
+	assert(json->values[2]->decimal64 == 1.0);
+
+	JSONLIB_FreeJSON(json);
+
+	// NOTE: @Jon
+	// Numbers past the biggest double are turned away instead of becoming infinity
+	json = JSONLIB_ParseJSON("[1.7976931348623158e308]", 24);
+
+	assert(json != NULL && json->values[0]->decimal64 == 1.7976931348623157e308);
+
+	JSONLIB_FreeJSON(json);
+
+	assert(JSONLIB_ParseJSON("[1e400]", 7) == NULL);
+	assert(JSONLIB_ParseJSON("-1e400", 6) == NULL);
+	assert(JSONLIB_ParseJSON("[1.7976931348623159e308]", 24) == NULL);
+
+	JSON* built = JSONLIB_AllocateJSON(NULL, NULL);
+	built->tags = JSON_ARRAY_TAG;
+
+	JSONLIB_AllocateInteger64JSON(NULL, built, 1700000000123LL);
+	JSONLIB_AllocateUnsigned64JSON(NULL, built, 0xFFFFFFFFFFFFFFFEULL);
+	JSONLIB_AllocateDecimal64JSON(NULL, built, 0.25);
+	JSONLIB_AllocateDecimal64JSON(NULL, built, 2.0);
+
+	jsonStr = JSONLIB_MakeJSON(built, false);
+
+	assert(!strcmp(jsonStr, "[1700000000123,18446744073709551614,0.25,2.0]"));
+
+	JSONLIB_ClearJSON((void*)jsonStr);
+	JSONLIB_FreeJSON(built);
+
+	assert(allocations == 0);
+
+	return 0;
+}
@@ -0,0 +1,148 @@
+#include <include/jsonlib/json.h>
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "json_test_allocator.h"
+
+#define ELEMENT_COUNT 40000
+
+// NOTE: @Jon
+// How many more allocations succeed before they start failing, -1 never fails
+i32 allocationsLeft = -1;
+
+void* FailingAllocate(size_t size)
+{
+	if (allocationsLeft == 0)
+		return NULL;
+	if (allocationsLeft > 0)
+		allocationsLeft--;
+	return TESTAllocate(size);
+}
+
+// NOTE: @Jon
+// Strings full of commas, brackets and escaped quotes so only a scan that knows about strings splits it right
+char* MakeDocument(bool object, size_t* length)
+{
+	char* buffer = (char*)malloc(ELEMENT_COUNT * 128);
+	size_t offset = 0;
+	buffer[offset++] = object ? '{' : '[';
+	for (u32 i = 0; i < ELEMENT_COUNT; ++i)
+	{
+		if (i > 0)
+			buffer[offset++] = ',';
+		if (object)
+			offset += sprintf(&buffer[offset], "\"k%u\":", i);
+		offset += sprintf(&buffer[offset], "{\"id\":%u,\"s\":\"a,]}\\\",[%u\",\"v\":[%u.5,[{}],null]}", i, i, i);
+	}
+	buffer[offset++] = object ? '}' : ']';
+	buffer[offset] = '\0';
+	*length = offset;
+	return buffer;
+}
+
+// NOTE: @Jon
+// Checks a parallel parse against a single threaded one
+void CheckParallel(const char* str, size_t length, JSONLIB_Arena* arena)
+{
+	JSON* expected = JSONLIB_ParseJSONEx(str, (u32)length, 0, NULL);
+	JSON* json = JSONLIB_ParseJSONParallel(str, length, 4, 0, arena);
+
+	assert(expected != NULL && json != NULL);
+	assert(json->valueCount == ELEMENT_COUNT);
+
+	const char* expectedStr = JSONLIB_MakeJSON(expected, false);
+	const char* jsonStr = JSONLIB_MakeJSON(json, false);
+
+	assert(!strcmp(jsonStr, expectedStr));
+
+	for (u32 i = 0; i < json->valueCount; ++i)
+	{
+		assert(json->values[i]->parent == json);
+	}
+
+	JSONLIB_ClearJSON(jsonStr);
+	JSONLIB_ClearJSON(expectedStr);
+	JSONLIB_FreeJSON(json);
+	JSONLIB_FreeJSON(expected);
+}
+
+int main()
+{
+	size_t length;
+	char* array = MakeDocument(false, &length);
+
+	CheckParallel(array, length, NULL);
+
+	JSONLIB_Arena* arena = JSONLIB_CreateArena(0);
+	CheckParallel(array, length, arena);
+
+	// NOTE: @Jon
+	// The subtrees handed over to the arena stay put when it's used again
+	JSON* json = JSONLIB_ParseJSONParallel(array, length, 3, JSON_PARSE_STRUCTURAL_INDEX, arena);
+	JSON* other = JSONLIB_ParseJSONArena(arena, "[1,2,3]", 7);
+
+	assert(json != NULL && other != NULL);
+	assert(json->valueCount == ELEMENT_COUNT && json->values[ELEMENT_COUNT - 1]->values[0]->integer == ELEMENT_COUNT - 1);
+
+	JSONLIB_DestroyArena(arena);
+
+	// NOTE: @Jon
+	// A malformed member anywhere fails the whole parse
+	char* comma = strstr(&array[length / 2], ",{");
+	comma[1] = ',';
+
+	assert(JSONLIB_ParseJSONParallel(array, length, 4, 0, NULL) == NULL);
+
+	comma[1] = '{';
+	array[length - 1] = '}';
+
+	assert(JSONLIB_ParseJSONParallel(array, length, 4, 0, NULL) == NULL);
+
+	free(array);
+
+	char* object = MakeDocument(true, &length);
+
+	CheckParallel(object, length, NULL);
+
+	// NOTE: @Jon
+	// Small documents and a single thread take the usual path, which the test allocator can count
+	InitTESTAllocatorContext();
+	JSONLIB_SetAllocator(TESTAllocate, TESTDeallocate);
+
+	json = JSONLIB_ParseJSONParallel(object, length, 1, 0, NULL);
+
+	assert(json != NULL && json->valueCount == ELEMENT_COUNT);
+
+	JSONLIB_FreeJSON(json);
+
+	const char* small = " [1, {\"a\": 2}] ";
+	json = JSONLIB_ParseJSONParallel(small, strlen(small), 4, 0, NULL);
+
+	assert(json != NULL && json->valueCount == 2);
+
+	JSONLIB_FreeJSON(json);
+
+	assert(allocations == 0);
+
+	// NOTE: @Jon
+	// Running out of memory before any thread is started gives back NULL with nothing left allocated
+	JSONLIB_SetAllocator(FailingAllocate, TESTDeallocate);
+
+	for (i32 i = 0; i < 2; ++i)
+	{
+		allocationsLeft = i;
+
+		assert(JSONLIB_ParseJSONParallel(object, length, 4, 0, NULL) == NULL);
+		assert(allocations == 0);
+	}
+
+	allocationsLeft = -1;
+	JSONLIB_SetAllocator(TESTAllocate, TESTDeallocate);
+
+	free(object);
+
+	return 0;
+}
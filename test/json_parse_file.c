@@ -0,0 +1,65 @@
+#include <include/jsonlib/json.h>
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "json_test_allocator.h"
+
+void WriteFile(const char* path, const char* str)
+{
+	FILE* file = fopen(path, "wb");
+	assert(file != NULL);
+	fwrite(str, 1, strlen(str), file);
+	fclose(file);
+}
+
+int main()
+{
+	const char* str = "{\"fruits\":[\"apple\",\"ba\\nana\"],\"count\":12,\"price\":1.5,\"sold\":true}";
+	const char* path = "json_parse_file_test.json";
+
+	InitTESTAllocatorContext();
+	JSONLIB_SetAllocator(TESTAllocate, TESTDeallocate);
+
+	WriteFile(path, str);
+
+	JSON* json = JSONLIB_ParseFile(path, 0);
+
+	assert(json != NULL);
+
+	const char* jsonStr = JSONLIB_MakeJSON(json, false);
+
+	assert(!strcmp(str, jsonStr));
+
+	JSONLIB_ClearJSON((void*)jsonStr);
+	JSONLIB_FreeJSON(json);
+
+	// NOTE: @Jon
+	// Borrowing is dropped since the mapping is gone after the parse, so the tree still reads back afterwards
+	json = JSONLIB_ParseFile(path, JSON_PARSE_BORROW_STRINGS | JSON_PARSE_STRUCTURAL_INDEX);
+
+	assert(json != NULL);
+	assert(!strcmp(JSONLIB_GetValueJSON("fruits", 6, json)->values[0]->string, "apple"));
+	assert(JSONLIB_GetValueJSON("count", 5, json)->integer == 12);
+
+	JSONLIB_FreeJSON(json);
+
+	// NOTE: @Jon
+	// Files that aren't valid JSON, are empty or don't exist give back NULL
+	WriteFile(path, "[1,2");
+
+	assert(JSONLIB_ParseFile(path, 0) == NULL);
+
+	WriteFile(path, "");
+
+	assert(JSONLIB_ParseFile(path, 0) == NULL);
+
+	remove(path);
+
+	assert(JSONLIB_ParseFile(path, 0) == NULL);
+
+	assert(allocations == 0);
+
+	return 0;
+}
@@ -0,0 +1,76 @@
+#include <include/jsonlib/json.h>
+
+#include <assert.h>
+#include <string.h>
+
+#include "json_test_allocator.h"
+
+JSON* Eval(const char* pointer, JSON* json)
+{
+	JSONLIB_Path* path = JSONLIB_CompilePath(pointer);
+	assert(path != NULL);
+
+	JSON* value = JSONLIB_EvalPath(path, json);
+	JSONLIB_DestroyPath(path);
+	return value;
+}
+
+int main()
+{
+	const char* str = "{\"orders\":[{\"items\":[{\"sku\":\"a1\"},{\"sku\":\"b2\"}]},{\"items\":[]}],"
+		"\"a/b\":1,\"m~n\":2,\"\":3,\"10\":{\"0\":4},\" \":5}";
+
+	InitTESTAllocatorContext();
+	JSONLIB_SetAllocator(TESTAllocate, TESTDeallocate);
+
+	JSON* json = JSONLIB_ParseJSON(str, strlen(str));
+
+	assert(json != NULL);
+
+	// NOTE: @Jon
+	// A compiled path can be used again and again
+	JSONLIB_Path* path = JSONLIB_CompilePath("/orders/0/items/1/sku");
+
+	assert(path != NULL);
+
+	for (u32 i = 0; i < 3; ++i)
+	{
+		JSON* sku = JSONLIB_EvalPath(path, json);
+		assert(sku != NULL && !strcmp(sku->string, "b2"));
+	}
+
+	JSONLIB_DestroyPath(path);
+
+	assert(Eval("", json) == json);
+	assert(Eval("/orders", json)->valueCount == 2);
+	assert(Eval("/orders/1/items", json)->valueCount == 0);
+	assert(Eval("/a~1b", json)->integer == 1);
+	assert(Eval("/m~0n", json)->integer == 2);
+	assert(Eval("/", json)->integer == 3);
+	assert(Eval("/ ", json)->integer == 5);
+
+	// NOTE: @Jon
+	// Digits are names in an object and indexes in an array
+	assert(Eval("/10/0", json)->integer == 4);
+
+	// NOTE: @Jon
+	// Paths to nothing give back NULL
+	assert(Eval("/orders/2", json) == NULL);
+	assert(Eval("/orders/-", json) == NULL);
+	assert(Eval("/orders/01", json) == NULL);
+	assert(Eval("/orders/0/items/0/sku/x", json) == NULL);
+	assert(Eval("/missing", json) == NULL);
+	assert(Eval("/orders/99999999999", json) == NULL);
+
+	// NOTE: @Jon
+	// Pointers have to start with a slash and only escape ~0 and ~1
+	assert(JSONLIB_CompilePath("orders") == NULL);
+	assert(JSONLIB_CompilePath("/a~2") == NULL);
+	assert(JSONLIB_CompilePath("/a~") == NULL);
+
+	JSONLIB_FreeJSON(json);
+
+	assert(allocations == 0);
+
+	return 0;
+}
@@ -0,0 +1,85 @@
+#include <include/jsonlib/json.h>
+
+#include <assert.h>
+#include <string.h>
+
+#include "json_test_allocator.h"
+
+const char* Project(const char* str, const char** pointers, u32 pointerCount)
+{
+	assert(pointerCount <= 8);
+	JSONLIB_Path* paths[8] = { 0 };
+	for (u32 i = 0; i < pointerCount; ++i)
+	{
+		paths[i] = JSONLIB_CompilePath(pointers[i]);
+		assert(paths[i] != NULL);
+	}
+
+	JSON* json = JSONLIB_ParseJSONProjected(str, strlen(str), (const JSONLIB_Path* const*)paths, pointerCount);
+	const char* jsonStr = json != NULL ? JSONLIB_MakeJSON(json, false) : NULL;
+
+	JSONLIB_FreeJSON(json);
+	for (u32 i = 0; i < pointerCount; ++i)
+		JSONLIB_DestroyPath(paths[i]);
+	return jsonStr;
+}
+
+void CheckProject(const char* str, const char** pointers, u32 pointerCount, const char* expected)
+{
+	const char* jsonStr = Project(str, pointers, pointerCount);
+	assert(jsonStr != NULL && !strcmp(jsonStr, expected));
+	JSONLIB_ClearJSON(jsonStr);
+}
+
+int main()
+{
+	const char* str = "{\"id\":42,\"user\":{\"name\":\"ann\",\"tier\":3,\"tags\":[\"a\",\"b\"]},"
+		"\"items\":[{\"sku\":\"x1\",\"qty\":1},{\"sku\":\"y2\",\"qty\":2},{\"sku\":\"z3\",\"qty\":3}],\"n\\u0061me\":\"esc\"}";
+
+	InitTESTAllocatorContext();
+	JSONLIB_SetAllocator(TESTAllocate, TESTDeallocate);
+
+	// NOTE: @Jon
+	// Only the wanted values and the containers on the way to them are built, in document order
+	const char* some[] = { "/user/tier", "/id", "/items/1/sku" };
+	CheckProject(str, some, 3, "{\"id\":42,\"user\":{\"tier\":3},\"items\":[{\"sku\":\"y2\"}]}");
+
+	// NOTE: @Jon
+	// A path that ends at a container takes all of it, even when a longer path goes through it too
+	const char* whole[] = { "/user/tags/1", "/user" };
+	CheckProject(str, whole, 2, "{\"user\":{\"name\":\"ann\",\"tier\":3,\"tags\":[\"a\",\"b\"]}}");
+
+	// NOTE: @Jon
+	// Escaped names match, and paths that lead nowhere are left out
+	const char* escaped[] = { "/name", "/missing", "/id/deeper", "/items/7" };
+	CheckProject(str, escaped, 4, "{\"name\":\"esc\"}");
+
+	const char* empty[] = { "" };
+	CheckProject("[1,{\"a\":2}]", empty, 1, "[1,{\"a\":2}]");
+	CheckProject("[1,{\"a\":2}]", NULL, 0, "[]");
+
+	// NOTE: @Jon
+	// The tree is an ordinary one
+	JSONLIB_Path* path = JSONLIB_CompilePath("/user/name");
+	JSON* json = JSONLIB_ParseJSONProjected(str, strlen(str), (const JSONLIB_Path* const*)&path, 1);
+
+	assert(!strcmp(JSONLIB_GetValueJSON("name", 4, JSONLIB_GetValueJSON("user", 4, json))->string, "ann"));
+
+	JSONLIB_AddValueJSON(json, JSONLIB_AllocateIntegerJSON(NULL, NULL, 5));
+	JSONLIB_FreeJSON(json);
+	JSONLIB_DestroyPath(path);
+
+	// NOTE: @Jon
+	// Skipped values aren't checked but projected ones are, and the structure always is
+	const char* bad = "{\"ok\":1,\"skipped\":01x,\"bad\":tru}";
+	const char* ok[] = { "/ok" };
+	const char* notOk[] = { "/bad" };
+	CheckProject(bad, ok, 1, "{\"ok\":1}");
+
+	assert(Project(bad, notOk, 1) == NULL);
+	assert(Project("{\"ok\":1,", ok, 1) == NULL);
+
+	assert(allocations == 0);
+
+	return 0;
+}
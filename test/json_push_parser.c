@@ -0,0 +1,161 @@
+#include <include/jsonlib/json.h>
+
+#include <assert.h>
+#include <string.h>
+
+#include "json_test_allocator.h"
+
+typedef struct EVENTS
+{
+	i64 sum;
+	f64 decimal;
+	u32 keys;
+	u32 ends;
+	char lastString[32];
+} EVENTS;
+
+bool EventInteger(void* user, i64 integer)
+{
+	((EVENTS*)user)->sum += integer;
+	return true;
+}
+
+bool EventDecimal(void* user, f64 decimal)
+{
+	((EVENTS*)user)->decimal += decimal;
+	return true;
+}
+
+bool EventKey(void* user, const char* name, u32 nameLength)
+{
+	(void)name;
+	(void)nameLength;
+	((EVENTS*)user)->keys++;
+	return true;
+}
+
+bool EventEnd(void* user, u32 count)
+{
+	(void)count;
+	((EVENTS*)user)->ends++;
+	return true;
+}
+
+bool EventString(void* user, const char* string, u32 stringLength)
+{
+	EVENTS* events = (EVENTS*)user;
+	assert(stringLength < sizeof(events->lastString));
+	memcpy(events->lastString, string, stringLength);
+	events->lastString[stringLength] = '\0';
+	return true;
+}
+
+// NOTE: @Jon
+// Feeds a document through a push parser in chunks of the given size
+JSON* PushInChunks(const char* str, u32 chunkSize)
+{
+	JSONLIB_PushParser* parser = JSONLIB_CreatePushParserJSON(NULL);
+	const u32 length = (u32)strlen(str);
+	for (u32 offset = 0; offset < length; offset += chunkSize)
+	{
+		char chunk[8];
+		const u32 chunkLength = length - offset < chunkSize ? length - offset : chunkSize;
+		memcpy(chunk, &str[offset], chunkLength);
+		JSONLIB_FeedPushParser(parser, chunk, chunkLength);
+
+		// The parser can't hold on to a chunk after it's been fed
+		memset(chunk, '#', sizeof(chunk));
+	}
+
+	JSON* json = JSONLIB_FinishPushParserJSON(parser);
+	JSONLIB_DestroyPushParser(parser);
+	return json;
+}
+
+int main()
+{
+	const char* str = " {\"name\":\"caf\\u00e9 \\\"x\\\"\",\"values\":[12345678901234,-0.125e1,true,null,\"\xe4\xb8\xad\"],"
+		"\"empty\":{},\"last\":[[],1e2]} ";
+
+	InitTESTAllocatorContext();
+	JSONLIB_SetAllocator(TESTAllocate, TESTDeallocate);
+
+	JSON* expected = JSONLIB_ParseJSON(str, (u32)strlen(str));
+	const char* expectedStr = JSONLIB_MakeJSON(expected, false);
+
+	// NOTE: @Jon
+	// Every chunk size splits the document somewhere different, down to a byte at a time
+	// which cuts through every string, number, escape and UTF-8 sequence
+	for (u32 chunkSize = 1; chunkSize <= 8; ++chunkSize)
+	{
+		JSON* json = PushInChunks(str, chunkSize);
+
+		assert(json != NULL);
+
+		const char* jsonStr = JSONLIB_MakeJSON(json, false);
+
+		assert(!strcmp(jsonStr, expectedStr));
+
+		JSONLIB_ClearJSON(jsonStr);
+		JSONLIB_FreeJSON(json);
+	}
+
+	JSONLIB_ClearJSON(expectedStr);
+	JSONLIB_FreeJSON(expected);
+
+	// NOTE: @Jon
+	// Incomplete and malformed documents fail wherever the chunks split them
+	assert(PushInChunks("{\"a\":1", 2) == NULL);
+	assert(PushInChunks("\"abc", 1) == NULL);
+	assert(PushInChunks("[1,]", 1) == NULL);
+	assert(PushInChunks("[1 2]", 3) == NULL);
+	assert(PushInChunks("[tru]", 2) == NULL);
+	assert(PushInChunks("1 2", 1) == NULL);
+	assert(PushInChunks("{\"a\"1}", 4) == NULL);
+
+	// NOTE: @Jon
+	// A number running up to the end of the document is only finished by JSONLIB_FinishPushParserJSON
+	JSON* number = PushInChunks("-12", 1);
+
+	assert(number != NULL && number->integer == -12);
+
+	JSONLIB_FreeJSON(number);
+
+	JSONLIB_Handler handler;
+	memset(&handler, 0, sizeof(handler));
+	handler.integer = EventInteger;
+	handler.decimal = EventDecimal;
+	handler.key = EventKey;
+	handler.endObject = EventEnd;
+	handler.endArray = EventEnd;
+	handler.string = EventString;
+
+	EVENTS events;
+	memset(&events, 0, sizeof(events));
+
+	JSONLIB_PushParser* parser = JSONLIB_CreatePushParser(&handler, &events);
+
+	assert(JSONLIB_FeedPushParser(parser, "{\"a\":[4", 7));
+	assert(JSONLIB_FeedPushParser(parser, "0,2.", 4));
+	assert(events.sum == 40);
+	assert(JSONLIB_FeedPushParser(parser, "5],\"b\":\"x\\", 10));
+	assert(JSONLIB_FeedPushParser(parser, "ny\"}", 4));
+	assert(JSONLIB_FinishPushParser(parser));
+	assert(events.sum == 40 && events.decimal == 2.5);
+	assert(events.keys == 2 && events.ends == 2);
+	assert(!strcmp(events.lastString, "x\ny"));
+
+	JSONLIB_DestroyPushParser(parser);
+
+	// NOTE: @Jon
+	// A tree that's never taken is freed along with the parser
+	parser = JSONLIB_CreatePushParserJSON(NULL);
+
+	assert(JSONLIB_FeedPushParser(parser, "[\"abc\", {\"d\":", 13));
+
+	JSONLIB_DestroyPushParser(parser);
+
+	assert(allocations == 0);
+
+	return 0;
+}
@@ -0,0 +1,165 @@
+#include <include/jsonlib/json.h>
+
+#include <assert.h>
+#include <string.h>
+
+#include "json_test_allocator.h"
+
+typedef struct COUNTS
+{
+	const char* input;
+	u32 objects;
+	u32 arrays;
+	u32 members;
+	u32 elements;
+	u32 keys;
+	u32 borrowedKeys;
+	i64 sum;
+	u64 big;
+	f64 decimal;
+	u32 trues;
+	u32 nulls;
+	char lastString[32];
+	u32 stopAfterKeys;
+} COUNTS;
+
+bool CountStartObject(void* user)
+{
+	((COUNTS*)user)->objects++;
+	return true;
+}
+
+bool CountStartArray(void* user)
+{
+	((COUNTS*)user)->arrays++;
+	return true;
+}
+
+bool CountEndObject(void* user, u32 memberCount)
+{
+	((COUNTS*)user)->members += memberCount;
+	return true;
+}
+
+bool CountEndArray(void* user, u32 elementCount)
+{
+	((COUNTS*)user)->elements += elementCount;
+	return true;
+}
+
+bool CountInteger(void* user, i64 integer)
+{
+	((COUNTS*)user)->sum += integer;
+	return true;
+}
+
+bool CountUnsigned(void* user, u64 integer)
+{
+	((COUNTS*)user)->big = integer;
+	return true;
+}
+
+bool CountDecimal(void* user, f64 decimal)
+{
+	((COUNTS*)user)->decimal += decimal;
+	return true;
+}
+
+bool CountBoolean(void* user, bool boolean)
+{
+	((COUNTS*)user)->trues += boolean;
+	return true;
+}
+
+bool CountNull(void* user)
+{
+	((COUNTS*)user)->nulls++;
+	return true;
+}
+
+
+bool CountKey(void* user, const char* name, u32 nameLength)
+{
+	COUNTS* counts = (COUNTS*)user;
+	counts->keys++;
+
+	// NOTE: @Jon
+	// Names without escapes are spans of the input rather than copies
+	const size_t inputLength = strlen(counts->input);
+	if (name >= counts->input && name + nameLength <= counts->input + inputLength)
+		counts->borrowedKeys++;
+
+	return counts->stopAfterKeys == 0 || counts->keys < counts->stopAfterKeys;
+}
+
+bool CountString(void* user, const char* string, u32 stringLength)
+{
+	COUNTS* counts = (COUNTS*)user;
+	assert(stringLength < sizeof(counts->lastString));
+	memcpy(counts->lastString, string, stringLength);
+	counts->lastString[stringLength] = '\0';
+	return true;
+}
+
+int main()
+{
+	const char* str = "{\"a\":[1,2,-3,{\"b\":null}],\"c\":true,\"d\":false,\"e\":18446744073709551615,\"f\":0.5,"
+		"\"g\\u0041\":\"x\\ty\",\"h\":[]}";
+
+	InitTESTAllocatorContext();
+	JSONLIB_SetAllocator(TESTAllocate, TESTDeallocate);
+
+	JSONLIB_Handler handler;
+	handler.startObject = CountStartObject;
+	handler.endObject = CountEndObject;
+	handler.startArray = CountStartArray;
+	handler.endArray = CountEndArray;
+	handler.key = CountKey;
+	handler.string = CountString;
+	handler.integer = CountInteger;
+	handler.unsignedInteger = CountUnsigned;
+	handler.decimal = CountDecimal;
+	handler.boolean = CountBoolean;
+	handler.null = CountNull;
+
+	COUNTS counts;
+	memset(&counts, 0, sizeof(counts));
+	counts.input = str;
+
+	assert(JSONLIB_ParseSAX(str, strlen(str), &handler, &counts));
+
+	assert(counts.objects == 2 && counts.arrays == 2);
+	assert(counts.members == 8 && counts.elements == 4);
+	assert(counts.keys == 8 && counts.borrowedKeys == 7);
+	assert(counts.sum == 0);
+	assert(counts.big == 18446744073709551615ULL);
+	assert(counts.decimal == 0.5);
+	assert(counts.trues == 1 && counts.nulls == 1);
+	assert(!strcmp(counts.lastString, "x\ty"));
+
+	// NOTE: @Jon
+	// A handler giving back false stops the parse
+	memset(&counts, 0, sizeof(counts));
+	counts.input = str;
+	counts.stopAfterKeys = 2;
+
+	assert(!JSONLIB_ParseSAX(str, strlen(str), &handler, &counts));
+	assert(counts.keys == 2);
+
+	// NOTE: @Jon
+	// Events can be skipped with NULL callbacks, malformed documents still fail
+	JSONLIB_Handler integersOnly;
+	memset(&integersOnly, 0, sizeof(integersOnly));
+	integersOnly.integer = CountInteger;
+
+	memset(&counts, 0, sizeof(counts));
+
+	assert(JSONLIB_ParseSAX("[40,[2]]", 8, &integersOnly, &counts));
+	assert(counts.sum == 42);
+	assert(!JSONLIB_ParseSAX("[40,[2]", 7, &integersOnly, &counts));
+	assert(!JSONLIB_ParseSAX("[40,2]x", 7, &integersOnly, &counts));
+
+	assert(allocations == 0);
+
+	return 0;
+}
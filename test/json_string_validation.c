@@ -0,0 +1,62 @@
+#include <include/jsonlib/json.h>
+
+#include <assert.h>
+#include <string.h>
+
+#include "json_test_allocator.h"
+
+static bool Parses(const char* str, const u32 flags)
+{
+	JSON* json = JSONLIB_ParseJSONEx(str, (u32)strlen(str), flags, NULL);
+
+	if (json == NULL)
+		return false;
+
+	JSONLIB_FreeJSON(json);
+	return true;
+}
+
+static void CheckBothWays(const char* str, const bool valid)
+{
+	assert(Parses(str, 0) == valid);
+	assert(Parses(str, JSON_PARSE_BORROW_STRINGS) == valid);
+	assert(Parses(str, JSON_PARSE_STRUCTURAL_INDEX) == valid);
+}
+
+int main()
+{
+	InitTESTAllocatorContext();
+	JSONLIB_SetAllocator(TESTAllocate, TESTDeallocate);
+
+	// NOTE: @Jon
+	// Long enough that the vector scan sees the bad byte part way through a block
+	CheckBothWays("[\"caf\xC3\xA9 \xE4\xB8\xAD\xE6\x96\x87 \xF0\x9F\x98\x80 the quick brown fox jumps over the lazy dog again and again\"]", true);
+	CheckBothWays("{\"\xE5\x90\x8D\xE5\x89\x8D\":\"value\"}", true);
+	CheckBothWays("[\"the quick brown fox jumps over the lazy dog again and again \x01 and again\"]", false);
+	CheckBothWays("[\"tab\tinside\"]", false);
+	CheckBothWays("{\"new\nline\":1}", false);
+	CheckBothWays("[\"the quick brown fox jumps over the lazy dog again and again \xC0\xAF\"]", false);
+	CheckBothWays("[\"surrogate \xED\xA0\x80\"]", false);
+	CheckBothWays("[\"too large \xF4\x90\x80\x80\"]", false);
+	CheckBothWays("[\"truncated \xE4\xB8\"]", false);
+	CheckBothWays("[\"stray \x80 continuation\"]", false);
+	CheckBothWays("[\"\xFF\"]", false);
+
+	const char* str = "{\"log\":\"GET /index.html 200 \\\"Mozilla/5.0\\\" took 12ms \xE2\x9C\x93 then GET /favicon.ico 404 \\\\ done\\n\"}";
+
+	JSON* json = JSONLIB_ParseJSON(str, (u32)strlen(str));
+
+	assert(json != NULL);
+	assert(!strcmp(json->values[0]->string, "GET /index.html 200 \"Mozilla/5.0\" took 12ms \xE2\x9C\x93 then GET /favicon.ico 404 \\ done\n"));
+
+	const char* jsonStr = JSONLIB_MakeJSON(json, false);
+
+	assert(!strcmp(str, jsonStr));
+
+	JSONLIB_ClearJSON((void*)jsonStr);
+	JSONLIB_FreeJSON(json);
+
+	assert(allocations == 0);
+
+	return 0;
+}
@@ -0,0 +1,83 @@
+#include <include/jsonlib/json.h>
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "json_test_allocator.h"
+
+static char* MakeDocument(const u32 count, u32* length)
+{
+	// NOTE: @Jon
+	// Escaped quotes and backslash runs slide across every 64 byte block boundary
+	char* str = malloc((size_t)count * 64 + 16);
+	u32 used = 0;
+
+	str[used++] = '[';
+
+	for (u32 i = 0; i < count; ++i)
+	{
+		if (i > 0)
+			str[used++] = ',';
+
+		used += (u32)sprintf(str + used, "{\"k%u\":\"a", i);
+
+		for (u32 j = 0; j < i % 5; ++j)
+			used += (u32)sprintf(str + used, "\\\\");
+
+		used += (u32)sprintf(str + used, "\\\"x\\\\\",\"n\":[%u,true,null]}", i);
+	}
+
+	str[used++] = ']';
+	str[used] = '\0';
+
+	*length = used;
+	return str;
+}
+
+static void RoundTrip(const u32 count, const u32 flags)
+{
+	u32 length = 0;
+	char* str = MakeDocument(count, &length);
+
+	JSON* json = JSONLIB_ParseJSONEx(str, length, flags, NULL);
+
+	assert(json != NULL);
+	assert(json->valueCount == count);
+
+	const char* jsonStr = JSONLIB_MakeJSON(json, false);
+
+	assert(!strcmp(str, jsonStr));
+
+	JSONLIB_ClearJSON((void*)jsonStr);
+	JSONLIB_FreeJSON(json);
+
+	free(str);
+}
+
+int main()
+{
+	InitTESTAllocatorContext();
+	JSONLIB_SetAllocator(TESTAllocate, TESTDeallocate);
+
+	RoundTrip(3, JSON_PARSE_STRUCTURAL_INDEX);
+	RoundTrip(3, JSON_PARSE_STRUCTURAL_INDEX | JSON_PARSE_BORROW_STRINGS);
+
+	// NOTE: @Jon
+	// Large enough for the index to grow past its first guess
+	RoundTrip(4096, JSON_PARSE_STRUCTURAL_INDEX);
+	RoundTrip(4096, 0);
+
+	const char* bad = "[\"open\\\"]";
+
+	assert(JSONLIB_ParseJSONEx(bad, (u32)strlen(bad), JSON_PARSE_STRUCTURAL_INDEX, NULL) == NULL);
+
+	bad = "{\"a\":1 \"b\":2}";
+
+	assert(JSONLIB_ParseJSONEx(bad, (u32)strlen(bad), JSON_PARSE_STRUCTURAL_INDEX, NULL) == NULL);
+
+	assert(allocations == 0);
+
+	return 0;
+}
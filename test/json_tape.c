@@ -0,0 +1,129 @@
+#include <include/jsonlib/json.h>
+
+#include <assert.h>
+#include <string.h>
+
+#include "json_test_allocator.h"
+
+// NOTE: @Jon
+// Walks a tape alongside the tree parsed from the same document
+void CheckCursor(JSONLIB_Cursor cursor, JSON* json)
+{
+	assert(JSONLIB_CursorGetTags(&cursor) == json->tags);
+
+	u32 nameLength = 0;
+	const char* name = JSONLIB_CursorGetName(&cursor, &nameLength);
+	if (json->name != NULL)
+	{
+		assert(name != NULL && nameLength == json->nameLength && !memcmp(name, json->name, nameLength));
+	}
+	else
+	{
+		assert(name == NULL);
+	}
+
+	i64 integer = 0;
+	u64 unsigned64 = 0;
+	f64 decimal = 0;
+	bool boolean = false;
+	if (json->tags & JSON_INTEGER64_TAG)
+	{
+		assert(JSONLIB_CursorGetInteger64(&cursor, &integer) && integer == json->integer64);
+	}
+	if (json->tags & JSON_UNSIGNED64_TAG)
+	{
+		assert(JSONLIB_CursorGetUnsigned64(&cursor, &unsigned64) && unsigned64 == json->unsigned64);
+	}
+	if (json->tags & JSON_DECIMAL64_TAG)
+	{
+		assert(JSONLIB_CursorGetDecimal64(&cursor, &decimal) && decimal == json->decimal64);
+	}
+	if (json->tags & JSON_BOOLEAN_TAG)
+	{
+		assert(JSONLIB_CursorGetBoolean(&cursor, &boolean) && boolean == json->boolean);
+	}
+	if (json->tags & JSON_STRING_TAG)
+	{
+		u32 stringLength = 0;
+		const char* string = JSONLIB_CursorGetString(&cursor, &stringLength);
+		assert(string != NULL && stringLength == json->stringLength && !memcmp(string, json->string, stringLength));
+	}
+
+	if (json->tags & (JSON_OBJECT_TAG | JSON_ARRAY_TAG))
+	{
+		assert(JSONLIB_CursorGetCount(&cursor) == json->valueCount);
+
+		JSONLIB_Cursor child = cursor;
+		bool more = JSONLIB_CursorChild(&child);
+		for (u32 i = 0; i < json->valueCount; ++i)
+		{
+			assert(more);
+			CheckCursor(child, json->values[i]);
+			more = JSONLIB_CursorNextSibling(&child);
+		}
+		assert(!more);
+	}
+	else
+	{
+		assert(!JSONLIB_CursorChild(&cursor));
+	}
+}
+
+int main()
+{
+	const char* str = "{\"name\":\"caf\\u00e9\",\"values\":[1,-2,18446744073709551615,0.5,true,false,null,\"\"],"
+		"\"empty\":{},\"nested\":{\"a\":[[],{\"b\":\"c\\n\"}]},\"big\":12345678901234}";
+
+	InitTESTAllocatorContext();
+	JSONLIB_SetAllocator(TESTAllocate, TESTDeallocate);
+
+	JSON* json = JSONLIB_ParseJSON(str, (u32)strlen(str));
+	JSONLIB_Tape* tape = JSONLIB_ParseTape(str, strlen(str), 0);
+
+	assert(json != NULL && tape != NULL);
+
+	JSONLIB_Cursor root = JSONLIB_GetTapeRoot(tape);
+	CheckCursor(root, json);
+
+	// NOTE: @Jon
+	// The root has no siblings, and keys are found without walking into the values before them
+	JSONLIB_Cursor cursor = root;
+
+	assert(!JSONLIB_CursorNextSibling(&cursor));
+	assert(JSONLIB_CursorFindKey(&cursor, "nested", 6));
+	assert(JSONLIB_CursorFindKey(&cursor, "a", 1));
+	assert(JSONLIB_CursorGetCount(&cursor) == 2);
+	assert(JSONLIB_CursorChild(&cursor) && JSONLIB_CursorNextSibling(&cursor));
+	assert(JSONLIB_CursorFindKey(&cursor, "b", 1));
+	assert(!strcmp(JSONLIB_CursorGetString(&cursor, NULL), "c\n"));
+
+	i64 integer = 0;
+	cursor = root;
+
+	assert(!JSONLIB_CursorFindKey(&cursor, "missing", 7));
+	assert(JSONLIB_CursorFindKey(&cursor, "big", 3));
+	assert(JSONLIB_CursorGetInteger64(&cursor, &integer) && integer == 12345678901234);
+	assert(JSONLIB_CursorGetString(&cursor, NULL) == NULL);
+	assert(!JSONLIB_CursorFindKey(&cursor, "big", 3));
+
+	JSONLIB_DestroyTape(tape);
+	JSONLIB_FreeJSON(json);
+
+	// NOTE: @Jon
+	// A scalar can be a whole document too
+	tape = JSONLIB_ParseTape(" 2.5 ", 5, JSON_PARSE_STRUCTURAL_INDEX);
+	root = JSONLIB_GetTapeRoot(tape);
+	f64 decimal = 0;
+
+	assert(JSONLIB_CursorGetDecimal64(&root, &decimal) && decimal == 2.5);
+	assert(!JSONLIB_CursorGetInteger64(&root, &integer));
+
+	JSONLIB_DestroyTape(tape);
+
+	assert(JSONLIB_ParseTape("[1,{\"a\":]", 10, 0) == NULL);
+	assert(JSONLIB_ParseTape("", 0, 0) == NULL);
+
+	assert(allocations == 0);
+
+	return 0;
+}
@@ -4,15 +4,18 @@
 #include <stdlib.h>
 
 u32 allocations;
+u32 totalAllocations;
 
 void InitTESTAllocatorContext()
 {
 	allocations = 0;
+	totalAllocations = 0;
 }
 
 void* TESTAllocate(size_t size)
 {
 	allocations++;
+	totalAllocations++;
 	return malloc(size);
 }
 
@@ -0,0 +1,131 @@
+#include <include/jsonlib/json.h>
+
+#include <assert.h>
+#include <string.h>
+
+#include "json_test_allocator.h"
+
+typedef struct SINK
+{
+	char data[4096];
+	u32 length;
+	u32 writes;
+} SINK;
+
+bool SinkWrite(void* context, const char* data, u32 length)
+{
+	SINK* sink = (SINK*)context;
+	assert(sink->length + length < sizeof(sink->data));
+	memcpy(&sink->data[sink->length], data, length);
+	sink->length += length;
+	sink->data[sink->length] = '\0';
+	sink->writes++;
+	return true;
+}
+
+bool FailingWrite(void* context, const char* data, u32 length)
+{
+	(void)context;
+	(void)data;
+	(void)length;
+	return false;
+}
+
+void WriteDocument(JSONLIB_Writer* writer, const char* longString)
+{
+	JSONLIB_BeginObject(writer);
+	JSONLIB_WriteKey(writer, "id", 2);
+	JSONLIB_WriteInteger(writer, -9223372036854775807LL - 1);
+	JSONLIB_WriteKey(writer, "values", 6);
+	JSONLIB_BeginArray(writer);
+	JSONLIB_WriteUnsigned(writer, 18446744073709551615ULL);
+	JSONLIB_WriteDouble(writer, 0.1);
+	JSONLIB_WriteBoolean(writer, true);
+	JSONLIB_WriteNull(writer);
+	JSONLIB_BeginArray(writer);
+	JSONLIB_EndArray(writer);
+	JSONLIB_EndArray(writer);
+	JSONLIB_WriteKey(writer, "long", 4);
+	JSONLIB_WriteString(writer, longString, (u32)strlen(longString));
+	JSONLIB_WriteKey(writer, "empty", 5);
+	JSONLIB_BeginObject(writer);
+	JSONLIB_EndObject(writer);
+	JSONLIB_EndObject(writer);
+}
+
+int main()
+{
+	// NOTE: @Jon
+	// Longer than the writer's buffer and full of escapes so it has to go out in pieces
+	char longString[301];
+	for (u32 i = 0; i < 300; ++i)
+		longString[i] = i % 3 == 0 ? '\n' : (i % 3 == 1 ? '"' : 'x');
+	longString[300] = '\0';
+
+	InitTESTAllocatorContext();
+	JSONLIB_SetAllocator(TESTAllocate, TESTDeallocate);
+
+	for (u32 pretty = 0; pretty < 2; ++pretty)
+	{
+		SINK sink;
+		sink.length = 0;
+		sink.writes = 0;
+
+		JSONLIB_Writer* writer = JSONLIB_CreateWriter(SinkWrite, &sink, 64, pretty ? JSON_MAKE_HUMAN_READABLE : 0);
+		WriteDocument(writer, longString);
+
+		assert(JSONLIB_DestroyWriter(writer));
+		assert(sink.writes > 1);
+
+		// NOTE: @Jon
+		// The streamed output reads back and matches what MakeJSON gives for the same tree
+		JSON* json = JSONLIB_ParseJSON(sink.data, sink.length);
+
+		assert(json != NULL);
+
+		const char* made = JSONLIB_MakeJSON(json, pretty != 0);
+
+		assert(!strcmp(made, sink.data));
+
+		// NOTE: @Jon
+		// Writing the parsed tree back through a writer gives the same output again
+		SINK copy;
+		copy.length = 0;
+		copy.writes = 0;
+
+		writer = JSONLIB_CreateWriter(SinkWrite, &copy, 0, pretty ? JSON_MAKE_HUMAN_READABLE : 0);
+		JSONLIB_WriteJSON(writer, json);
+
+		assert(JSONLIB_DestroyWriter(writer));
+		assert(!strcmp(copy.data, sink.data));
+
+		JSONLIB_ClearJSON(made);
+		JSONLIB_FreeJSON(json);
+	}
+
+	// NOTE: @Jon
+	// Top level values go on separate lines
+	SINK lines;
+	lines.length = 0;
+	lines.writes = 0;
+
+	JSONLIB_Writer* writer = JSONLIB_CreateWriter(SinkWrite, &lines, 0, 0);
+	JSONLIB_WriteInteger(writer, 1);
+	JSONLIB_BeginObject(writer);
+	JSONLIB_WriteKey(writer, "a", 1);
+	JSONLIB_WriteString(writer, "b", 1);
+	JSONLIB_EndObject(writer);
+
+	assert(JSONLIB_DestroyWriter(writer));
+	assert(!strcmp(lines.data, "1\n{\"a\":\"b\"}"));
+
+	writer = JSONLIB_CreateWriter(FailingWrite, NULL, 64, 0);
+	WriteDocument(writer, longString);
+
+	assert(!JSONLIB_FlushWriter(writer));
+	assert(!JSONLIB_DestroyWriter(writer));
+
+	assert(allocations == 0);
+
+	return 0;
+}